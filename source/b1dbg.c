@@ -71,9 +71,9 @@ B1_T_ERROR b1_dbg_get_var_dump(const B1_NAMED_VAR *var, B1_T_CHAR *sbuf, B1_T_IN
 	B1_VAR tmpvar;
 	B1_T_INDEX i;
 	uint8_t type, dimnum;
-	B1_T_SUBSCRIPT *arrdata;
+	B1_T_SUBSCRIPT *arrdata, bounds[B1_MAX_VAR_DIM_NUM * 2];
 	B1_T_MEMOFFSET ai, arrsize;
-	B1_T_MEM_BLOCK_DESC desc;
+	B1_T_MEM_BLOCK_DESC desc, datadesc;
 	void *data;
 
 	type = B1_TYPE_GET((*var).var.type);
@@ -106,6 +106,34 @@ B1_T_ERROR b1_dbg_get_var_dump(const B1_NAMED_VAR *var, B1_T_CHAR *sbuf, B1_T_IN
 	}
 
 	// copy variable value
+#ifdef B1_FEATURE_TYPE_MAP
+	if(B1_IDENT_TEST_FLAGS_VAR_MAP((*var).id.flags))
+	{
+		// map: number of keys
+		if(b1_dbg_copy_str(_DBG_DELIM, &sbuf, &buflen) || b1_dbg_copy_str(_MAP, &sbuf, &buflen) || b1_dbg_copy_str(_DBG_TYPE_CLBR, &sbuf, &buflen))
+		{
+			return B1_RES_OK;
+		}
+
+		err = b1_var_map_get_count(var, &ai);
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
+
+		tmpvar.type = B1_TYPE_SET(B1_TYPE_INT, 0);
+		tmpvar.value.i32val = (int32_t)ai;
+
+		err = b1_dbg_var_to_str(&tmpvar);
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
+
+		b1_dbg_copy_str(b1_tmp_buf, &sbuf, &buflen);
+	}
+	else
+#endif
 	if(dimnum == 0)
 	{
 		if(b1_dbg_copy_str(_DBG_TYPE_CLBR, &sbuf, &buflen))
@@ -152,6 +180,13 @@ B1_T_ERROR b1_dbg_get_var_dump(const B1_NAMED_VAR *var, B1_T_CHAR *sbuf, B1_T_IN
 			return err;
 		}
 
+		// copy subscript bounds and array data memory block descriptor
+		memcpy(bounds, arrdata, dimnum * (uint8_t)2 * (uint8_t)sizeof(B1_T_SUBSCRIPT));
+		datadesc = *((B1_T_MEM_BLOCK_DESC *)(arrdata + dimnum * (uint8_t)2));
+		b1_ex_mem_release(desc);
+		desc = datadesc;
+		arrdata = bounds;
+
 		// check array subscripts
 		arrsize = 1;
 		for(i = 0; i < dimnum; i++)
@@ -181,7 +216,6 @@ B1_T_ERROR b1_dbg_get_var_dump(const B1_NAMED_VAR *var, B1_T_CHAR *sbuf, B1_T_IN
 				return B1_RES_OK;
 			}
 		}
-		desc = *((B1_T_MEM_BLOCK_DESC *)arrdata);
 
 		if(b1_dbg_copy_str(_DBG_TYPE_CLBR, &sbuf, &buflen))
 		{
@@ -15,7 +15,7 @@
 
 // return codes
 #define B1_RES_FIRSTERRCODE ((B1_T_ERROR)100)
-#define B1_RES_LASTERRCODE ((B1_T_ERROR)146)
+#define B1_RES_LASTERRCODE ((B1_T_ERROR)148)
 // OK, no error
 #define B1_RES_OK ((B1_T_ERROR)0)
 // OK, execution reached END statement
@@ -116,5 +116,9 @@
 #define B1_RES_ENOTINLOOP ((B1_T_ERROR)145)
 // EMANYBRKPNT error: too many breakpoints
 #define B1_RES_EMANYBRKPNT ((B1_T_ERROR)146)
+// EFNWOEND error: FUNCTION without END FUNCTION
+#define B1_RES_EFNWOEND ((B1_T_ERROR)147)
+// EENDWOFN error: END FUNCTION without FUNCTION
+#define B1_RES_EENDWOFN ((B1_T_ERROR)148)
 
 #endif
\ No newline at end of file
@@ -627,6 +627,14 @@ static B1_T_ERROR b1_eval_mod(B1_VAR *pvar1, uint8_t optype)
 
 static B1_T_ERROR b1_eval_and(B1_VAR *pvar1, uint8_t optype)
 {
+#ifdef B1_FEATURE_MINIMAL_EVALUATION_AND_OR
+	if(optype == B1_TYPE_BOOL)
+	{
+		// logical AND
+		(*pvar1).value.bval = (*pvar1).value.bval && (*(pvar1 + 1)).value.bval;
+	}
+	else
+#endif
 #ifdef B1_FEATURE_TYPE_SINGLE
 	if(optype == B1_TYPE_SINGLE)
 	{
@@ -672,6 +680,14 @@ static B1_T_ERROR b1_eval_and(B1_VAR *pvar1, uint8_t optype)
 
 static B1_T_ERROR b1_eval_or(B1_VAR *pvar1, uint8_t optype)
 {
+#ifdef B1_FEATURE_MINIMAL_EVALUATION_AND_OR
+	if(optype == B1_TYPE_BOOL)
+	{
+		// logical OR
+		(*pvar1).value.bval = (*pvar1).value.bval || (*(pvar1 + 1)).value.bval;
+	}
+	else
+#endif
 #ifdef B1_FEATURE_TYPE_SINGLE
 	if(optype == B1_TYPE_SINGLE)
 	{
@@ -1176,6 +1192,15 @@ B1_T_ERROR b1_eval_cmp(B1_VAR *pvar1, B1_T_CHAR c, B1_T_CHAR c1, uint8_t optype)
 
 static B1_T_ERROR b1_eval_un_op(B1_T_CHAR c, B1_VAR *arg, uint8_t optype)
 {
+#ifdef B1_FEATURE_MINIMAL_EVALUATION_AND_OR
+	if(optype == B1_TYPE_BOOL && c == B1_T_C_EXCLAMATION)
+	{
+		// logical NOT
+		(*arg).value.bval = !(*arg).value.bval;
+		return B1_RES_OK;
+	}
+#endif
+
 	if(B1_TYPE_TEST_NUMERIC(optype))
 	{
 		if(B1_T_ISMINUS(c))
@@ -1275,6 +1300,14 @@ static uint8_t b1_eval_get_common_type(uint8_t type1, uint8_t type2)
 	B1_T_INDEX i;
 	uint8_t type;
 
+#ifdef B1_FEATURE_MINIMAL_EVALUATION_AND_OR
+	// boolean operands of logical operators
+	if(type1 == B1_TYPE_BOOL && type2 == B1_TYPE_BOOL)
+	{
+		return B1_TYPE_BOOL;
+	}
+#endif
+
 	// start finding common type from the highest priority type
 	for(i = 0; i < B1_TYPE_COUNT; i++)
 	{
@@ -1288,7 +1321,11 @@ static uint8_t b1_eval_get_common_type(uint8_t type1, uint8_t type2)
 	return 0;
 }
 
+#ifdef B1_FEATURE_FUNCTIONS_USER
+static B1_T_ERROR b1_eval_rpn(uint8_t options, B1_VAR_REF *var_ref)
+#else
 B1_T_ERROR b1_eval(uint8_t options, B1_VAR_REF *var_ref)
+#endif
 {
 	B1_T_ERROR err;
 	uint8_t tflags, type, argnum, arg, var_type;
@@ -1301,15 +1338,29 @@ B1_T_ERROR b1_eval(uint8_t options, B1_VAR_REF *var_ref)
 	B1_FN *fn;
 #ifdef B1_FEATURE_FUNCTIONS_USER
 	B1_T_INDEX rpn_stack_ptr, rpn_end, argsbase;
+	B1_UDEF_CALL call;
+	const B1_T_CHAR *progline;
+#endif
+#ifdef B1_FEATURE_FUNCTIONS_USER_INLINE
+	B1_T_INDEX inl_argsbase;
+	const B1_T_CHAR *inl_progline;
 #endif
 #ifdef B1_FEATURE_DEBUG
 	B1_T_INDEX id_off, id_len;
 #endif
+#ifdef B1_FEATURE_VAR_SLOTS
+	uint8_t slot;
+#endif
 
 #ifdef B1_FEATURE_FUNCTIONS_USER
 	rpn_stack_ptr = 0;
 	rpn_end = 0;
 	argsbase = 0;
+	progline = b1_progline;
+#endif
+#ifdef B1_FEATURE_FUNCTIONS_USER_INLINE
+	inl_argsbase = 0;
+	inl_progline = b1_progline;
 #endif
 
 	if(var_ref)
@@ -1338,6 +1389,41 @@ B1_T_ERROR b1_eval(uint8_t options, B1_VAR_REF *var_ref)
 #ifdef B1_FEATURE_MINIMAL_EVALUATION
 		if(B1_RPNREC_TEST_SPEC_ARG(tflags))
 		{
+#ifdef B1_FEATURE_MINIMAL_EVALUATION_AND_OR
+			if(tflags == B1_RPNREC_TYPE_SPEC_LOGIC)
+			{
+				// left operand of logical AND (OR) operator is false (true): skip the right operand, its copy
+				// is used instead so the operator result does not change
+				arg = (*(b1_rpn + i)).data.nestlevel;
+				if(B1_TYPE_TEST_BOOL((*(var1 - 1)).type) &&
+					((arg & B1_RPNREC_LOGIC_ID_OR) ? (*(var1 - 1)).value.bval : !(*(var1 - 1)).value.bval))
+				{
+					if(B1_MAX_RPN_EVAL_BUFFER_LEN == tmptop)
+					{
+						return B1_RES_ETMPSTKOVF;
+					}
+
+					*var1 = *(var1 - 1);
+					tmptop++;
+
+					// go to the operator (it can be the last record of user function RPN)
+					while(1)
+					{
+						i++;
+						if(B1_RPNREC_GET_TYPE((*(b1_rpn + i)).flags) == B1_RPNREC_TYPE_OPER && arg == (*(b1_rpn + i)).data.oper.id)
+						{
+							break;
+						}
+					}
+
+					continue;
+				}
+
+				i++;
+				continue;
+			}
+#endif
+
 			if(	(tflags == B1_RPNREC_TYPE_SPEC_ARG_1 && !(*(var1 - 1)).value.bval) ||
 				(tflags == B1_RPNREC_TYPE_SPEC_ARG_2)
 				)
@@ -1362,6 +1448,41 @@ B1_T_ERROR b1_eval(uint8_t options, B1_VAR_REF *var_ref)
 		}
 #endif
 
+#ifdef B1_FEATURE_FUNCTIONS_USER_INLINE
+		if(tflags == B1_RPNREC_FN_ARG_INLINE_END)
+		{
+			// end of inlined user function body: the result is on the top of temp. stack
+			var1--;
+			tmptop--;
+
+			// free string arguments
+			while(tmptop != argsbase)
+			{
+				tmptop--;
+				if((*(b1_rpn_eval + tmptop)).type == B1_TYPE_SET(B1_TYPE_STRING, 0))
+				{
+					b1_ex_mem_free((*(b1_rpn_eval + tmptop)).value.mem_desc);
+				}
+			}
+
+			argsbase = inl_argsbase;
+			b1_progline = inl_progline;
+
+			err = b1_var_convert(var1, (*(b1_rpn + i)).data.id.flags);
+			if(err != B1_RES_OK)
+			{
+				return err;
+			}
+
+			// move user function result
+			*(b1_rpn_eval + tmptop) = *var1;
+
+			tmptop++;
+			i++;
+			continue;
+		}
+#endif
+
 		if(B1_RPNREC_TEST_TYPES(tflags, B1_RPNREC_TYPE_FNVAR | B1_RPNREC_TYPE_FN_ARG))
 		{
 			var_type = (*(b1_rpn + i)).data.id.flags;
@@ -1474,60 +1595,106 @@ B1_T_ERROR b1_eval(uint8_t options, B1_VAR_REF *var_ref)
 				{	
 					// tflags = 1 stands for function and tflags = 2 - variable
 					tflags = 1;
-					// test if the identifier is a function
-#ifdef B1_FEATURE_FUNCTIONS_USER
-					err = b1_fn_get_params(name_hash, 0, &fn);
-#else
-					err = b1_fn_get_params(name_hash, &fn);
+#ifdef B1_FEATURE_VAR_SLOTS
+					slot = (*(b1_rpn + i)).data.id.slot;
+					var = (slot == B1_VAR_SLOT_NONE) ? NULL : b1_var_slots[slot];
+					if(var != NULL)
+					{
+						// the variable is bound to slot: no function lookup and variable creation
+						err = (B1_IDENT_GET_FLAGS_ARGNUM((*var).id.flags) == argnum) ? B1_RES_OK : B1_RES_EWSUBSCNT;
+						tflags++;
+					}
+					else
 #endif
-					if(err == B1_RES_EUNKIDENT)
 					{
-						// not a function: variable subscripts are numerics (B1_TYPE_INT)
-						// get/create variable (var_type here stands for variable type)
-						err = b1_var_create(name_hash, var_type, argnum, NULL, &var);
-						if(err == B1_RES_OK)
+						// test if the identifier is a function
+#ifdef B1_FEATURE_BLTIN_FN_BINDING
+						arg = (*(b1_rpn + i)).data.id.fn_index;
+						if(arg != B1_FN_BLTIN_NONE)
 						{
-#ifdef B1_FEATURE_DEBUG
-							memcpy((*var).id.name + 1, b1_progline + id_off, id_len * B1_T_CHAR_SIZE);
-							(*var).id.name[0] = (B1_T_CHAR)id_len;
+							// built-in function was bound when RPN was built: no lookup by hash
+							fn = b1_fn_bltin_get(arg);
+							err = B1_RES_OK;
+						}
+						else
+#endif
+#ifdef B1_FEATURE_FUNCTIONS_USER
+						err = b1_fn_get_params(name_hash, 0, &fn);
+#else
+						err = b1_fn_get_params(name_hash, &fn);
 #endif
-							// the variable was created
-							if(b1_opt_explicit_val)
+						if(err == B1_RES_EUNKIDENT)
+						{
+							// not a function: variable subscripts are numerics (B1_TYPE_INT)
+							// get/create variable (var_type here stands for variable type)
+							err = b1_var_create(name_hash, var_type, argnum, NULL, &var);
+							if(err == B1_RES_OK)
 							{
 #ifdef B1_FEATURE_DEBUG
-								// delete variable in case of debugging because the function
-								// can be used for debug purpose so the error does not mean
-								// the interpreter termination
-								b1_int_var_mem_free(var);
-								b1_ex_var_free(name_hash);
+								memcpy((*var).id.name + 1, b1_progline + id_off, id_len * B1_T_CHAR_SIZE);
+								(*var).id.name[0] = (B1_T_CHAR)id_len;
 #endif
-								return B1_RES_EUNKIDENT;
+								// the variable was created
+								if(b1_opt_explicit_val)
+								{
+#ifdef B1_FEATURE_DEBUG
+									// delete variable in case of debugging because the function
+									// can be used for debug purpose so the error does not mean
+									// the interpreter termination
+									b1_int_var_mem_free(var);
+									b1_ex_var_free(name_hash);
+#endif
+									return B1_RES_EUNKIDENT;
+								}
 							}
+							else
+							if(err == B1_RES_EIDINUSE)
+							{
+								err = B1_RES_OK;
+							}
+#ifdef B1_FEATURE_VAR_SLOTS
+							if(err == B1_RES_OK && slot != B1_VAR_SLOT_NONE)
+							{
+								b1_var_slots[slot] = var;
+							}
+#endif
+
+							tflags++;
 						}
 						else
-						if(err == B1_RES_EIDINUSE)
 						{
-							err = B1_RES_OK;
-						}
-
-						tflags++;
-					}
-					else
-					{
-						// extract function argument types
-						if(err == B1_RES_OK)
-						{
-							if(B1_IDENT_GET_FLAGS_ARGNUM((*fn).id.flags) != argnum)
+							// extract function argument types
+							if(err == B1_RES_OK)
 							{
-								err = B1_RES_EWRARGCNT;
+								if(B1_IDENT_GET_FLAGS_ARGNUM((*fn).id.flags) != argnum)
+								{
+									err = B1_RES_EWRARGCNT;
+								}
 							}
 						}
 					}
 
+#ifdef B1_FEATURE_FUNCTIONS_ARRAY
+					if(err == B1_RES_EWSUBSCNT && argnum == 0 && tflags == 2)
+					{
+						// array name without subscripts: tflags = 5 stands for whole array reference
+						err = B1_RES_OK;
+						tflags = 5;
+					}
+#endif
+
 					if(err != B1_RES_OK)
 					{
 						return err;
 					}
+
+#ifdef B1_FEATURE_TYPE_MAP
+					if(tflags == 2 && B1_IDENT_TEST_FLAGS_VAR_MAP((*var).id.flags))
+					{
+						// map key is not converted to numeric subscript (b1_var_get function converts it to string)
+						type = B1_TYPE_SET(B1_TYPE_ANY, 0);
+					}
+#endif
 				}
 			}
 
@@ -1555,10 +1722,22 @@ B1_T_ERROR b1_eval(uint8_t options, B1_VAR_REF *var_ref)
 						type = (*fn).argtypes[arg];
 					}
 
-					err = b1_var_convert(var1, type);
-					if(err != B1_RES_OK)
+#ifdef B1_FEATURE_FUNCTIONS_ARRAY
+					// whole array can be passed to array functions only
+					if(B1_TYPE_GET((*var1).type) == B1_TYPE_ARRAY_REF && B1_TYPE_GET(type) != B1_TYPE_ARRAY_REF)
 					{
-						return err;
+						return B1_RES_EWSUBSCNT;
+					}
+#endif
+
+					// skip the call if the argument is of the required type already
+					if(B1_TYPE_GET((*var1).type) != B1_TYPE_GET(type))
+					{
+						err = b1_var_convert(var1, type);
+						if(err != B1_RES_OK)
+						{
+							return err;
+						}
 					}
 				}
 #ifdef B1_FEATURE_FUNCTIONS_USER
@@ -1609,6 +1788,43 @@ B1_T_ERROR b1_eval(uint8_t options, B1_VAR_REF *var_ref)
 #ifdef B1_FEATURE_FUNCTIONS_USER
 				}
 				else
+#ifdef B1_FEATURE_FUNCTIONS_USER_INLINE
+				if(B1_RPNREC_TEST_FNVAR_INLINE((*(b1_rpn + i)).flags))
+				{
+					// inlined function body follows the call record, its constants and identifier names are
+					// read from b1_fn_udef_fn_text buffer
+					inl_argsbase = argsbase;
+					inl_progline = b1_progline;
+
+					argsbase = tmptop;
+					tmptop += argnum;
+
+					b1_progline = b1_fn_udef_fn_text;
+
+					i++;
+					continue;
+				}
+				else
+#endif
+#ifdef B1_FEATURE_FUNCTIONS_USER_MEMO
+				if(((*((B1_UDEF_FN *)fn)).memo & B1_UDEF_FN_MEMO) && b1_fn_udef_memo_get((*fn).id.name_hash, var1, argnum, var1))
+				{
+					// cached result of pure function (replaces the first argument)
+				}
+				else
+#endif
+#ifdef B1_FEATURE_STMT_FUNCTION
+				if((*((B1_UDEF_FN *)fn)).rpn_len == 0)
+				{
+					// FUNCTION ... END FUNCTION procedure (the result replaces the first argument)
+					err = b1_int_fn_call((B1_UDEF_FN *)fn, tmptop);
+					if(err != B1_RES_OK)
+					{
+						return err;
+					}
+				}
+				else
+#endif
 				{
 					// user defined function
 					if(rpn_stack_ptr == B1_MAX_UDEF_CALL_NEST_DEPTH)
@@ -1616,18 +1832,25 @@ B1_T_ERROR b1_eval(uint8_t options, B1_VAR_REF *var_ref)
 						return B1_RES_EUDEFOVF;
 					}
 
-					// save current program line
-					b1_fn_udef_call_stack[rpn_stack_ptr].prev_line_cnt = b1_curr_prog_line_cnt;
-
 					// save current RPN pointer (rpn and i)
-					b1_fn_udef_call_stack[rpn_stack_ptr].prev_rpn = b1_rpn;
-					b1_fn_udef_call_stack[rpn_stack_ptr].prev_rpn_end = rpn_end;
-					b1_fn_udef_call_stack[rpn_stack_ptr].prev_rpn_index = i;
+					call.prev_rpn = b1_rpn;
+					call.prev_rpn_end = rpn_end;
+					call.prev_rpn_index = i;
 
-					b1_fn_udef_call_stack[rpn_stack_ptr].prev_argsbase = argsbase;
+					call.prev_argsbase = argsbase;
 
-					b1_fn_udef_call_stack[rpn_stack_ptr].curr_arg_num = argnum;
-					b1_fn_udef_call_stack[rpn_stack_ptr].curr_ret_type = (*((B1_UDEF_FN *)fn)).fn.ret_type;
+					call.curr_arg_num = argnum;
+					call.curr_ret_type = (*((B1_UDEF_FN *)fn)).fn.ret_type;
+#ifdef B1_FEATURE_FUNCTIONS_USER_MEMO
+					call.curr_memo = (*((B1_UDEF_FN *)fn)).memo & B1_UDEF_FN_MEMO;
+					call.curr_name_hash = (*fn).id.name_hash;
+#endif
+
+					err = b1_fn_stack_push(&b1_fn_udef_call_stack, &call, sizeof(B1_UDEF_CALL));
+					if(err != B1_RES_OK)
+					{
+						return err;
+					}
 
 					b1_rpn = b1_fn_udef_fn_rpn + (*((B1_UDEF_FN *)fn)).rpn_start_pos;
 					rpn_end = (*((B1_UDEF_FN *)fn)).rpn_len;
@@ -1637,13 +1860,8 @@ B1_T_ERROR b1_eval(uint8_t options, B1_VAR_REF *var_ref)
 
 					tmptop += argnum;
 
-					// switch to DEF program line
-					b1_curr_prog_line_cnt = (*((B1_UDEF_FN *)fn)).def_line_cnt - 1;
-					err = b1_ex_prg_get_prog_line(B1_T_LINE_NUM_NEXT);
-					if(err != B1_RES_OK)
-					{
-						return err;
-					}
+					// function constants are read from the buffer, no program line switching needed
+					b1_progline = b1_fn_udef_fn_text;
 
 					rpn_stack_ptr++;
 
@@ -1677,6 +1895,29 @@ B1_T_ERROR b1_eval(uint8_t options, B1_VAR_REF *var_ref)
 				// PRINT function
 				(*var1).type = var_type;
 			}
+#ifdef B1_FEATURE_FUNCTIONS_ARRAY
+			else
+			if(tflags == 5)
+			{
+				// whole array reference
+				if(B1_MAX_RPN_EVAL_BUFFER_LEN == tmptop)
+				{
+					return B1_RES_ETMPSTKOVF;
+				}
+
+#ifdef B1_FEATURE_FUNCTIONS_USER
+				if(rpn_stack_ptr == 0 && !b1_rpn[i + 1].flags && var_ref != NULL)
+#else
+				if(!b1_rpn[i + 1].flags && var_ref != NULL)
+#endif
+				{
+					return B1_RES_EWSUBSCNT;
+				}
+
+				(*var1).type = B1_TYPE_SET(B1_TYPE_ARRAY_REF, 0);
+				(*var1).value.id_hash = name_hash;
+			}
+#endif
 #ifdef B1_FEATURE_FUNCTIONS_USER
 			else
 			{
@@ -1696,16 +1937,20 @@ B1_T_ERROR b1_eval(uint8_t options, B1_VAR_REF *var_ref)
 		{
 			rpn_stack_ptr--;
 
-			b1_curr_prog_line_cnt = b1_fn_udef_call_stack[rpn_stack_ptr].prev_line_cnt - 1;
+			err = b1_fn_stack_pop(&b1_fn_udef_call_stack, &call, sizeof(B1_UDEF_CALL));
+			if(err != B1_RES_OK)
+			{
+				return err;
+			}
 
-			b1_rpn = b1_fn_udef_call_stack[rpn_stack_ptr].prev_rpn;
-			rpn_end = b1_fn_udef_call_stack[rpn_stack_ptr].prev_rpn_end;
-			i = b1_fn_udef_call_stack[rpn_stack_ptr].prev_rpn_index;
+			b1_rpn = call.prev_rpn;
+			rpn_end = call.prev_rpn_end;
+			i = call.prev_rpn_index;
 
-			argsbase = b1_fn_udef_call_stack[rpn_stack_ptr].prev_argsbase;
+			argsbase = call.prev_argsbase;
 
-			argnum = b1_fn_udef_call_stack[rpn_stack_ptr].curr_arg_num;
-			type = b1_fn_udef_call_stack[rpn_stack_ptr].curr_ret_type;
+			argnum = call.curr_arg_num;
+			type = call.curr_ret_type;
 
 			// free string arguments
 			for(; argnum != 0; argnum--)
@@ -1717,11 +1962,10 @@ B1_T_ERROR b1_eval(uint8_t options, B1_VAR_REF *var_ref)
 				}
 			}
 
-			// restore previous program line
-			err = b1_ex_prg_get_prog_line(B1_T_LINE_NUM_NEXT);
-			if(err != B1_RES_OK)
+			if(rpn_stack_ptr == 0)
 			{
-				return err;
+				// restore program line pointer
+				b1_progline = progline;
 			}
 
 			err = b1_var_convert(var1, type);
@@ -1730,6 +1974,14 @@ B1_T_ERROR b1_eval(uint8_t options, B1_VAR_REF *var_ref)
 				return err;
 			}
 
+#ifdef B1_FEATURE_FUNCTIONS_USER_MEMO
+			if(call.curr_memo)
+			{
+				// the arguments are still in temp. stack
+				b1_fn_udef_memo_put(call.curr_name_hash, b1_rpn_eval + tmptop, call.curr_arg_num, var1);
+			}
+#endif
+
 			// move user function result
 			*(b1_rpn_eval + tmptop) = *var1;
 		}
@@ -1746,3 +1998,26 @@ B1_T_ERROR b1_eval(uint8_t options, B1_VAR_REF *var_ref)
 
 	return (tmptop == 1) ? B1_RES_OK : B1_RES_EWRARGCNT;
 }
+
+#ifdef B1_FEATURE_FUNCTIONS_USER
+// user defined functions are evaluated with b1_progline pointing to b1_fn_udef_fn_text buffer, the function
+// restores program line pointer and call stack if evaluation fails
+B1_T_ERROR b1_eval(uint8_t options, B1_VAR_REF *var_ref)
+{
+	B1_T_ERROR err;
+	const B1_T_CHAR *progline;
+	B1_T_MEMOFFSET top;
+
+	progline = b1_progline;
+	top = b1_fn_udef_call_stack.top;
+
+	err = b1_eval_rpn(options, var_ref);
+	if(err != B1_RES_OK)
+	{
+		b1_progline = progline;
+		b1_fn_udef_call_stack.top = top;
+	}
+
+	return err;
+}
+#endif
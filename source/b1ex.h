@@ -19,12 +19,25 @@
 #define B1_EX_MEM_READ ((uint8_t)0x1)
 #define B1_EX_MEM_WRITE ((uint8_t)0x2)
 
+#ifdef B1_FEATURE_STMT_FILE
+// file open modes
+#define B1_EX_FILE_INPUT ((uint8_t)0x1)
+#define B1_EX_FILE_OUTPUT ((uint8_t)0x2)
+#define B1_EX_FILE_APPEND ((uint8_t)0x3)
+#endif
+
 
 extern B1_T_ERROR b1_ex_mem_init();
 extern B1_T_ERROR b1_ex_mem_alloc(B1_T_MEMOFFSET size, B1_T_MEM_BLOCK_DESC *mem_desc, void **data);
 extern B1_T_ERROR b1_ex_mem_access(const B1_T_MEM_BLOCK_DESC mem_desc, B1_T_MEMOFFSET offset, B1_T_INDEX size, uint8_t options, void **data);
 extern B1_T_ERROR b1_ex_mem_release(const B1_T_MEM_BLOCK_DESC mem_desc);
 extern B1_T_ERROR b1_ex_mem_free(const B1_T_MEM_BLOCK_DESC mem_desc);
+#ifdef B1_FEATURE_MEM_ZEROED_ALLOC
+extern B1_T_ERROR b1_ex_mem_alloc_zeroed(B1_T_MEMOFFSET size, B1_T_MEM_BLOCK_DESC *mem_desc);
+#endif
+#ifdef B1_FEATURE_MEM_FREE_ALL
+extern B1_T_ERROR b1_ex_mem_free_all();
+#endif
 
 extern B1_T_ERROR b1_ex_var_init();
 extern B1_T_ERROR b1_ex_var_alloc(B1_T_IDHASH name_hash, B1_NAMED_VAR **var);
@@ -51,8 +64,34 @@ extern B1_T_ERROR b1_ex_io_print_char(B1_T_CHAR c);
 extern B1_T_ERROR b1_ex_io_print_newline();
 // prints display margin new line sequence
 extern B1_T_ERROR b1_ex_io_print_margin_newline();
+#ifdef B1_FEATURE_IO_PRINT_STR
+// prints slen characters (or slen spaces if sdata is NULL), the string never crosses print margin
+extern B1_T_ERROR b1_ex_io_print_str(const B1_T_CHAR *sdata, B1_T_INDEX slen);
+// writes buffered output (if any), called when b1_int_run function returns
+extern B1_T_ERROR b1_ex_io_print_flush();
+#endif
 // copies next input value into the specified buffer
 extern B1_T_ERROR b1_ex_io_input_char(B1_T_CHAR *c);
+#ifdef B1_FEATURE_IO_INPUT_LINE
+// reads the next input line (up to buflen characters, without new line character) into sbuf and its length into *len
+extern B1_T_ERROR b1_ex_io_input_line(B1_T_CHAR *sbuf, B1_T_INDEX buflen, B1_T_INDEX *len);
+#endif
+
+#ifdef B1_FEATURE_STMT_FILE
+// opens the file (name is a string with length prefix) in B1_EX_FILE_INPUT, B1_EX_FILE_OUTPUT or B1_EX_FILE_APPEND mode
+// and associates it with the channel (1 <= chan <= B1_MAX_FILE_CHAN_NUM), should return B1_RES_EINVARG if the channel is busy
+extern B1_T_ERROR b1_ex_file_open(uint8_t chan, const B1_T_CHAR *name, uint8_t mode);
+// writes buffered data and closes the file associated with the channel (chan = 0 closes all files), closing a channel
+// that is not open is not an error
+extern B1_T_ERROR b1_ex_file_close(uint8_t chan);
+// writes slen characters (or slen spaces if sdata is NULL) to the file opened for output, new line is written as B1_T_C_LF character
+extern B1_T_ERROR b1_ex_file_write(uint8_t chan, const B1_T_CHAR *sdata, B1_T_INDEX slen);
+// reads the next line of the file opened for input (up to buflen characters, without new line sequence) into sbuf and its
+// length into *len, returns B1_RES_EEOF if there is no data left
+extern B1_T_ERROR b1_ex_file_read_line(uint8_t chan, B1_T_CHAR *sbuf, B1_T_INDEX buflen, B1_T_INDEX *len);
+// sets *eof to non-zero value if there is no data left to read from the file
+extern B1_T_ERROR b1_ex_file_eof(uint8_t chan, uint8_t *eof);
+#endif
 
 // caches line numbers (allowing faster program navigation), the cached data can be used by b1_ex_prg_get_prog_line ant other functions
 extern B1_T_ERROR b1_ex_prg_cache_curr_line_num(B1_T_LINE_NUM curr_line_num, uint8_t stmt);
@@ -81,6 +120,10 @@ extern B1_T_ERROR b1_ex_prg_rpn_get_cached(B1_T_INDEX offset, B1_T_INDEX *contin
 #ifdef B1_FEATURE_FUNCTIONS_MATH_BASIC
 #ifdef B1_FRACTIONAL_TYPE_EXISTS
 extern void b1_ex_rnd_randomize(uint8_t init);
+#ifdef B1_FEATURE_RANDOMIZE_SEED
+// sets random generator state from the value (RANDOMIZE <num_expr> statement), equal values must produce equal sequences
+extern void b1_ex_rnd_seed(uint32_t seed);
+#endif
 extern B1_T_RAND_SEED b1_ex_rnd_get_next_seed();
 #endif
 #endif
@@ -9,6 +9,7 @@
 
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
 
 #include "b1ex.h"
@@ -19,13 +20,45 @@
 #include "b1err.h"
 
 
+#ifdef B1_FEATURE_FUNCTIONS_ARRAY
+#define B1_FN_ARR_OP_SUM ((uint8_t)0x0)
+#define B1_FN_ARR_OP_MIN ((uint8_t)0x1)
+#define B1_FN_ARR_OP_MAX ((uint8_t)0x2)
+#define B1_FN_ARR_OP_DOT ((uint8_t)0x3)
+
+// array functions process elements by chunks of the size
+#define B1_FN_ARR_BUF_LEN ((B1_T_MEMOFFSET)32)
+#endif
+
+#ifdef B1_FEATURE_FUNCTIONS_USER
+// initial size of user defined function call stack memory block
+#define B1_FN_STACK_INIT_SIZE ((B1_T_MEMOFFSET)64)
+// stack records are moved to a new memory block by chunks of the size
+#define B1_FN_STACK_BUF_LEN ((B1_T_MEMOFFSET)32)
+#endif
+
+
 // global data
 // user defined functions RPN store
 #ifdef B1_FEATURE_FUNCTIONS_USER
 B1_T_INDEX b1_fn_udef_fn_rpn_off = 0;
 B1_RPNREC b1_fn_udef_fn_rpn[B1_MAX_UDEF_FN_RPN_LEN];
+B1_T_INDEX b1_fn_udef_fn_text_off = 0;
+B1_T_CHAR b1_fn_udef_fn_text[B1_MAX_UDEF_FN_TEXT_LEN];
 // user defined function call stack
-B1_UDEF_CALL b1_fn_udef_call_stack[B1_MAX_UDEF_CALL_NEST_DEPTH];
+B1_FN_STACK b1_fn_udef_call_stack;
+#endif
+
+#ifdef B1_FEATURE_FUNCTIONS_USER_MEMO
+// pure user defined functions results cache
+static B1_UDEF_MEMO_REC b1_fn_udef_memo[B1_MAX_UDEF_MEMO_NUM];
+uint32_t b1_fn_udef_memo_hits;
+uint32_t b1_fn_udef_memo_misses;
+#endif
+
+#ifdef B1_FEATURE_FUNCTIONS_ARRAY
+// array function element buffers
+static B1_T_ARRAY_VAL b1_fn_arr_buf[2][B1_FN_ARR_BUF_LEN];
 #endif
 
 
@@ -72,9 +105,29 @@ static B1_T_ERROR b1_fn_bltin_ucase(B1_VAR *parg1);
 static B1_T_ERROR b1_fn_bltin_lcase(B1_VAR *parg1);
 #endif
 
+#ifdef B1_FEATURE_FUNCTIONS_ARRAY
+static B1_T_ERROR b1_fn_bltin_sum(B1_VAR *parg1);
+static B1_T_ERROR b1_fn_bltin_min(B1_VAR *parg1);
+static B1_T_ERROR b1_fn_bltin_max(B1_VAR *parg1);
+static B1_T_ERROR b1_fn_bltin_mean(B1_VAR *parg1);
+static B1_T_ERROR b1_fn_bltin_dot(B1_VAR *parg1);
+#ifdef B1_FEATURE_STMT_SORT
+static B1_T_ERROR b1_fn_bltin_search(B1_VAR *parg1);
+#endif
+#ifdef B1_FEATURE_TYPE_MAP
+static B1_T_ERROR b1_fn_bltin_exists(B1_VAR *parg1);
+static B1_T_ERROR b1_fn_bltin_count(B1_VAR *parg1);
+static B1_T_ERROR b1_fn_bltin_key(B1_VAR *parg1);
+#endif
+#endif
+
+#ifdef B1_FEATURE_STMT_FILE
+static B1_T_ERROR b1_fn_bltin_eof(B1_VAR *parg1);
+#endif
+
 
 // array of built-in functions definitions, sorted by name hash value (to use binary search)
-#if defined(B1_FEATURE_FUNCTIONS_STANDARD) || defined(B1_FEATURE_FUNCTIONS_MATH_BASIC) || defined(B1_FEATURE_FUNCTIONS_MATH_EXTRA) || defined(B1_FEATURE_FUNCTIONS_STRING)
+#if defined(B1_FEATURE_FUNCTIONS_STANDARD) || defined(B1_FEATURE_FUNCTIONS_MATH_BASIC) || defined(B1_FEATURE_FUNCTIONS_MATH_EXTRA) || defined(B1_FEATURE_FUNCTIONS_STRING) || defined(B1_FEATURE_FUNCTIONS_ARRAY)
 #ifdef B1_FEATURE_HASH_32BIT
 static const B1_BLTIN_FN b1_fn_bltin[B1_FN_BLTIN_COUNT] =
 {
@@ -93,6 +146,12 @@ static const B1_BLTIN_FN b1_fn_bltin[B1_FN_BLTIN_COUNT] =
 #ifdef B1_FEATURE_FUNCTIONS_MATH_EXTRA
 	{{{0x78af4, B1_IDENT_FLAGS_SET_FN(1, 1)}, {B1_TYPE_FP_HIGH_PREC}, B1_TYPE_FP_HIGH_PREC}, b1_fn_bltin_cos},
 #endif
+#ifdef B1_FEATURE_FUNCTIONS_ARRAY
+	{{{0x7904e, B1_IDENT_FLAGS_SET_FN(2, 1)}, {B1_TYPE_ARRAY_REF, B1_TYPE_ARRAY_REF}, B1_TYPE_FP_HIGH_PREC}, b1_fn_bltin_dot},
+#endif
+#ifdef B1_FEATURE_STMT_FILE
+	{{{0x79599, B1_IDENT_FLAGS_SET_FN(1, 1)}, {B1_TYPE_INT}, B1_TYPE_BOOL}, b1_fn_bltin_eof},
+#endif
 #ifdef B1_FEATURE_FUNCTIONS_MATH_EXTRA
 	{{{0x796f0, B1_IDENT_FLAGS_SET_FN(1, 1)}, {B1_TYPE_FP_HIGH_PREC}, B1_TYPE_FP_HIGH_PREC}, b1_fn_bltin_exp},
 #endif
@@ -110,6 +169,12 @@ static const B1_BLTIN_FN b1_fn_bltin[B1_FN_BLTIN_COUNT] =
 #ifdef B1_FEATURE_FUNCTIONS_MATH_EXTRA
 	{{{0x7bb09, B1_IDENT_FLAGS_SET_FN(1, 1)}, {B1_TYPE_FP_HIGH_PREC}, B1_TYPE_FP_HIGH_PREC}, b1_fn_bltin_log},
 #endif
+#ifdef B1_FEATURE_FUNCTIONS_ARRAY
+	{{{0x7be6d, B1_IDENT_FLAGS_SET_FN(1, 1)}, {B1_TYPE_ARRAY_REF}, B1_TYPE_FP_HIGH_PREC}, b1_fn_bltin_max},
+#endif
+#ifdef B1_FEATURE_FUNCTIONS_ARRAY
+	{{{0x7bf8b, B1_IDENT_FLAGS_SET_FN(1, 1)}, {B1_TYPE_ARRAY_REF}, B1_TYPE_FP_HIGH_PREC}, b1_fn_bltin_min},
+#endif
 #ifdef B1_FEATURE_FUNCTIONS_MATH_BASIC
 #ifdef B1_FRACTIONAL_TYPE_EXISTS
 	{{{0x7daf7, B1_IDENT_FLAGS_SET_FN(0, 1)}, {0}, B1_TYPE_FP_HIGH_PREC}, b1_fn_bltin_rnd},
@@ -124,6 +189,9 @@ static const B1_BLTIN_FN b1_fn_bltin[B1_FN_BLTIN_COUNT] =
 #ifdef B1_FEATURE_FUNCTIONS_MATH_EXTRA
 	{{{0x7e0cd, B1_IDENT_FLAGS_SET_FN(1, 1)}, {B1_TYPE_FP_HIGH_PREC}, B1_TYPE_FP_HIGH_PREC}, b1_fn_bltin_sqr},
 #endif
+#ifdef B1_FEATURE_FUNCTIONS_ARRAY
+	{{{0x7e15c, B1_IDENT_FLAGS_SET_FN(1, 1)}, {B1_TYPE_ARRAY_REF}, B1_TYPE_FP_HIGH_PREC}, b1_fn_bltin_sum},
+#endif
 #ifdef B1_FEATURE_FUNCTIONS_MATH_EXTRA
 	{{{0x7e3d2, B1_IDENT_FLAGS_SET_FN(1, 1)}, {B1_TYPE_FP_HIGH_PREC}, B1_TYPE_FP_HIGH_PREC}, b1_fn_bltin_tan},
 #endif
@@ -136,6 +204,12 @@ static const B1_BLTIN_FN b1_fn_bltin[B1_FN_BLTIN_COUNT] =
 #ifdef B1_FEATURE_FUNCTIONS_STANDARD
 	{{{0x11b969f, B1_IDENT_FLAGS_SET_FN(3, 1)}, {B1_TYPE_BOOL, B1_TYPE_STRING, B1_TYPE_STRING}, B1_TYPE_STRING}, b1_fn_bltin_striif},
 #endif
+#ifdef B1_FEATURE_TYPE_MAP
+	{{{0x11d0fb4, B1_IDENT_FLAGS_SET_FN(2, 1)}, {B1_TYPE_ARRAY_REF, B1_TYPE_INT}, B1_TYPE_STRING}, b1_fn_bltin_key},
+#endif
+#ifdef B1_FEATURE_FUNCTIONS_ARRAY
+	{{{0x11e9840, B1_IDENT_FLAGS_SET_FN(1, 1)}, {B1_TYPE_ARRAY_REF}, B1_TYPE_FP_HIGH_PREC}, b1_fn_bltin_mean},
+#endif
 #ifdef B1_FEATURE_FUNCTIONS_STRING
 	{{{0x11eadc9, B1_IDENT_FLAGS_SET_FN(3, 1)}, {B1_TYPE_STRING, B1_TYPE_INT, B1_TYPE_ANY}, B1_TYPE_STRING}, b1_fn_bltin_mid},
 #endif
@@ -148,9 +222,15 @@ static const B1_BLTIN_FN b1_fn_bltin[B1_FN_BLTIN_COUNT] =
 #ifdef B1_FEATURE_FUNCTIONS_STRING
 	{{{0x1300c35d, B1_IDENT_FLAGS_SET_FN(1, 1)}, {B1_TYPE_STRING}, B1_TYPE_STRING}, b1_fn_bltin_rtrim},
 #endif
+#ifdef B1_FEATURE_STMT_SORT
+	{{{0x1568f359, B1_IDENT_FLAGS_SET_FN(2, 1)}, {B1_TYPE_ARRAY_REF, B1_TYPE_ANY}, B1_TYPE_INT}, b1_fn_bltin_search},
+#endif
 #ifdef B1_FEATURE_FUNCTIONS_STRING
 	{{{0x1d73fc80, B1_IDENT_FLAGS_SET_FN(1, 1)}, {B1_TYPE_STRING}, B1_TYPE_STRING}, b1_fn_bltin_ucase},
 #endif
+#ifdef B1_FEATURE_TYPE_MAP
+	{{{0x28562de0, B1_IDENT_FLAGS_SET_FN(1, 1)}, {B1_TYPE_ARRAY_REF}, B1_TYPE_INT}, b1_fn_bltin_count},
+#endif
 #ifdef B1_FEATURE_FUNCTIONS_STRING
 	{{{0x2900f3d3, B1_IDENT_FLAGS_SET_FN(3, 1)}, {B1_TYPE_ANY, B1_TYPE_STRING, B1_TYPE_STRING}, B1_TYPE_INT}, b1_fn_bltin_instr},
 #endif
@@ -163,6 +243,9 @@ static const B1_BLTIN_FN b1_fn_bltin[B1_FN_BLTIN_COUNT] =
 #ifdef B1_FEATURE_FUNCTIONS_STRING
 	{{{0x2a05e671, B1_IDENT_FLAGS_SET_FN(2, 1)}, {B1_TYPE_STRING, B1_TYPE_INT}, B1_TYPE_STRING}, b1_fn_bltin_rset},
 #endif
+#ifdef B1_FEATURE_TYPE_MAP
+	{{{0xddb10c57, B1_IDENT_FLAGS_SET_FN(2, 1)}, {B1_TYPE_ARRAY_REF, B1_TYPE_ANY}, B1_TYPE_BOOL}, b1_fn_bltin_exists},
+#endif
 #ifdef B1_FEATURE_FUNCTIONS_STRING
 	{{{0xf8410b03, B1_IDENT_FLAGS_SET_FN(1, 1)}, {B1_TYPE_STRING}, B1_TYPE_STRING}, b1_fn_bltin_lcase},
 #endif
@@ -208,12 +291,21 @@ static const B1_BLTIN_FN b1_fn_bltin[B1_FN_BLTIN_COUNT] =
 #ifdef B1_FEATURE_FUNCTIONS_STRING
 	{{{0x4c4e, B1_IDENT_FLAGS_SET_FN(1, 1)}, {B1_TYPE_STRING}, B1_TYPE_STRING}, b1_fn_bltin_rtrim},
 #endif
+#ifdef B1_FEATURE_FUNCTIONS_ARRAY
+	{{{0x530c, B1_IDENT_FLAGS_SET_FN(1, 1)}, {B1_TYPE_ARRAY_REF}, B1_TYPE_FP_HIGH_PREC}, b1_fn_bltin_mean},
+#endif
+#ifdef B1_FEATURE_FUNCTIONS_ARRAY
+	{{{0x5592, B1_IDENT_FLAGS_SET_FN(1, 1)}, {B1_TYPE_ARRAY_REF}, B1_TYPE_FP_HIGH_PREC}, b1_fn_bltin_max},
+#endif
 #ifdef B1_FEATURE_FUNCTIONS_STANDARD
 	{{{0x621d, B1_IDENT_FLAGS_SET_FN(3, 1)}, {B1_TYPE_BOOL, B1_TYPE_ANY, B1_TYPE_ANY}, B1_TYPE_ANY}, b1_fn_bltin_iif},
 #endif
 #ifdef B1_FEATURE_FUNCTIONS_MATH_EXTRA
 	{{{0x6370, B1_IDENT_FLAGS_SET_FN(1, 1)}, {B1_TYPE_FP_HIGH_PREC}, B1_TYPE_FP_HIGH_PREC}, b1_fn_bltin_cos},
 #endif
+#ifdef B1_FEATURE_STMT_FILE
+	{{{0x69cd, B1_IDENT_FLAGS_SET_FN(1, 1)}, {B1_TYPE_INT}, B1_TYPE_BOOL}, b1_fn_bltin_eof},
+#endif
 #ifdef B1_FEATURE_FUNCTIONS_STRING
 	{{{0x6d27, B1_IDENT_FLAGS_SET_FN(2, 1)}, {B1_TYPE_STRING, B1_TYPE_INT}, B1_TYPE_STRING}, b1_fn_bltin_rset},
 #endif
@@ -223,6 +315,12 @@ static const B1_BLTIN_FN b1_fn_bltin[B1_FN_BLTIN_COUNT] =
 #ifdef B1_FEATURE_FUNCTIONS_MATH_EXTRA
 	{{{0x71b5, B1_IDENT_FLAGS_SET_FN(1, 1)}, {B1_TYPE_FP_HIGH_PREC}, B1_TYPE_FP_HIGH_PREC}, b1_fn_bltin_atn},
 #endif
+#ifdef B1_FEATURE_FUNCTIONS_ARRAY
+	{{{0x7345, B1_IDENT_FLAGS_SET_FN(1, 1)}, {B1_TYPE_ARRAY_REF}, B1_TYPE_FP_HIGH_PREC}, b1_fn_bltin_min},
+#endif
+#ifdef B1_FEATURE_TYPE_MAP
+	{{{0x7558, B1_IDENT_FLAGS_SET_FN(2, 1)}, {B1_TYPE_ARRAY_REF, B1_TYPE_ANY}, B1_TYPE_BOOL}, b1_fn_bltin_exists},
+#endif
 #ifdef B1_FEATURE_FUNCTIONS_MATH_BASIC
 #ifdef B1_FRACTIONAL_TYPE_EXISTS
 	{{{0x77af, B1_IDENT_FLAGS_SET_FN(1, 1)}, {B1_TYPE_FP_HIGH_PREC}, B1_TYPE_FP_HIGH_PREC}, b1_fn_bltin_int},
@@ -240,15 +338,30 @@ static const B1_BLTIN_FN b1_fn_bltin[B1_FN_BLTIN_COUNT] =
 #ifdef B1_FEATURE_FUNCTIONS_STRING
 	{{{0x9628, B1_IDENT_FLAGS_SET_FN(2, 1)}, {B1_TYPE_STRING, B1_TYPE_INT}, B1_TYPE_STRING}, b1_fn_bltin_lset},
 #endif
+#ifdef B1_FEATURE_TYPE_MAP
+	{{{0xa0b0, B1_IDENT_FLAGS_SET_FN(1, 1)}, {B1_TYPE_ARRAY_REF}, B1_TYPE_INT}, b1_fn_bltin_count},
+#endif
+#ifdef B1_FEATURE_TYPE_MAP
+	{{{0xac59, B1_IDENT_FLAGS_SET_FN(2, 1)}, {B1_TYPE_ARRAY_REF, B1_TYPE_INT}, B1_TYPE_STRING}, b1_fn_bltin_key},
+#endif
 #ifdef B1_FEATURE_FUNCTIONS_MATH_EXTRA
 	{{{0xae97, B1_IDENT_FLAGS_SET_FN(1, 1)}, {B1_TYPE_FP_HIGH_PREC}, B1_TYPE_FP_HIGH_PREC}, b1_fn_bltin_sqr},
 #endif
+#ifdef B1_FEATURE_FUNCTIONS_ARRAY
+	{{{0xbd68, B1_IDENT_FLAGS_SET_FN(1, 1)}, {B1_TYPE_ARRAY_REF}, B1_TYPE_FP_HIGH_PREC}, b1_fn_bltin_sum},
+#endif
+#ifdef B1_FEATURE_STMT_SORT
+	{{{0xbe55, B1_IDENT_FLAGS_SET_FN(2, 1)}, {B1_TYPE_ARRAY_REF, B1_TYPE_ANY}, B1_TYPE_INT}, b1_fn_bltin_search},
+#endif
 #ifdef B1_FEATURE_FUNCTIONS_MATH_EXTRA
 	{{{0xd787, B1_IDENT_FLAGS_SET_FN(0, 1)}, {0}, B1_TYPE_FP_HIGH_PREC}, b1_fn_bltin_pi},
 #endif
 #ifdef B1_FEATURE_FUNCTIONS_STANDARD
 	{{{0xdfc8, B1_IDENT_FLAGS_SET_FN(1, 1)}, {B1_TYPE_STRING}, B1_TYPE_INT}, b1_fn_bltin_len},
 #endif
+#ifdef B1_FEATURE_FUNCTIONS_ARRAY
+	{{{0xe793, B1_IDENT_FLAGS_SET_FN(2, 1)}, {B1_TYPE_ARRAY_REF, B1_TYPE_ARRAY_REF}, B1_TYPE_FP_HIGH_PREC}, b1_fn_bltin_dot},
+#endif
 #ifdef B1_FEATURE_FUNCTIONS_STRING
 	{{{0xeaa3, B1_IDENT_FLAGS_SET_FN(2, 1)}, {B1_TYPE_STRING, B1_TYPE_INT}, B1_TYPE_STRING}, b1_fn_bltin_left},
 #endif
@@ -479,17 +592,13 @@ static B1_T_ERROR b1_fn_bltin_rnd(B1_VAR *parg1)
 	B1_T_RAND_SEED seed;
 
 	seed = b1_ex_rnd_get_next_seed();
-	if(seed == B1_T_RAND_SEED_MAX_VALUE)
-	{
-		seed--;
-	}
 
 #ifdef B1_FEATURE_TYPE_DOUBLE
 	(*parg1).type = B1_TYPE_SET(B1_TYPE_DOUBLE, 0);
-	(*parg1).value.dval = ((double)seed) / ((double)B1_T_RAND_SEED_MAX_VALUE);
+	(*parg1).value.dval = B1_FN_RND_SEED_TO_FP(seed);
 #else
 	(*parg1).type = B1_TYPE_SET(B1_TYPE_SINGLE, 0);
-	(*parg1).value.sval = ((float)seed) / ((float)B1_T_RAND_SEED_MAX_VALUE);
+	(*parg1).value.sval = B1_FN_RND_SEED_TO_FP(seed);
 #endif
 
 	return B1_RES_OK;
@@ -692,7 +801,9 @@ static B1_T_ERROR b1_fn_bltin_mid(B1_VAR *parg1)
 static B1_T_ERROR b1_fn_bltin_instr(B1_VAR *parg1)
 {
 	B1_T_ERROR err;
-	B1_T_INDEX start, len;
+	B1_T_INDEX start, len, slen, i;
+	B1_T_CHAR c, first, last;
+	const B1_T_CHAR *s;
 
 	start = 1;
 
@@ -749,20 +860,34 @@ static B1_T_ERROR b1_fn_bltin_instr(B1_VAR *parg1)
 		return B1_RES_OK;
 	}
 
-	len -= *b1_tmp_buf1;
+	// convert both strings to upper case once so that characters can be compared exactly
+	slen = *b1_tmp_buf1;
+	for(i = slen; i != 0; i--)
+	{
+		c = *(b1_tmp_buf1 + i);
+		*(b1_tmp_buf1 + i) = B1_T_TOUPPER_L(c);
+	}
+	for(i = *b1_tmp_buf; i >= start; i--)
+	{
+		c = *(b1_tmp_buf + i);
+		*(b1_tmp_buf + i) = B1_T_TOUPPER_L(c);
+	}
+
+	// check the first and the last characters before comparing the rest of the string
+	first = *(b1_tmp_buf1 + 1);
+	last = *(b1_tmp_buf1 + slen);
+	s = b1_tmp_buf + start;
+	len -= slen;
 	len++;
 	while(len-- != 0)
 	{
-#ifdef B1_FEATURE_LOCALES
-		if(b1_t_strcmp_l(b1_tmp_buf1, b1_tmp_buf + start, *b1_tmp_buf1) == 0)
-#else
-		if(b1_t_strcmpi(b1_tmp_buf1, b1_tmp_buf + start, *b1_tmp_buf1) == 0)
-#endif
+		if(*s == first && *(s + slen - 1) == last &&
+			(slen < 3 || !memcmp(s + 1, b1_tmp_buf1 + 2, (slen - 2) * B1_T_CHAR_SIZE)))
 		{
-			(*parg1).value.i32val = start;
+			(*parg1).value.i32val = (int32_t)(s - b1_tmp_buf);
 			return B1_RES_OK;
 		}
-		start++;
+		s++;
 	}
 
 	return B1_RES_OK;
@@ -1051,13 +1176,705 @@ static B1_T_ERROR b1_fn_bltin_lcase(B1_VAR *parg1)
 }
 #endif
 
+#ifdef B1_FEATURE_FUNCTIONS_ARRAY
+// gets the variable passed to an array function by name (B1_TYPE_ARRAY_REF argument), the variable must exist
+static B1_T_ERROR b1_fn_arr_get_var(const B1_VAR *parg, B1_NAMED_VAR **var)
+{
+	B1_T_ERROR err;
+
+	err = b1_ex_var_alloc((*parg).value.id_hash, var);
+	if(err == B1_RES_OK)
+	{
+		b1_ex_var_free((*parg).value.id_hash);
+		return B1_RES_EUNKIDENT;
+	}
+
+	return (err == B1_RES_EIDINUSE) ? B1_RES_OK : err;
+}
+
+// gets shape and data memory block descriptor of the array passed to an array function
+static B1_T_ERROR b1_fn_arr_get_info(const B1_VAR *parg, B1_VAR_ARRAY_INFO *info)
+{
+	B1_T_ERROR err;
+	B1_NAMED_VAR *var;
+
+	err = b1_fn_arr_get_var(parg, &var);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	return b1_var_array_get_info(var, 0, info);
+}
+
+// processes array elements by chunks: calculates sum (B1_FN_ARR_OP_SUM), minimal (B1_FN_ARR_OP_MIN)
+// or maximal (B1_FN_ARR_OP_MAX) element value, or dot product (B1_FN_ARR_OP_DOT) of two arrays
+static B1_T_ERROR b1_fn_arr_reduce(B1_VAR *parg1, uint8_t op, B1_T_ARRAY_VAL *res, B1_T_MEMOFFSET *size)
+{
+	B1_T_ERROR err;
+	B1_VAR_ARRAY_INFO info1, info2;
+	B1_T_MEMOFFSET offset, n, i;
+	B1_T_ARRAY_VAL *buf1, *buf2, r;
+
+	err = b1_fn_arr_get_info(parg1, &info1);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	if(op == B1_FN_ARR_OP_DOT)
+	{
+		err = b1_fn_arr_get_info(parg1 + 1, &info2);
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
+
+		if(info1.size != info2.size)
+		{
+			return B1_RES_ESUBSRANGE;
+		}
+	}
+
+	buf1 = b1_fn_arr_buf[0];
+	buf2 = b1_fn_arr_buf[1];
+
+	r = (B1_T_ARRAY_VAL)0;
+
+	for(offset = 0; offset < info1.size; offset += n)
+	{
+		n = info1.size - offset;
+		if(n > B1_FN_ARR_BUF_LEN)
+		{
+			n = B1_FN_ARR_BUF_LEN;
+		}
+
+		err = b1_var_array_copy(&info1, offset, n, buf1, 0);
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
+
+		if(offset == 0)
+		{
+			r = (op == B1_FN_ARR_OP_MIN || op == B1_FN_ARR_OP_MAX) ? *buf1 : (B1_T_ARRAY_VAL)0;
+		}
+
+		switch(op)
+		{
+			case B1_FN_ARR_OP_SUM:
+				for(i = 0; i < n; i++) r += buf1[i];
+				break;
+			case B1_FN_ARR_OP_MIN:
+				for(i = 0; i < n; i++) r = (buf1[i] < r) ? buf1[i] : r;
+				break;
+			case B1_FN_ARR_OP_MAX:
+				for(i = 0; i < n; i++) r = (buf1[i] > r) ? buf1[i] : r;
+				break;
+			case B1_FN_ARR_OP_DOT:
+				err = b1_var_array_copy(&info2, offset, n, buf2, 0);
+				if(err != B1_RES_OK)
+				{
+					return err;
+				}
+
+				for(i = 0; i < n; i++) r += buf1[i] * buf2[i];
+				break;
+		}
+	}
+
+	*res = r;
+
+	if(size != NULL)
+	{
+		*size = info1.size;
+	}
+
+	return B1_RES_OK;
+}
+
+// sets function result
+static void b1_fn_arr_set_result(B1_VAR *parg1, B1_T_ARRAY_VAL res)
+{
+	(*parg1).type = B1_TYPE_SET(B1_TYPE_FP_HIGH_PREC, 0);
+#ifdef B1_FEATURE_TYPE_DOUBLE
+	(*parg1).value.dval = res;
+#else
+	(*parg1).value.sval = res;
+#endif
+}
+
+static B1_T_ERROR b1_fn_bltin_sum(B1_VAR *parg1)
+{
+	B1_T_ERROR err;
+	B1_T_ARRAY_VAL res;
+
+	err = b1_fn_arr_reduce(parg1, B1_FN_ARR_OP_SUM, &res, NULL);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	b1_fn_arr_set_result(parg1, res);
+
+	return B1_RES_OK;
+}
+
+static B1_T_ERROR b1_fn_bltin_min(B1_VAR *parg1)
+{
+	B1_T_ERROR err;
+	B1_T_ARRAY_VAL res;
+
+	err = b1_fn_arr_reduce(parg1, B1_FN_ARR_OP_MIN, &res, NULL);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	b1_fn_arr_set_result(parg1, res);
+
+	return B1_RES_OK;
+}
+
+static B1_T_ERROR b1_fn_bltin_max(B1_VAR *parg1)
+{
+	B1_T_ERROR err;
+	B1_T_ARRAY_VAL res;
+
+	err = b1_fn_arr_reduce(parg1, B1_FN_ARR_OP_MAX, &res, NULL);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	b1_fn_arr_set_result(parg1, res);
+
+	return B1_RES_OK;
+}
+
+static B1_T_ERROR b1_fn_bltin_mean(B1_VAR *parg1)
+{
+	B1_T_ERROR err;
+	B1_T_ARRAY_VAL res;
+	B1_T_MEMOFFSET size;
+
+	err = b1_fn_arr_reduce(parg1, B1_FN_ARR_OP_SUM, &res, &size);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	b1_fn_arr_set_result(parg1, res / (B1_T_ARRAY_VAL)size);
+
+	return B1_RES_OK;
+}
+
+static B1_T_ERROR b1_fn_bltin_dot(B1_VAR *parg1)
+{
+	B1_T_ERROR err;
+	B1_T_ARRAY_VAL res;
+
+	err = b1_fn_arr_reduce(parg1, B1_FN_ARR_OP_DOT, &res, NULL);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	b1_fn_arr_set_result(parg1, res);
+
+	return B1_RES_OK;
+}
+#endif
+
+#ifdef B1_FEATURE_STMT_SORT
+// compares array element with the key (string array elements are compared with the string in b1_tmp_buf1)
+static B1_T_ERROR b1_fn_arr_cmp(const B1_VAR_ARRAY_INFO *info, B1_T_MEMOFFSET i, B1_T_ARRAY_VAL key, int8_t *res)
+{
+	B1_T_ERROR err;
+	B1_T_ARRAY_VAL val;
+
+	if((*info).type == B1_TYPE_STRING)
+	{
+		err = b1_var_array_get_str(info, i, b1_tmp_buf);
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
+
+		*res = B1_T_STRCMP_L(b1_tmp_buf, b1_tmp_buf1 + 1, *b1_tmp_buf1);
+
+		return B1_RES_OK;
+	}
+
+	err = b1_var_array_copy(info, i, 1, &val, 0);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	*res = (val < key) ? (int8_t)-1 : (val > key) ? (int8_t)1 : (int8_t)0;
+
+	return B1_RES_OK;
+}
+
+// binary search in one-dimensional array sorted in ascending order: returns subscript of the first element
+// equal to the value or the array lower bound minus one if the value is not found
+static B1_T_ERROR b1_fn_bltin_search(B1_VAR *parg1)
+{
+	B1_T_ERROR err;
+	B1_VAR_ARRAY_INFO info;
+	B1_T_MEMOFFSET lo, hi, mid;
+	B1_T_ARRAY_VAL key;
+	int8_t res;
+
+	err = b1_fn_arr_get_info(parg1, &info);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	if(info.dimnum != 1)
+	{
+		return B1_RES_EWSUBSCNT;
+	}
+
+	key = (B1_T_ARRAY_VAL)0;
+
+	if(info.type == B1_TYPE_STRING)
+	{
+		err = b1_var_var2str(parg1 + 1, b1_tmp_buf1);
+	}
+	else
+	{
+		err = b1_var_convert(parg1 + 1, B1_TYPE_FP_HIGH_PREC);
+#ifdef B1_FEATURE_TYPE_DOUBLE
+		key = (*(parg1 + 1)).value.dval;
+#else
+		key = (*(parg1 + 1)).value.sval;
+#endif
+	}
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	lo = 0;
+	hi = info.size;
+
+	while(lo < hi)
+	{
+		mid = lo + (hi - lo) / 2;
+
+		err = b1_fn_arr_cmp(&info, mid, key, &res);
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
+
+		if(res < 0)
+		{
+			lo = mid + 1;
+		}
+		else
+		{
+			hi = mid;
+		}
+	}
+
+	res = 1;
+
+	if(lo < info.size)
+	{
+		err = b1_fn_arr_cmp(&info, lo, key, &res);
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
+	}
+
+	(*parg1).type = B1_TYPE_SET(B1_TYPE_INT, 0);
+	(*parg1).value.i32val = (int32_t)info.lbounds[0] + ((res == 0) ? (int32_t)lo : (int32_t)-1);
+
+	return B1_RES_OK;
+}
+#endif
+
+#ifdef B1_FEATURE_TYPE_MAP
+// gets map variable passed to a map function
+static B1_T_ERROR b1_fn_map_get_var(const B1_VAR *parg, B1_NAMED_VAR **var)
+{
+	B1_T_ERROR err;
+
+	err = b1_fn_arr_get_var(parg, var);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	return B1_IDENT_TEST_FLAGS_VAR_MAP((**var).id.flags) ? B1_RES_OK : B1_RES_ETYPMISM;
+}
+
+static B1_T_ERROR b1_fn_bltin_exists(B1_VAR *parg1)
+{
+	B1_T_ERROR err;
+	B1_NAMED_VAR *var;
+
+	err = b1_fn_map_get_var(parg1, &var);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	err = b1_var_map_find(var, parg1 + 1, 0);
+	if(err != B1_RES_OK && err != B1_RES_EUNKIDENT)
+	{
+		return err;
+	}
+
+	(*parg1).type = B1_TYPE_SET(B1_TYPE_BOOL, 0);
+	(*parg1).value.bval = (err == B1_RES_OK);
+
+	return B1_RES_OK;
+}
+
+static B1_T_ERROR b1_fn_bltin_count(B1_VAR *parg1)
+{
+	B1_T_ERROR err;
+	B1_NAMED_VAR *var;
+	B1_T_MEMOFFSET count;
+
+	err = b1_fn_map_get_var(parg1, &var);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	err = b1_var_map_get_count(var, &count);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	(*parg1).type = B1_TYPE_SET(B1_TYPE_INT, 0);
+	(*parg1).value.i32val = (int32_t)count;
+
+	return B1_RES_OK;
+}
+
+// KEY$(<map_name>, <n>) returns n-th key of the map (1 <= n <= COUNT(<map_name>))
+static B1_T_ERROR b1_fn_bltin_key(B1_VAR *parg1)
+{
+	B1_T_ERROR err;
+	B1_NAMED_VAR *var;
+	int32_t num;
+
+	err = b1_fn_map_get_var(parg1, &var);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	num = (*(parg1 + 1)).value.i32val;
+	if(num < 1 || num > B1_T_MEMOFFSET_MAX_VALUE)
+	{
+		return B1_RES_ESUBSRANGE;
+	}
+
+	err = b1_var_map_get_key(var, (B1_T_MEMOFFSET)num, b1_tmp_buf);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	return b1_var_str2var(b1_tmp_buf, parg1);
+}
+#endif
+
+#ifdef B1_FEATURE_STMT_FILE
+// EOF(<n>) returns TRUE if there is no more data to read from file channel n
+static B1_T_ERROR b1_fn_bltin_eof(B1_VAR *parg1)
+{
+	B1_T_ERROR err;
+	int32_t chan;
+	uint8_t eof;
+
+	chan = (*parg1).value.i32val;
+	if(chan < 1 || chan > B1_MAX_FILE_CHAN_NUM)
+	{
+		return B1_RES_EINVARG;
+	}
+
+	err = b1_ex_file_eof((uint8_t)chan, &eof);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	(*parg1).type = B1_TYPE_SET(B1_TYPE_BOOL, 0);
+	(*parg1).value.bval = eof;
+
+	return B1_RES_OK;
+}
+#endif
+
+#ifdef B1_FEATURE_FUNCTIONS_USER
+// copies data from stack memory block to buf or from buf to the memory block (write != 0) by parts
+// not exceeding B1_MAX_STRING_LEN + 1 bytes (maximal size of memory block region accessible at once)
+static B1_T_ERROR b1_fn_stack_copy(B1_T_MEM_BLOCK_DESC desc, B1_T_MEMOFFSET offset, B1_T_MEMOFFSET size, uint8_t *buf, uint8_t write)
+{
+	B1_T_ERROR err;
+	B1_T_INDEX len;
+	void *data;
+
+	while(size != 0)
+	{
+		len = (size > B1_MAX_STRING_LEN + 1) ? (B1_T_INDEX)(B1_MAX_STRING_LEN + 1) : (B1_T_INDEX)size;
+
+		err = b1_ex_mem_access(desc, offset, len, write ? B1_EX_MEM_WRITE : B1_EX_MEM_READ, &data);
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
+
+		if(write)
+		{
+			memcpy(data, buf, len);
+		}
+		else
+		{
+			memcpy(buf, data, len);
+		}
+
+		b1_ex_mem_release(desc);
+
+		offset += len;
+		size -= len;
+		buf += len;
+	}
+
+	return B1_RES_OK;
+}
+
+void b1_fn_stack_init(B1_FN_STACK *stack)
+{
+	(*stack).mem_desc = B1_T_MEM_BLOCK_DESC_INVALID;
+	(*stack).size = 0;
+	(*stack).top = 0;
+}
+
+// pushes data to the stack, the stack memory block is replaced with twice larger one when it is full
+B1_T_ERROR b1_fn_stack_push(B1_FN_STACK *stack, const void *data, B1_T_MEMOFFSET size)
+{
+	B1_T_ERROR err;
+	B1_T_MEMOFFSET new_size, offset, len;
+	B1_T_MEM_BLOCK_DESC desc;
+	uint8_t buf[B1_FN_STACK_BUF_LEN];
+
+	if((*stack).size - (*stack).top < size)
+	{
+		new_size = ((*stack).size == 0) ? B1_FN_STACK_INIT_SIZE : (*stack).size;
+
+		while(new_size - (*stack).top < size)
+		{
+			if(new_size > B1_T_MEMOFFSET_MAX_VALUE / 2)
+			{
+				return B1_RES_ENOMEM;
+			}
+
+			new_size *= 2;
+		}
+
+		err = b1_ex_mem_alloc(new_size, &desc, NULL);
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
+
+		// move stack records to the new memory block
+		for(offset = 0; offset != (*stack).top; offset += len)
+		{
+			len = (*stack).top - offset;
+			if(len > B1_FN_STACK_BUF_LEN)
+			{
+				len = B1_FN_STACK_BUF_LEN;
+			}
+
+			err = b1_fn_stack_copy((*stack).mem_desc, offset, len, buf, 0);
+			if(err == B1_RES_OK)
+			{
+				err = b1_fn_stack_copy(desc, offset, len, buf, 1);
+			}
+
+			if(err != B1_RES_OK)
+			{
+				b1_ex_mem_free(desc);
+				return err;
+			}
+		}
+
+		if((*stack).mem_desc != B1_T_MEM_BLOCK_DESC_INVALID)
+		{
+			b1_ex_mem_free((*stack).mem_desc);
+		}
+
+		(*stack).mem_desc = desc;
+		(*stack).size = new_size;
+	}
+
+	err = b1_fn_stack_copy((*stack).mem_desc, (*stack).top, size, (uint8_t *)data, 1);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	(*stack).top += size;
+
+	return B1_RES_OK;
+}
+
+B1_T_ERROR b1_fn_stack_pop(B1_FN_STACK *stack, void *data, B1_T_MEMOFFSET size)
+{
+	if((*stack).top < size)
+	{
+		return B1_RES_ESTSTKUDF;
+	}
+
+	(*stack).top -= size;
+
+	return b1_fn_stack_copy((*stack).mem_desc, (*stack).top, size, (uint8_t *)data, 0);
+}
+
+// reads stack data without removing it
+B1_T_ERROR b1_fn_stack_read(const B1_FN_STACK *stack, B1_T_MEMOFFSET offset, void *data, B1_T_MEMOFFSET size)
+{
+	return b1_fn_stack_copy((*stack).mem_desc, offset, size, (uint8_t *)data, 0);
+}
+#endif
+
+#ifdef B1_FEATURE_FUNCTIONS_USER_MEMO
+// calculates results cache record index from function name hash and argument values (FNV-1a hash)
+static B1_T_INDEX b1_fn_udef_memo_index(B1_T_IDHASH name_hash, const B1_VAR *args, uint8_t argnum)
+{
+	uint32_t hash;
+	uint8_t i, size;
+	const uint8_t *data;
+
+	hash = (uint32_t)2166136261UL ^ (uint32_t)name_hash;
+
+	for(; argnum != 0; argnum--, args++)
+	{
+		size = b1_var_get_type_size(B1_TYPE_GET((*args).type));
+		data = (const uint8_t *)&(*args).value;
+
+		for(i = 0; i < size; i++)
+		{
+			hash = (hash ^ data[i]) * (uint32_t)16777619UL;
+		}
+	}
+
+	return (B1_T_INDEX)(hash % B1_MAX_UDEF_MEMO_NUM);
+}
+
+void b1_fn_udef_memo_init()
+{
+	B1_T_INDEX i;
+
+	for(i = 0; i < B1_MAX_UDEF_MEMO_NUM; i++)
+	{
+		b1_fn_udef_memo[i].busy = 0;
+	}
+
+	b1_fn_udef_memo_hits = 0;
+	b1_fn_udef_memo_misses = 0;
+}
+
+// looks for cached result of pure function call, returns non-zero value if the result is found. arguments are
+// already converted to the function argument types so their values are compared bytewise
+uint8_t b1_fn_udef_memo_get(B1_T_IDHASH name_hash, const B1_VAR *args, uint8_t argnum, B1_VAR *result)
+{
+	uint8_t i;
+	const B1_UDEF_MEMO_REC *rec;
+
+	rec = b1_fn_udef_memo + b1_fn_udef_memo_index(name_hash, args, argnum);
+
+	if((*rec).busy && (*rec).name_hash == name_hash)
+	{
+		for(i = 0; i < argnum; i++)
+		{
+			if(memcmp(&(*rec).args[i].value, &args[i].value, b1_var_get_type_size(B1_TYPE_GET(args[i].type))))
+			{
+				break;
+			}
+		}
+
+		if(i == argnum)
+		{
+			b1_fn_udef_memo_hits++;
+			*result = (*rec).result;
+			return 1;
+		}
+	}
+
+	b1_fn_udef_memo_misses++;
+
+	return 0;
+}
+
+// caches pure function result (replaces the record with the same index)
+void b1_fn_udef_memo_put(B1_T_IDHASH name_hash, const B1_VAR *args, uint8_t argnum, const B1_VAR *result)
+{
+	B1_UDEF_MEMO_REC *rec;
+
+	rec = b1_fn_udef_memo + b1_fn_udef_memo_index(name_hash, args, argnum);
+
+	(*rec).busy = 1;
+	(*rec).name_hash = name_hash;
+	memcpy((*rec).args, args, argnum * sizeof(B1_VAR));
+	(*rec).result = *result;
+}
+
+// returns non-zero value if result of the built-in function depends on its arguments only
+uint8_t b1_fn_bltin_is_pure(const B1_FN *fn)
+{
+#ifdef B1_FEATURE_STMT_FILE
+	if((*((const B1_BLTIN_FN *)fn)).fn_ptr == b1_fn_bltin_eof)
+	{
+		return 0;
+	}
+#endif
+
+#if defined(B1_FEATURE_FUNCTIONS_MATH_BASIC) && defined(B1_FRACTIONAL_TYPE_EXISTS)
+	return (*((const B1_BLTIN_FN *)fn)).fn_ptr != b1_fn_bltin_rnd;
+#else
+	return 1;
+#endif
+}
+#endif
+
+#ifdef B1_FEATURE_BLTIN_FN_BINDING
+// returns built-in function index used by RPN records or B1_FN_BLTIN_NONE
+uint8_t b1_fn_bltin_get_index(B1_T_IDHASH name_hash)
+{
+	const B1_BLTIN_FN *fn;
+
+	fn = (const B1_BLTIN_FN *)bsearch(&name_hash, b1_fn_bltin, B1_FN_BLTIN_COUNT, sizeof(B1_BLTIN_FN), b1_id_cmp_hashes);
+
+	return fn == NULL ? B1_FN_BLTIN_NONE : (uint8_t)(fn - b1_fn_bltin);
+}
+
+B1_FN *b1_fn_bltin_get(uint8_t index)
+{
+	return (B1_FN *)(b1_fn_bltin + index);
+}
+#endif
+
 #ifdef B1_FEATURE_FUNCTIONS_USER
 B1_T_ERROR b1_fn_get_params(B1_T_IDHASH name_hash, uint8_t alloc_new, B1_FN **fn_ptr)
 #else
 B1_T_ERROR b1_fn_get_params(B1_T_IDHASH name_hash, B1_FN **fn_ptr)
 #endif
 {
-#if defined(B1_FEATURE_FUNCTIONS_STANDARD) || defined(B1_FEATURE_FUNCTIONS_MATH_BASIC) || defined(B1_FEATURE_FUNCTIONS_MATH_EXTRA) || defined(B1_FEATURE_FUNCTIONS_STRING)
+#if defined(B1_FEATURE_FUNCTIONS_STANDARD) || defined(B1_FEATURE_FUNCTIONS_MATH_BASIC) || defined(B1_FEATURE_FUNCTIONS_MATH_EXTRA) || defined(B1_FEATURE_FUNCTIONS_STRING) || defined(B1_FEATURE_FUNCTIONS_ARRAY)
 	*fn_ptr = (B1_FN *)bsearch(&name_hash, b1_fn_bltin, B1_FN_BLTIN_COUNT, sizeof(B1_BLTIN_FN), b1_id_cmp_hashes);
 	if(*fn_ptr != NULL)
 	{
@@ -61,12 +61,54 @@
 #define B1_FN_BLTIN_COUNT_STRING 0
 #endif
 
-#if defined(B1_FEATURE_FUNCTIONS_STANDARD) || defined(B1_FEATURE_FUNCTIONS_MATH_BASIC) || defined(B1_FEATURE_FUNCTIONS_MATH_EXTRA) || defined(B1_FEATURE_FUNCTIONS_STRING)
-#define B1_FN_BLTIN_COUNT ((B1_T_INDEX)(B1_FN_BLTIN_COUNT_STANDARD + B1_FN_BLTIN_COUNT_MATH_BASIC + B1_FN_BLTIN_COUNT_MATH_EXTRA + B1_FN_BLTIN_COUNT_STRING))
+#ifdef B1_FEATURE_FUNCTIONS_ARRAY
+#ifdef B1_FEATURE_STMT_SORT
+#define B1_FN_BLTIN_COUNT_ARRAY 6
+#else
+#define B1_FN_BLTIN_COUNT_ARRAY 5
+#endif
+#else
+#define B1_FN_BLTIN_COUNT_ARRAY 0
+#endif
+
+#ifdef B1_FEATURE_TYPE_MAP
+#define B1_FN_BLTIN_COUNT_MAP 3
+#else
+#define B1_FN_BLTIN_COUNT_MAP 0
+#endif
+
+#ifdef B1_FEATURE_STMT_FILE
+#define B1_FN_BLTIN_COUNT_FILE 1
+#else
+#define B1_FN_BLTIN_COUNT_FILE 0
+#endif
+
+#if defined(B1_FEATURE_FUNCTIONS_STANDARD) || defined(B1_FEATURE_FUNCTIONS_MATH_BASIC) || defined(B1_FEATURE_FUNCTIONS_MATH_EXTRA) || defined(B1_FEATURE_FUNCTIONS_STRING) || defined(B1_FEATURE_FUNCTIONS_ARRAY)
+#define B1_FN_BLTIN_COUNT ((B1_T_INDEX)(B1_FN_BLTIN_COUNT_STANDARD + B1_FN_BLTIN_COUNT_MATH_BASIC + B1_FN_BLTIN_COUNT_MATH_EXTRA + B1_FN_BLTIN_COUNT_STRING + B1_FN_BLTIN_COUNT_ARRAY + B1_FN_BLTIN_COUNT_MAP + B1_FN_BLTIN_COUNT_FILE))
 #endif
 
+#ifdef B1_FEATURE_FUNCTIONS_MATH_BASIC
+#ifdef B1_FRACTIONAL_TYPE_EXISTS
+// converts random generator seed to RND function value (from 0 inclusive to 1 exclusive)
+#ifdef B1_FEATURE_RAND_SEED_32BIT
+#ifdef B1_FEATURE_TYPE_DOUBLE
+#define B1_FN_RND_SEED_TO_FP(seed) (((double)(seed)) / 4294967296.0)
+#else
+// single precision value keeps 24 upper bits only, so the result cannot be rounded up to 1
+#define B1_FN_RND_SEED_TO_FP(seed) (((float)((seed) >> 8)) / 16777216.0f)
+#endif
+#else
+#ifdef B1_FEATURE_TYPE_DOUBLE
+#define B1_FN_RND_SEED_TO_FP(seed) (((double)((seed) - (((seed) == B1_T_RAND_SEED_MAX_VALUE) ? 1 : 0))) / ((double)B1_T_RAND_SEED_MAX_VALUE))
+#else
+#define B1_FN_RND_SEED_TO_FP(seed) (((float)((seed) - (((seed) == B1_T_RAND_SEED_MAX_VALUE) ? 1 : 0))) / ((float)B1_T_RAND_SEED_MAX_VALUE))
+#endif
+#endif
+#endif
+#endif
 
-#if defined(B1_FEATURE_FUNCTIONS_STANDARD) || defined(B1_FEATURE_FUNCTIONS_MATH_BASIC) || defined(B1_FEATURE_FUNCTIONS_MATH_EXTRA) || defined(B1_FEATURE_FUNCTIONS_STRING) || defined(B1_FEATURE_FUNCTIONS_USER)
+
+#if defined(B1_FEATURE_FUNCTIONS_STANDARD) || defined(B1_FEATURE_FUNCTIONS_MATH_BASIC) || defined(B1_FEATURE_FUNCTIONS_MATH_EXTRA) || defined(B1_FEATURE_FUNCTIONS_STRING) || defined(B1_FEATURE_FUNCTIONS_ARRAY) || defined(B1_FEATURE_FUNCTIONS_USER)
 typedef struct
 {
 	B1_ID id;
@@ -75,7 +117,7 @@ typedef struct
 } B1_FN;
 #endif
 
-#if defined(B1_FEATURE_FUNCTIONS_STANDARD) || defined(B1_FEATURE_FUNCTIONS_MATH_BASIC) || defined(B1_FEATURE_FUNCTIONS_MATH_EXTRA) || defined(B1_FEATURE_FUNCTIONS_STRING)
+#if defined(B1_FEATURE_FUNCTIONS_STANDARD) || defined(B1_FEATURE_FUNCTIONS_MATH_BASIC) || defined(B1_FEATURE_FUNCTIONS_MATH_EXTRA) || defined(B1_FEATURE_FUNCTIONS_STRING) || defined(B1_FEATURE_FUNCTIONS_ARRAY)
 typedef uint8_t (*b1_fn_bltin_ptr)(B1_VAR *);
 
 typedef struct
@@ -90,15 +132,51 @@ typedef struct
 {
 	B1_FN fn;
 	B1_T_PROG_LINE_CNT def_line_cnt;
+	// zero RPN length stands for FUNCTION ... END FUNCTION procedure
 	B1_T_INDEX rpn_start_pos;
 	B1_T_INDEX rpn_len;
+#ifdef B1_FEATURE_FUNCTIONS_USER_MEMO
+	// B1_UDEF_FN_PURE and B1_UDEF_FN_MEMO flags
+	uint8_t memo;
+#endif
+#ifdef B1_FEATURE_STMT_FUNCTION
+	// END FUNCTION line counter and argument names (arguments are local variables)
+	B1_T_PROG_LINE_CNT end_line_cnt;
+	B1_T_IDHASH arg_hashes[B1_MAX_FN_ARGS_NUM];
+#ifdef B1_FEATURE_DEBUG
+	B1_T_INDEX arg_offsets[B1_MAX_FN_ARGS_NUM];
+	B1_T_INDEX arg_lengths[B1_MAX_FN_ARGS_NUM];
+#endif
+#endif
 } B1_UDEF_FN;
 
-// structure to represent user defined function call stack
+#ifdef B1_FEATURE_FUNCTIONS_USER_MEMO
+// the function uses only arguments, constants and deterministic functions
+#define B1_UDEF_FN_PURE ((uint8_t)0x1)
+// pure function with numeric arguments and result, the results are cached
+#define B1_UDEF_FN_MEMO ((uint8_t)0x2)
+
+// pure function results cache record
+typedef struct
+{
+	uint8_t busy;
+	B1_T_IDHASH name_hash;
+	B1_VAR args[B1_MAX_FN_ARGS_NUM];
+	B1_VAR result;
+} B1_UDEF_MEMO_REC;
+#endif
+
+// stack of records kept in a memory block that grows on demand (user defined function call frames)
+typedef struct
+{
+	B1_T_MEM_BLOCK_DESC mem_desc;
+	B1_T_MEMOFFSET size;
+	B1_T_MEMOFFSET top;
+} B1_FN_STACK;
+
+// structure to represent user defined function call stack record
 typedef struct
 {
-	// previous program line counter
-	B1_T_PROG_LINE_CNT prev_line_cnt;
 	// previous RPN pointer and index
 	const B1_RPNREC *prev_rpn;
 	B1_T_INDEX prev_rpn_end;
@@ -108,6 +186,11 @@ typedef struct
 	// argument count and return type of the current function
 	uint8_t curr_arg_num;
 	uint8_t curr_ret_type;
+#ifdef B1_FEATURE_FUNCTIONS_USER_MEMO
+	// the function result should be cached
+	uint8_t curr_memo;
+	B1_T_IDHASH curr_name_hash;
+#endif
 } B1_UDEF_CALL;
 #endif
 
@@ -115,8 +198,35 @@ typedef struct
 #ifdef B1_FEATURE_FUNCTIONS_USER
 extern B1_T_INDEX b1_fn_udef_fn_rpn_off;
 extern B1_RPNREC b1_fn_udef_fn_rpn[B1_MAX_UDEF_FN_RPN_LEN];
+// text of user defined function expression constants, b1_progline points to it when a function is evaluated
+extern B1_T_INDEX b1_fn_udef_fn_text_off;
+extern B1_T_CHAR b1_fn_udef_fn_text[B1_MAX_UDEF_FN_TEXT_LEN];
 // user defined function call stack
-extern B1_UDEF_CALL b1_fn_udef_call_stack[B1_MAX_UDEF_CALL_NEST_DEPTH];
+extern B1_FN_STACK b1_fn_udef_call_stack;
+
+extern void b1_fn_stack_init(B1_FN_STACK *stack);
+extern B1_T_ERROR b1_fn_stack_push(B1_FN_STACK *stack, const void *data, B1_T_MEMOFFSET size);
+extern B1_T_ERROR b1_fn_stack_pop(B1_FN_STACK *stack, void *data, B1_T_MEMOFFSET size);
+extern B1_T_ERROR b1_fn_stack_read(const B1_FN_STACK *stack, B1_T_MEMOFFSET offset, void *data, B1_T_MEMOFFSET size);
+#endif
+
+#ifdef B1_FEATURE_FUNCTIONS_USER_MEMO
+// pure functions results cache hit and miss counters
+extern uint32_t b1_fn_udef_memo_hits;
+extern uint32_t b1_fn_udef_memo_misses;
+
+extern void b1_fn_udef_memo_init();
+extern uint8_t b1_fn_udef_memo_get(B1_T_IDHASH name_hash, const B1_VAR *args, uint8_t argnum, B1_VAR *result);
+extern void b1_fn_udef_memo_put(B1_T_IDHASH name_hash, const B1_VAR *args, uint8_t argnum, const B1_VAR *result);
+extern uint8_t b1_fn_bltin_is_pure(const B1_FN *fn);
+#endif
+
+#ifdef B1_FEATURE_BLTIN_FN_BINDING
+// built-in function index value for identifiers that are not built-in functions
+#define B1_FN_BLTIN_NONE ((uint8_t)0xFF)
+
+extern uint8_t b1_fn_bltin_get_index(B1_T_IDHASH name_hash);
+extern B1_FN *b1_fn_bltin_get(uint8_t index);
 #endif
 
 #ifdef B1_FEATURE_FUNCTIONS_USER
@@ -26,6 +26,9 @@ static const uint8_t b1_id_stmts[] =
 	B1_ID_STMT_GET,
 #endif
 	B1_ID_STMT_LET,
+#ifdef B1_FEATURE_STMT_MAT
+	B1_ID_STMT_MAT,
+#endif
 #ifdef B1_FEATURE_STMT_PUT_GET
 	B1_ID_STMT_PUT,
 #endif
@@ -36,10 +39,19 @@ static const uint8_t b1_id_stmts[] =
 #endif
 	B1_ID_STMT_ELSE,
 	B1_ID_STMT_GOTO,
+#ifdef B1_FEATURE_STMT_FILE
+	B1_ID_STMT_LINE,
+#endif
 	B1_ID_STMT_NEXT,
+#ifdef B1_FEATURE_STMT_FILE
+	B1_ID_STMT_OPEN,
+#endif
 #ifdef B1_FEATURE_STMT_DATA_READ
 	B1_ID_STMT_READ,
 #endif
+#ifdef B1_FEATURE_STMT_SORT
+	B1_ID_STMT_SORT,
+#endif
 #ifdef B1_FEATURE_STMT_STOP
 	B1_ID_STMT_STOP,
 #endif
@@ -54,6 +66,9 @@ static const uint8_t b1_id_stmts[] =
 #ifdef B1_FEATURE_STMT_BREAK_CONTINUE
 	B1_ID_STMT_BREAK,
 #endif
+#ifdef B1_FEATURE_STMT_FILE
+	B1_ID_STMT_CLOSE,
+#endif
 #ifdef B1_FEATURE_STMT_ERASE
 	B1_ID_STMT_ERASE,
 #endif
@@ -76,8 +91,14 @@ static const uint8_t b1_id_stmts[] =
 #ifdef B1_FRACTIONAL_TYPE_EXISTS
 	B1_ID_STMT_RANDOMIZE,
 #endif
+#endif
+#ifdef B1_FEATURE_TYPE_MAP
+	B1_ID_STMT_DELETE,
 #endif
 	B1_ID_STMT_ELSEIF,
+#ifdef B1_FEATURE_STMT_FUNCTION
+	B1_ID_STMT_FUNCTION,
+#endif
 };
 
 static const B1_T_IDHASH b1_id_stmt_hashes[] =
@@ -94,6 +115,9 @@ static const B1_T_IDHASH b1_id_stmt_hashes[] =
 	0x79ee7,
 #endif
 	0x7b9a4,
+#ifdef B1_FEATURE_STMT_MAT
+	0x7be69,
+#endif
 #ifdef B1_FEATURE_STMT_PUT_GET
 	0x7d158,
 #endif
@@ -104,10 +128,19 @@ static const B1_T_IDHASH b1_id_stmt_hashes[] =
 #endif
 	0x1189158,
 	0x11a2d4c,
+#ifdef B1_FEATURE_STMT_FILE
+	0x11de99f,
+#endif
 	0x11f6176,
+#ifdef B1_FEATURE_STMT_FILE
+	0x1205f61,
+#endif
 #ifdef B1_FEATURE_STMT_DATA_READ
 	0x1227587,
 #endif
+#ifdef B1_FEATURE_STMT_SORT
+	0x1237363,
+#endif
 #ifdef B1_FEATURE_STMT_STOP
 	0x1238dad,
 #endif
@@ -122,6 +155,9 @@ static const B1_T_IDHASH b1_id_stmt_hashes[] =
 #ifdef B1_FEATURE_STMT_BREAK_CONTINUE
 	0x283b8f0c,
 #endif
+#ifdef B1_FEATURE_STMT_FILE
+	0x2853bcdd,
+#endif
 #ifdef B1_FEATURE_STMT_ERASE
 	0x2891470f,
 #endif
@@ -144,8 +180,14 @@ static const B1_T_IDHASH b1_id_stmt_hashes[] =
 #ifdef B1_FRACTIONAL_TYPE_EXISTS
 	0x90d4c874,
 #endif
+#endif
+#ifdef B1_FEATURE_TYPE_MAP
+	0xd7719e4a,
 #endif
 	0xdc614f2b,
+#ifdef B1_FEATURE_STMT_FUNCTION
+	0xea43aa09,
+#endif
 };
 #else
 static const uint8_t b1_id_stmts[] =
@@ -158,9 +200,15 @@ static const uint8_t b1_id_stmts[] =
 #endif
 	B1_ID_STMT_RETURN,
 	B1_ID_STMT_PRINT,
+#ifdef B1_FEATURE_STMT_FILE
+	B1_ID_STMT_CLOSE,
+#endif
 	B1_ID_STMT_OPTION,
 #ifdef B1_FEATURE_STMT_DATA_READ
 	B1_ID_STMT_DATA,
+#endif
+#ifdef B1_FEATURE_STMT_FILE
+	B1_ID_STMT_OPEN,
 #endif
 	B1_ID_STMT_NEXT,
 #ifdef B1_FEATURE_STMT_PUT_GET
@@ -177,11 +225,23 @@ static const uint8_t b1_id_stmts[] =
 #endif
 #ifdef B1_FEATURE_STMT_WHILE_WEND
 	B1_ID_STMT_WHILE,
+#endif
+#ifdef B1_FEATURE_STMT_MAT
+	B1_ID_STMT_MAT,
+#endif
+#ifdef B1_FEATURE_TYPE_MAP
+	B1_ID_STMT_DELETE,
 #endif
 	B1_ID_STMT_GOSUB,
 	B1_ID_STMT_END,
 #ifdef B1_FEATURE_STMT_BREAK_CONTINUE
 	B1_ID_STMT_CONTINUE,
+#endif
+#ifdef B1_FEATURE_STMT_SORT
+	B1_ID_STMT_SORT,
+#endif
+#ifdef B1_FEATURE_STMT_FUNCTION
+	B1_ID_STMT_FUNCTION,
 #endif
 	B1_ID_STMT_SET,
 	B1_ID_STMT_GOTO,
@@ -209,6 +269,9 @@ static const uint8_t b1_id_stmts[] =
 #endif
 	B1_ID_STMT_LET,
 	B1_ID_STMT_FOR,
+#ifdef B1_FEATURE_STMT_FILE
+	B1_ID_STMT_LINE,
+#endif
 	B1_ID_STMT_REM,
 	B1_ID_STMT_ELSE,
 #ifdef B1_FEATURE_STMT_PUT_GET
@@ -226,9 +289,15 @@ static const B1_T_IDHASH b1_id_stmt_hashes[] =
 #endif
 	0x104e,
 	0x10ac,
+#ifdef B1_FEATURE_STMT_FILE
+	0x11ad,
+#endif
 	0x129e,
 #ifdef B1_FEATURE_STMT_DATA_READ
 	0x2710,
+#endif
+#ifdef B1_FEATURE_STMT_FILE
+	0x30d7,
 #endif
 	0x31fd,
 #ifdef B1_FEATURE_STMT_PUT_GET
@@ -245,11 +314,23 @@ static const B1_T_IDHASH b1_id_stmt_hashes[] =
 #endif
 #ifdef B1_FEATURE_STMT_WHILE_WEND
 	0x5087,
+#endif
+#ifdef B1_FEATURE_STMT_MAT
+	0x551e,
+#endif
+#ifdef B1_FEATURE_TYPE_MAP
+	0x5587,
 #endif
 	0x6119,
 	0x65af,
 #ifdef B1_FEATURE_STMT_BREAK_CONTINUE
 	0x68be,
+#endif
+#ifdef B1_FEATURE_STMT_SORT
+	0x6a37,
+#endif
+#ifdef B1_FEATURE_STMT_FUNCTION
+	0x7b05,
 #endif
 	0x7c57,
 	0x7edc,
@@ -277,6 +358,9 @@ static const B1_T_IDHASH b1_id_stmt_hashes[] =
 #endif
 	0xe092,
 	0xef5d,
+#ifdef B1_FEATURE_STMT_FILE
+	0xf64a,
+#endif
 	0xf7b2,
 	0xf7fa,
 #ifdef B1_FEATURE_STMT_PUT_GET
@@ -348,8 +432,10 @@ B1_T_IDHASH b1_id_calc_hash(const B1_T_CHAR *data, B1_T_INDEX data_size)
 	uint8_t b;
 	B1_T_IDHASH hash;
 	B1_T_INDEX i;
+	uint16_t n;
 
 	hash = 0xFFFF;
+	n = 0;
 
 	do
 	{
@@ -373,7 +459,14 @@ B1_T_IDHASH b1_id_calc_hash(const B1_T_CHAR *data, B1_T_INDEX data_size)
 			hash += b;
 		}
 
-	} while((uint8_t)(hash >> 8) == 0);
+	} while((uint8_t)(hash >> 8) == 0 && ++n <= 256);
+
+	// there are only 256 values with zero high byte, so 257 passes without getting out of the range mean
+	// that the values repeat endlessly (can happen with string constants hashed by tokenizer)
+	if((uint8_t)(hash >> 8) == 0)
+	{
+		hash |= 0x100;
+	}
 
 	return hash;
 }
@@ -35,6 +35,13 @@
 
 #define B1_IDENT_TEST_FLAGS_FN_BLTIN(FLAGS) (((uint8_t)(FLAGS)) & B1_IDENT_FLAGS_FN_BLTIN)
 
+#ifdef B1_FEATURE_TYPE_MAP
+// map variable (B1_IDENT_FLAGS_SET_VAR(1) | B1_IDENT_FLAGS_VAR_MAP), the only subscript is a key
+#define B1_IDENT_FLAGS_VAR_MAP ((uint8_t)0x40)
+
+#define B1_IDENT_TEST_FLAGS_VAR_MAP(FLAGS) (((uint8_t)(FLAGS)) & B1_IDENT_FLAGS_VAR_MAP)
+#endif
+
 #define B1_IDENT_FLAGS_SET_FN(ARGNUM, BLTIN) ((B1_IDENT_FLAGS_BUSY) | ((((uint8_t)(ARGNUM)) << B1_IDENT_FLAGS_ARGNUM_SHIFT) & B1_IDENT_FLAGS_ARGNUM_MASK) | ((BLTIN) ? B1_IDENT_FLAGS_FN_BLTIN : (uint8_t)0))
 
 #define B1_ID_STMT_UNKNOWN ((uint8_t)0xFF)
@@ -95,6 +102,23 @@
 #define B1_ID_STMT_GET ((uint8_t)0x1F)
 #define B1_ID_STMT_TRANSFER ((uint8_t)0x20)
 #endif
+#ifdef B1_FEATURE_STMT_MAT
+#define B1_ID_STMT_MAT ((uint8_t)0x21)
+#endif
+#ifdef B1_FEATURE_STMT_SORT
+#define B1_ID_STMT_SORT ((uint8_t)0x22)
+#endif
+#ifdef B1_FEATURE_TYPE_MAP
+#define B1_ID_STMT_DELETE ((uint8_t)0x23)
+#endif
+#ifdef B1_FEATURE_STMT_FUNCTION
+#define B1_ID_STMT_FUNCTION ((uint8_t)0x24)
+#endif
+#ifdef B1_FEATURE_STMT_FILE
+#define B1_ID_STMT_OPEN ((uint8_t)0x25)
+#define B1_ID_STMT_CLOSE ((uint8_t)0x26)
+#define B1_ID_STMT_LINE ((uint8_t)0x27)
+#endif
 
 
 typedef struct
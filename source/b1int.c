@@ -29,6 +29,28 @@
 #define B1_INT_ST_INPUT_PROMPT_PRINTED ((uint8_t)0x1)
 #define B1_INT_ST_INPUT_PROMPT_CUSTOM ((uint8_t)0x2)
 
+#ifdef B1_FEATURE_STMT_MAT
+#define B1_INT_MAT_OP_ZER ((uint8_t)0x0)
+#define B1_INT_MAT_OP_CON ((uint8_t)0x1)
+#define B1_INT_MAT_OP_IDN ((uint8_t)0x2)
+#define B1_INT_MAT_OP_RND ((uint8_t)0x3)
+// operations with source arrays
+#define B1_INT_MAT_OP_COPY ((uint8_t)0x4)
+#define B1_INT_MAT_OP_ADD ((uint8_t)0x5)
+#define B1_INT_MAT_OP_SUB ((uint8_t)0x6)
+#define B1_INT_MAT_OP_SCALE ((uint8_t)0x7)
+#define B1_INT_MAT_OP_MUL ((uint8_t)0x8)
+#define B1_INT_MAT_OP_TRN ((uint8_t)0x9)
+
+#define B1_INT_MAT_BUF_LEN ((B1_T_MEMOFFSET)(B1_MAT_TILE_SIZE * B1_MAT_TILE_SIZE))
+#endif
+
+#ifdef B1_FEATURE_STMT_SORT
+// ranges shorter than the value are sorted with insertion sort
+#define B1_INT_SORT_INSERTION_LEN ((B1_T_MEMOFFSET)16)
+#define B1_INT_SORT_STACK_LEN (sizeof(B1_T_MEMOFFSET) * 8)
+#endif
+
 
 // global data
 // current statement state (some statements have execution states)
@@ -44,6 +66,13 @@ uint8_t b1_int_print_zone_width;
 static uint8_t b1_int_print_zone_num;
 uint8_t b1_int_print_curr_pos;
 
+#ifdef B1_FEATURE_STMT_FILE
+// file channel the PRINT statement writes to (0 stands for the console) and print positions of the channels
+// (the first element keeps the console print position while a file is being printed to)
+static uint8_t b1_int_print_chan;
+static uint8_t b1_int_print_chan_pos[B1_MAX_FILE_CHAN_NUM + 1];
+#endif
+
 // echo input
 uint8_t b1_int_input_echo;
 
@@ -51,6 +80,32 @@ uint8_t b1_int_input_echo;
 uint8_t b1_int_exec_stop;
 #endif
 
+#ifdef B1_FEATURE_STMT_MAT
+// MAT statement tiles: two source tiles and destination (accumulator) tile
+static B1_T_ARRAY_VAL b1_int_mat_buf[3][B1_MAT_TILE_SIZE * B1_MAT_TILE_SIZE];
+#endif
+
+#ifdef B1_FEATURE_STMT_SORT
+// SORT statement arrays and the key to compare elements with
+static B1_VAR_ARRAY_INFO b1_int_sort_arrs[B1_MAX_SORT_ARR_NUM];
+static uint8_t b1_int_sort_arr_num;
+static B1_T_ARRAY_VAL b1_int_sort_key;
+#endif
+
+#ifdef B1_FEATURE_STMT_FUNCTION
+// FUNCTION call nesting level
+static uint8_t b1_int_fn_depth;
+// the first statement stack record available to the function being executed
+static B1_T_INDEX b1_int_stmt_stack_base;
+// caller contexts and variables hidden by local variables of the functions being executed
+static B1_FN_STACK b1_int_fn_stack;
+// offset of the first local variable record of the function being executed
+static B1_T_MEMOFFSET b1_int_fn_locals_base;
+// 1 - RETURN <expression> statement is executed (b1_int_fn_ret_val is the value to return), 2 - END FUNCTION
+static uint8_t b1_int_fn_ret;
+static B1_VAR b1_int_fn_ret_val;
+#endif
+
 #ifdef B1_FEATURE_DEBUG
 static uint8_t b1_int_continue_after_break;
 #endif
@@ -59,18 +114,39 @@ static uint8_t b1_int_continue_after_break;
 // initializes or resets interpreter
 B1_T_ERROR b1_int_reset()
 {
-#ifdef B1_FEATURE_INIT_FREE_MEMORY
+#if defined(B1_FEATURE_INIT_FREE_MEMORY) || defined(B1_FEATURE_STMT_FILE)
 	B1_T_ERROR err;
+#endif
+#if defined(B1_FEATURE_INIT_FREE_MEMORY) && !defined(B1_FEATURE_MEM_FREE_ALL)
 	B1_NAMED_VAR *var;
 
 	var = NULL;
 #endif
 
+#ifdef B1_FEATURE_STMT_FILE
+	// close files left open by the preceding program execution
+	err = b1_ex_file_close(0);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	b1_int_print_chan = 0;
+#endif
+
 	b1_reset();
 
 	b1_int_curr_stmt_state = 0;
 
 #ifdef B1_FEATURE_INIT_FREE_MEMORY
+#ifdef B1_FEATURE_MEM_FREE_ALL
+	// free all memory blocks allocated during the preceding program execution at once
+	err = b1_ex_mem_free_all();
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+#else
 	while(1)
 	{
 		b1_ex_var_enum(&var);
@@ -86,15 +162,49 @@ B1_T_ERROR b1_int_reset()
 			return err;
 		}
 	}
+
+#ifdef B1_FEATURE_FUNCTIONS_USER
+	// free user defined function call stacks
+	if(b1_fn_udef_call_stack.mem_desc != B1_T_MEM_BLOCK_DESC_INVALID)
+	{
+		b1_ex_mem_free(b1_fn_udef_call_stack.mem_desc);
+	}
+#ifdef B1_FEATURE_STMT_FUNCTION
+	if(b1_int_fn_stack.mem_desc != B1_T_MEM_BLOCK_DESC_INVALID)
+	{
+		b1_ex_mem_free(b1_int_fn_stack.mem_desc);
+	}
+#endif
+#endif
+#endif
 #endif
 
 	// clear variables cache
 	b1_ex_var_init();
 
+#ifdef B1_FEATURE_VAR_SLOTS
+	// slots are assigned again by b1_int_prerun function
+	b1_var_slot_init();
+#endif
+
 #ifdef B1_FEATURE_FUNCTIONS_USER
 	// clear user functions
 	b1_fn_udef_fn_rpn_off = 0;
+	b1_fn_udef_fn_text_off = 0;
 	b1_ex_ufn_init();
+	b1_fn_stack_init(&b1_fn_udef_call_stack);
+#endif
+
+#ifdef B1_FEATURE_FUNCTIONS_USER_MEMO
+	b1_fn_udef_memo_init();
+#endif
+
+#ifdef B1_FEATURE_STMT_FUNCTION
+	b1_fn_stack_init(&b1_int_fn_stack);
+	b1_int_fn_depth = 0;
+	b1_int_stmt_stack_base = 0;
+	b1_int_fn_locals_base = 0;
+	b1_int_fn_ret = 0;
 #endif
 
 	// reset statements call stack
@@ -221,6 +331,7 @@ static B1_T_ERROR b1_int_st_let(B1_T_INDEX offset, B1_VAR_REF *dst_var_ref, cons
 	return B1_RES_OK;
 }
 
+#if !defined(B1_FEATURE_IO_PRINT_STR) || !defined(B1_FEATURE_IO_INPUT_LINE)
 static B1_T_ERROR b1_int_print_char(B1_T_CHAR c)
 {
 	B1_T_ERROR err;
@@ -244,12 +355,19 @@ static B1_T_ERROR b1_int_print_char(B1_T_CHAR c)
 
 	return B1_RES_OK;
 }
+#endif
 
 static B1_T_ERROR b1_int_print_newline()
 {
 	B1_T_ERROR err;
+#ifdef B1_FEATURE_STMT_FILE
+	B1_T_CHAR c;
 
+	c = B1_T_C_LF;
+	err = (b1_int_print_chan == 0) ? b1_ex_io_print_newline() : b1_ex_file_write(b1_int_print_chan, &c, 1);
+#else
 	err = b1_ex_io_print_newline();
+#endif
 	if(err != B1_RES_OK)
 	{
 		return err;
@@ -263,8 +381,66 @@ static B1_T_ERROR b1_int_print_newline()
 static B1_T_ERROR b1_int_print_str(const B1_T_CHAR *sdata, B1_T_INDEX slen)
 {
 	B1_T_ERROR err;
+#ifdef B1_FEATURE_IO_PRINT_STR
+	B1_T_INDEX n;
+#else
 	B1_T_CHAR c;
+#endif
+#ifdef B1_FEATURE_STMT_FILE
+	uint16_t pos;
+#endif
+
+#ifdef B1_FEATURE_STMT_FILE
+	if(b1_int_print_chan != 0)
+	{
+		// files have no print margin, the position is used for print zones and TAB function only
+		err = b1_ex_file_write(b1_int_print_chan, sdata, slen);
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
+
+		pos = (uint16_t)(b1_int_print_curr_pos + slen);
+		b1_int_print_curr_pos = (pos > UINT8_MAX) ? (uint8_t)UINT8_MAX : (uint8_t)pos;
+
+		return B1_RES_OK;
+	}
+#endif
+
+#ifdef B1_FEATURE_IO_PRINT_STR
+	// print position is checked once per run of characters fitting the current line
+	while(slen)
+	{
+		n = b1_int_print_margin - b1_int_print_curr_pos;
+		if(n > slen)
+		{
+			n = slen;
+		}
+
+		err = b1_ex_io_print_str(sdata, n);
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
 
+		if(sdata != NULL)
+		{
+			sdata += n;
+		}
+		slen -= n;
+
+		b1_int_print_curr_pos += (uint8_t)n;
+		if(b1_int_print_curr_pos == b1_int_print_margin)
+		{
+			err = b1_ex_io_print_margin_newline();
+			if(err != B1_RES_OK)
+			{
+				return err;
+			}
+			b1_int_print_curr_pos = 0;
+		}
+	}
+#else
 	for(; slen; slen--)
 	{
 		c = (sdata == NULL) ? B1_T_C_SPACE : (*sdata++);
@@ -275,15 +451,112 @@ static B1_T_ERROR b1_int_print_str(const B1_T_CHAR *sdata, B1_T_INDEX slen)
 			return err;
 		}
 	}
+#endif
+
+	return B1_RES_OK;
+}
+
+// moves the current print position to the beginning of the next print zone
+static B1_T_ERROR b1_int_print_next_zone()
+{
+	uint8_t next_print_zone;
+	B1_T_INDEX len;
+
+	// calculate next print zone number (zero based)
+	next_print_zone = b1_int_print_curr_pos / b1_int_print_zone_width;
+	len = next_print_zone * b1_int_print_zone_width;
+	if(len != b1_int_print_curr_pos)
+	{
+		len += b1_int_print_zone_width;
+		next_print_zone++;
+	}
+
+	if(next_print_zone >= b1_int_print_zone_num
+#ifdef B1_FEATURE_STMT_FILE
+		&& b1_int_print_chan == 0
+#endif
+		)
+	{
+		return b1_int_print_newline();
+	}
+
+	if(b1_int_print_curr_pos < len)
+	{
+		return b1_int_print_str(NULL, len - b1_int_print_curr_pos);
+	}
+
+	return B1_RES_OK;
+}
+
+// converts b1_rpn_eval[0] value to string, returns pointer to the string data (in b1_tmp_buf) and its length,
+// numeric values get leading (for non-negative values) and trailing spaces
+static B1_T_ERROR b1_int_print_get_value_str(B1_T_CHAR **sdata, B1_T_INDEX *len)
+{
+	B1_T_ERROR err;
+	uint8_t numeric;
+
+	numeric = B1_TYPE_TEST_NUMERIC(b1_rpn_eval[0].type);
+
+	// convert value to string
+	err = b1_var_convert(b1_rpn_eval, B1_TYPE_STRING);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	// b1_var_var2str function frees memory used by string after copying it to output buffer
+	err = b1_var_var2str(b1_rpn_eval, b1_tmp_buf);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	*len = *b1_tmp_buf;
+	*sdata = b1_tmp_buf + 1;
+
+	if(numeric)
+	{
+		// add leading space if necessary
+		if(!B1_T_ISMINUS(**sdata))
+		{
+			(*sdata)--;
+			**sdata = B1_T_C_SPACE;
+			(*len)++;
+		}
+		// add trailing space
+		*(*sdata + *len) = B1_T_C_SPACE;
+		(*len)++;
+	}
 
 	return B1_RES_OK;
 }
 
+// prints a string (or N spaces if sdata is NULL) moving to the next line first if the string does not fit
+static B1_T_ERROR b1_int_print_str_wrap(const B1_T_CHAR *sdata, B1_T_INDEX slen)
+{
+	B1_T_ERROR err;
+
+	if(slen > b1_int_print_margin - b1_int_print_curr_pos
+#ifdef B1_FEATURE_STMT_FILE
+		&& b1_int_print_chan == 0
+#endif
+		)
+	{
+		err = b1_int_print_newline();
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
+	}
+
+	return b1_int_print_str(sdata, slen);
+}
+
 // interpret PRINT statement
 static B1_T_ERROR b1_int_st_print(B1_T_INDEX offset)
 {
 	B1_T_ERROR err;
-	uint8_t numeric, next_print_zone, newline;
+	uint8_t next_print_zone, newline;
 	B1_T_INDEX len;
 	B1_T_CHAR *sdata;
 
@@ -303,34 +576,10 @@ static B1_T_ERROR b1_int_st_print(B1_T_INDEX offset)
 		if(next_print_zone)
 		{
 			// go to the next print zone
-			// calculate next print zone number (zero based)
-			next_print_zone = b1_int_print_curr_pos / b1_int_print_zone_width;
-			len = next_print_zone * b1_int_print_zone_width;
-			if(len != b1_int_print_curr_pos)
-			{
-				len += b1_int_print_zone_width;
-				next_print_zone++;
-			}
-
-			if(next_print_zone >= b1_int_print_zone_num)
-			{
-				err = b1_int_print_newline();
-				if(err != B1_RES_OK)
-				{
-					return err;
-				}
-			}
-			else
+			err = b1_int_print_next_zone();
+			if(err != B1_RES_OK)
 			{
-				if(b1_int_print_curr_pos < len)
-				{
-					len -= b1_int_print_curr_pos;
-					err = b1_int_print_str(NULL, len);
-					if(err != B1_RES_OK)
-					{
-						return err;
-					}
-				}
+				return err;
 			}
 		}
 
@@ -356,8 +605,6 @@ static B1_T_ERROR b1_int_st_print(B1_T_INDEX offset)
 		{
 			sdata = NULL;
 
-			numeric = B1_TYPE_TEST_NUMERIC(b1_rpn_eval[0].type);
-
 			if(B1_TYPE_TEST_TAB_FN(b1_rpn_eval[0].type))
 			{
 				len = (uint8_t)b1_rpn_eval[0].value.i32val;
@@ -391,41 +638,7 @@ static B1_T_ERROR b1_int_st_print(B1_T_INDEX offset)
 			}
 			else
 			{
-				// convert value to string
-				err = b1_var_convert(b1_rpn_eval, B1_TYPE_STRING);
-				if(err != B1_RES_OK)
-				{
-					return err;
-				}
-
-				// b1_var_var2str function frees memory used by string after copying it to output buffer
-				err = b1_var_var2str(b1_rpn_eval, b1_tmp_buf);
-				if(err != B1_RES_OK)
-				{
-					return err;
-				}
-
-				len = *b1_tmp_buf;
-				sdata = b1_tmp_buf + 1;
-			}
-
-			if(numeric)
-			{
-				// add leading space if necessary
-				if(!B1_T_ISMINUS(*sdata))
-				{
-					sdata--;
-					*sdata = B1_T_C_SPACE;
-					len++;
-				}
-				// add trailing space
-				*(sdata + len) = B1_T_C_SPACE;
-				len++;
-			}
-
-			if(len > b1_int_print_margin - b1_int_print_curr_pos)
-			{
-				err = b1_int_print_newline();
+				err = b1_int_print_get_value_str(&sdata, &len);
 				if(err != B1_RES_OK)
 				{
 					return err;
@@ -433,7 +646,7 @@ static B1_T_ERROR b1_int_st_print(B1_T_INDEX offset)
 			}
 
 			// print value
-			err = b1_int_print_str(sdata, len);
+			err = b1_int_print_str_wrap(sdata, len);
 			if(err != B1_RES_OK)
 			{
 				return err;
@@ -460,8 +673,25 @@ static B1_T_ERROR b1_int_st_print(B1_T_INDEX offset)
 static B1_T_ERROR b1_int_input_line(B1_T_CHAR *sbuf, B1_T_INDEX buflen)
 {
 	B1_T_ERROR err;
-	B1_T_CHAR c;
 	B1_T_INDEX i;
+#ifdef B1_FEATURE_IO_INPUT_LINE
+	// the whole line is read and echoed at once
+	*sbuf = 0;
+
+	err = b1_ex_io_input_line(sbuf, buflen - 1, &i);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	*(sbuf + i) = 0;
+
+	if(b1_int_input_echo)
+	{
+		err = b1_int_print_str(sbuf, i);
+	}
+#else
+	B1_T_CHAR c;
 
 	err = B1_RES_OK;
 
@@ -496,6 +726,7 @@ static B1_T_ERROR b1_int_input_line(B1_T_CHAR *sbuf, B1_T_INDEX buflen)
 	{
 		err = B1_RES_OK;
 	}
+#endif
 
 	if(err == B1_RES_OK)
 	{
@@ -808,86 +1039,193 @@ static B1_T_ERROR b1_int_st_input(B1_T_INDEX offset)
 	return err;
 }
 
-#ifdef B1_FEATURE_STMT_DATA_READ
-static B1_T_ERROR b1_int_read_next_field(uint8_t *options)
+#ifdef B1_FEATURE_STMT_FILE
+// gets optional file channel number (#<n> token), *chan is set to 0 if the next token is not a channel number.
+// if comma is non-zero the channel number must be followed by comma (it is skipped too)
+static B1_T_ERROR b1_int_get_chan(B1_T_INDEX *offset, uint8_t comma, uint8_t *chan)
 {
-	B1_T_ERROR err, err1;
-	B1_T_PROG_LINE_CNT read_line_cnt;
-
-	read_line_cnt = b1_curr_prog_line_cnt;
+	B1_T_ERROR err;
+	B1_TOKENDATA td;
+	B1_T_INDEX i;
+	B1_T_CHAR c;
+	uint16_t n;
 
-	// b1_data_curr_line_cnt == 0 stands for the initial state, b1_data_curr_line_offset == 0 means the need to
-	// go to the next DATA statement line
-	if(b1_data_curr_line_cnt == 0 || b1_data_curr_line_offset == 0)
-	{
-		err = b1_ex_prg_data_go_next(b1_data_curr_line_cnt == 0 ? B1_T_LINE_NUM_FIRST : B1_T_LINE_NUM_NEXT);
-		if(err != B1_RES_OK)
-		{
-			return err;
-		}
-	}
+	*chan = 0;
 
-	// switch to DATA line
-	b1_curr_prog_line_cnt = b1_data_curr_line_cnt - 1;
-	err = b1_ex_prg_get_prog_line(B1_T_LINE_NUM_NEXT);
+	err = b1_tok_get(*offset, 0, &td);
 	if(err != B1_RES_OK)
 	{
 		return err;
 	}
 
-	err1 = b1_int_input_read_get_value(1, &b1_data_curr_line_offset, options);
-	if(err1 == B1_RES_OK && ((*options) & B1_INT_READ_VALUE_LAST))
+	// empty token type is B1_TOKEN_TYPE_SKIP_SPACES having the same value as B1_TOKEN_TYPE_DEVNAME
+	if(td.length == 0 || !(td.type & B1_TOKEN_TYPE_DEVNAME))
 	{
-		// go to the next DATA statement line when reading the next value
-		b1_data_curr_line_offset = 0;
+		return B1_RES_OK;
 	}
 
-	// restore READ line
-	b1_curr_prog_line_cnt = read_line_cnt - 1;
-	err = b1_ex_prg_get_prog_line(B1_T_LINE_NUM_NEXT);
-	if(err != B1_RES_OK)
+	n = 0;
+
+	for(i = 0; i < td.length; i++)
 	{
-		return err;
+		c = *(b1_progline + td.offset + i);
+
+		if(!B1_T_ISDIGIT(c) || n > B1_MAX_FILE_CHAN_NUM)
+		{
+			return B1_RES_EINVARG;
+		}
+
+		n = n * 10 + (c - B1_T_C_0);
 	}
 
-	return err1;
-}
+	if(n == 0 || n > B1_MAX_FILE_CHAN_NUM)
+	{
+		return B1_RES_EINVARG;
+	}
 
-static B1_T_ERROR b1_int_st_read(B1_T_INDEX offset)
-{
-	B1_T_ERROR err;
-	uint8_t options;
-	B1_VAR_REF var_ref;
+	*offset = td.offset + td.length;
 
-	// process READ statement arguments
-	for(; ; offset++)
+	if(comma)
 	{
-		// build RPN for every READ statement argument
-		err = b1_rpn_build(offset, INPUT_STOP_TOKEN, &offset);
+		err = b1_tok_get(*offset, 0, &td);
 		if(err != B1_RES_OK)
 		{
 			return err;
 		}
-		if(b1_rpn[0].flags == 0)
+
+		if(td.length != 1 || !B1_T_ISCOMMA(b1_progline[td.offset]))
 		{
-			// READ statement without arguments
 			return B1_RES_ESYNTAX;
 		}
 
-		// evaluate the expression part
-		err = b1_eval(0, &var_ref);
-		if(err != B1_RES_OK)
-		{
-			return err;
-		}
+		*offset = td.offset + 1;
+	}
 
-		options = 0;
-		// read value
-		err = b1_int_read_next_field(&options);
-		if(err != B1_RES_OK)
-		{
-			return err;
-		}
+	*chan = (uint8_t)n;
+
+	return B1_RES_OK;
+}
+
+// reads the next line of the file (or user input if chan is 0) and returns it as C string
+static B1_T_ERROR b1_int_input_chan_line(uint8_t chan, B1_T_CHAR *sbuf, B1_T_INDEX buflen)
+{
+	B1_T_ERROR err;
+	B1_T_INDEX len;
+
+	if(chan == 0)
+	{
+		return b1_int_input_line(sbuf, buflen);
+	}
+
+	err = b1_ex_file_read_line(chan, sbuf, buflen - 1, &len);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	*(sbuf + len) = 0;
+
+	return B1_RES_OK;
+}
+
+// interpret PRINT statement with optional file channel number: PRINT [#<n>,] ...
+static B1_T_ERROR b1_int_st_print_file(B1_T_INDEX offset)
+{
+	B1_T_ERROR err;
+	uint8_t chan, prev_chan;
+
+	err = b1_int_get_chan(&offset, 1, &chan);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	prev_chan = b1_int_print_chan;
+
+	if(chan == prev_chan)
+	{
+		return b1_int_st_print(offset);
+	}
+
+	// every channel has its own print position (PRINT statement can be executed by a function called while
+	// printing to another channel)
+	b1_int_print_chan_pos[prev_chan] = b1_int_print_curr_pos;
+	b1_int_print_curr_pos = b1_int_print_chan_pos[chan];
+	b1_int_print_chan = chan;
+
+	err = b1_int_st_print(offset);
+
+	b1_int_print_chan_pos[chan] = b1_int_print_curr_pos;
+	b1_int_print_curr_pos = b1_int_print_chan_pos[prev_chan];
+	b1_int_print_chan = prev_chan;
+
+	return err;
+}
+
+// interpret INPUT statement with optional file channel number: INPUT [#<n>,] var1, var2..., varN. values are read
+// from the file the same way as from user input but the next line is read if the current one has no more values,
+// the rest of the line is ignored if there are more values than variables
+static B1_T_ERROR b1_int_st_input_file(B1_T_INDEX offset)
+{
+	B1_T_ERROR err;
+	uint8_t chan, options;
+	B1_T_INDEX values_offset;
+	const B1_T_CHAR *s;
+	B1_VAR_REF var_ref;
+
+	err = b1_int_get_chan(&offset, 1, &chan);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	if(chan == 0)
+	{
+		return b1_int_st_input(offset);
+	}
+
+	options = B1_INT_READ_VALUE_LAST;
+	values_offset = 0;
+
+	for(; ; offset++)
+	{
+		err = b1_rpn_build(offset, INPUT_STOP_TOKEN, &offset);
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
+		if(b1_rpn[0].flags == 0)
+		{
+			return B1_RES_ESYNTAX;
+		}
+
+		err = b1_eval(0, &var_ref);
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
+
+		if(options & B1_INT_READ_VALUE_LAST)
+		{
+			err = b1_int_input_chan_line(chan, b1_tmp_buf1, B1_TMP_BUF_LEN);
+			if(err != B1_RES_OK)
+			{
+				return err;
+			}
+
+			values_offset = 0;
+		}
+
+		// get next value
+		s = b1_progline;
+		b1_progline = b1_tmp_buf1;
+		err = b1_int_input_read_get_value(0, &values_offset, &options);
+		b1_progline = s;
+
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
 
 		err = b1_int_input_read_assign_value(options, &var_ref, NULL);
 		if(err != B1_RES_OK)
@@ -895,49 +1233,102 @@ static B1_T_ERROR b1_int_st_read(B1_T_INDEX offset)
 			return err;
 		}
 
-		if(!offset) break;
+		if(offset == 0)
+		{
+			break;
+		}
 	}
 
 	return B1_RES_OK;
 }
 
-// RESTORE statement: sets next DATA stamtement line counter on requested
-// line number, returns the line number in b1_next_line_num variable
-static B1_T_ERROR b1_int_st_restore(B1_T_INDEX offset)
+// interpret LINE INPUT statement: LINE INPUT [#<n>,] <str_var_name>, reads the whole line into the string variable
+static B1_T_ERROR b1_int_st_line_input(B1_T_INDEX offset)
 {
 	B1_T_ERROR err;
+	uint8_t chan;
+	B1_T_INDEX len;
 	B1_TOKENDATA td;
+	B1_VAR_REF var_ref;
 
-	// get restore line number
-	err = b1_tok_get_line_num(&offset);
+	err = b1_tok_get(offset, B1_TOK_CALC_HASH, &td);
 	if(err != B1_RES_OK)
 	{
 		return err;
 	}
 
-	err = b1_tok_get(offset, 0, &td);
+	if(!(td.type & B1_TOKEN_TYPE_IDNAME) || b1_id_get_stmt_by_hash(b1_tok_id_hash) != B1_ID_STMT_INPUT)
+	{
+		return B1_RES_ESYNTAX;
+	}
+
+	offset = td.offset + td.length;
+
+	err = b1_int_get_chan(&offset, 1, &chan);
 	if(err != B1_RES_OK)
 	{
 		return err;
 	}
 
-	if(td.length != 0)
+	err = b1_rpn_build(offset, NULL, NULL);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+	if(b1_rpn[0].flags == 0)
 	{
 		return B1_RES_ESYNTAX;
 	}
 
-	return b1_ex_prg_data_go_next(b1_next_line_num == B1_T_LINE_NUM_ABSENT ? B1_T_LINE_NUM_FIRST : b1_next_line_num);
+	err = b1_eval(0, &var_ref);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	if(B1_TYPE_GET((*var_ref.var).var.type) != B1_TYPE_STRING)
+	{
+		return B1_RES_ETYPMISM;
+	}
+
+	err = b1_int_input_chan_line(chan, b1_tmp_buf1, B1_TMP_BUF_LEN);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	// make string with length prefix
+	for(len = 0; *(b1_tmp_buf1 + len) != 0; len++)
+	{
+		if(len == B1_MAX_STRING_LEN)
+		{
+			return B1_RES_ESTRLONG;
+		}
+
+		*(b1_tmp_buf + len + 1) = *(b1_tmp_buf1 + len);
+	}
+
+	*b1_tmp_buf = (B1_T_CHAR)len;
+
+	// quoted string option preserves leading and trailing spaces
+	return b1_int_input_read_assign_value(B1_INT_READ_VALUE_QSTRING, &var_ref, NULL);
 }
-#endif
 
-static B1_T_ERROR b1_int_st_dim_get_size(B1_T_INDEX *offset, uint8_t allow_TO_stop_word, B1_T_SUBSCRIPT *size)
+// interpret OPEN statement: OPEN <file_name> FOR INPUT | OUTPUT | APPEND AS #<n>
+static B1_T_ERROR b1_int_st_open(B1_T_INDEX offset)
 {
 	B1_T_ERROR err;
+	uint8_t mode, chan;
+	B1_TOKENDATA td;
 
-	// "TO" stop token must be the first in DIM_STOP_TOKENS array
-	err = b1_rpn_build(*offset, allow_TO_stop_word ? DIM_STOP_TOKENS : (DIM_STOP_TOKENS + 1), offset);
-	if(err != B1_RES_OK) return err;
-	if(!offset || b1_rpn[0].flags == 0)
+	err = b1_rpn_build(offset, OPEN_STOP_TOKEN, &offset);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	// no file name or "FOR" keyword
+	if(b1_rpn[0].flags == 0 || offset == 0)
 	{
 		return B1_RES_ESYNTAX;
 	}
@@ -948,1304 +1339,3290 @@ static B1_T_ERROR b1_int_st_dim_get_size(B1_T_INDEX *offset, uint8_t allow_TO_st
 		return err;
 	}
 
-	err = b1_var_convert(b1_rpn_eval, B1_TYPE_INT);
+	if(!B1_TYPE_TEST_STRING(b1_rpn_eval[0].type))
+	{
+		return B1_RES_ETYPMISM;
+	}
+
+	err = b1_var_var2str(b1_rpn_eval, b1_tmp_buf1);
 	if(err != B1_RES_OK)
 	{
 		return err;
 	}
 
-	if(b1_rpn_eval[0].value.i32val < B1_T_SUBSCRIPT_MIN_VALUE || b1_rpn_eval[0].value.i32val > B1_T_SUBSCRIPT_MAX_VALUE)
+	// skip "FOR" keyword and get file mode
+	err = b1_tok_get(offset + 3, B1_TOK_CALC_HASH, &td);
+	if(err != B1_RES_OK)
 	{
-		return B1_RES_ESUBSRANGE;
+		return err;
 	}
 
-	*size = (B1_T_SUBSCRIPT)b1_rpn_eval[0].value.i32val;
+	if(!(td.type & B1_TOKEN_TYPE_IDNAME))
+	{
+		return B1_RES_ESYNTAX;
+	}
+
+	if(b1_id_get_stmt_by_hash(b1_tok_id_hash) == B1_ID_STMT_INPUT)
+	{
+		mode = B1_EX_FILE_INPUT;
+	}
+	else
+	if(!b1_t_strcmpi(_OUTPUT, b1_progline + td.offset, td.length))
+	{
+		mode = B1_EX_FILE_OUTPUT;
+	}
+	else
+	if(!b1_t_strcmpi(_APPEND, b1_progline + td.offset, td.length))
+	{
+		mode = B1_EX_FILE_APPEND;
+	}
+	else
+	{
+		return B1_RES_ESYNTAX;
+	}
+
+	err = b1_tok_get(td.offset + td.length, 0, &td);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	if(b1_t_strcmpi(_AS, b1_progline + td.offset, td.length))
+	{
+		return B1_RES_ESYNTAX;
+	}
+
+	offset = td.offset + td.length;
+
+	err = b1_int_get_chan(&offset, 0, &chan);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	if(chan == 0)
+	{
+		return B1_RES_ESYNTAX;
+	}
+
+	// no more tokens allowed
+	err = b1_tok_get(offset, 0, &td);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	if(td.length != 0)
+	{
+		return B1_RES_ESYNTAX;
+	}
+
+	err = b1_ex_file_open(chan, b1_tmp_buf1, mode);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	b1_int_print_chan_pos[chan] = 0;
 
 	return B1_RES_OK;
 }
 
-static B1_T_ERROR b1_int_st_dim(B1_T_INDEX offset)
+// interpret CLOSE statement: CLOSE [#<n1>[, #<n2>, ...#<nN>]], closes all files if no channel numbers specified
+static B1_T_ERROR b1_int_st_close(B1_T_INDEX offset)
 {
 	B1_T_ERROR err;
-	B1_T_CHAR c, ts_char;
-	uint8_t stop, type, dimsnum;
+	uint8_t chan;
 	B1_TOKENDATA td;
-	B1_T_INDEX len;
-	B1_T_SUBSCRIPT bound1, subs_bounds[B1_MAX_VAR_DIM_NUM * 2], *subs_bnds_ptr;
-	B1_T_IDHASH hash;
-#ifdef B1_FEATURE_DEBUG
-	B1_T_INDEX id_off, id_len;
-	B1_NAMED_VAR *var;
-#endif
+
+	err = b1_tok_get(offset, 0, &td);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	if(td.length == 0)
+	{
+		return b1_ex_file_close(0);
+	}
 
 	while(1)
 	{
-		// get variable name
-		err = b1_tok_get(offset, B1_TOK_CALC_HASH, &td);
+		err = b1_int_get_chan(&offset, 0, &chan);
 		if(err != B1_RES_OK)
 		{
 			return err;
 		}
 
-		if(!(td.type & B1_TOKEN_TYPE_IDNAME))
+		if(chan == 0)
 		{
-			return B1_RES_EINVTOK;
+			return B1_RES_ESYNTAX;
 		}
 
-		offset = td.offset;
-		len = td.length;
-
-#ifdef B1_FEATURE_DEBUG
-		id_off = offset;
-		id_len = len;
-#endif
-		offset += len;
-		type = B1_TYPE_NULL;
-		ts_char = b1_progline[offset - 1];
-
-		dimsnum = 0;
-		subs_bnds_ptr = subs_bounds;
-
-		hash = b1_tok_id_hash;
+		err = b1_ex_file_close(chan);
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
 
-		// DIM <var_name>[(subscript[,...])] [AS <type_name>][,...]
 		err = b1_tok_get(offset, 0, &td);
 		if(err != B1_RES_OK)
 		{
 			return err;
 		}
 
-		offset = td.offset;
-		len = td.length;
+		if(td.length == 0)
+		{
+			break;
+		}
 
-		if(len == 1 && b1_progline[offset] == B1_T_C_OPBRACK)
+		if(td.length != 1 || !B1_T_ISCOMMA(b1_progline[td.offset]))
+		{
+			return B1_RES_ESYNTAX;
+		}
+
+		offset = td.offset + 1;
+	}
+
+	return B1_RES_OK;
+}
+#endif
+
+#ifdef B1_FEATURE_STMT_DATA_READ
+static B1_T_ERROR b1_int_read_next_field(uint8_t *options)
+{
+	B1_T_ERROR err, err1;
+	B1_T_PROG_LINE_CNT read_line_cnt;
+
+	read_line_cnt = b1_curr_prog_line_cnt;
+
+	// b1_data_curr_line_cnt == 0 stands for the initial state, b1_data_curr_line_offset == 0 means the need to
+	// go to the next DATA statement line
+	if(b1_data_curr_line_cnt == 0 || b1_data_curr_line_offset == 0)
+	{
+		err = b1_ex_prg_data_go_next(b1_data_curr_line_cnt == 0 ? B1_T_LINE_NUM_FIRST : B1_T_LINE_NUM_NEXT);
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
+	}
+
+	// switch to DATA line
+	b1_curr_prog_line_cnt = b1_data_curr_line_cnt - 1;
+	err = b1_ex_prg_get_prog_line(B1_T_LINE_NUM_NEXT);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	err1 = b1_int_input_read_get_value(1, &b1_data_curr_line_offset, options);
+	if(err1 == B1_RES_OK && ((*options) & B1_INT_READ_VALUE_LAST))
+	{
+		// go to the next DATA statement line when reading the next value
+		b1_data_curr_line_offset = 0;
+	}
+
+	// restore READ line
+	b1_curr_prog_line_cnt = read_line_cnt - 1;
+	err = b1_ex_prg_get_prog_line(B1_T_LINE_NUM_NEXT);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	return err1;
+}
+
+static B1_T_ERROR b1_int_st_read(B1_T_INDEX offset)
+{
+	B1_T_ERROR err;
+	uint8_t options;
+	B1_VAR_REF var_ref;
+
+	// process READ statement arguments
+	for(; ; offset++)
+	{
+		// build RPN for every READ statement argument
+		err = b1_rpn_build(offset, INPUT_STOP_TOKEN, &offset);
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
+		if(b1_rpn[0].flags == 0)
+		{
+			// READ statement without arguments
+			return B1_RES_ESYNTAX;
+		}
+
+		// evaluate the expression part
+		err = b1_eval(0, &var_ref);
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
+
+		options = 0;
+		// read value
+		err = b1_int_read_next_field(&options);
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
+
+		err = b1_int_input_read_assign_value(options, &var_ref, NULL);
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
+
+		if(!offset) break;
+	}
+
+	return B1_RES_OK;
+}
+
+// RESTORE statement: sets next DATA stamtement line counter on requested
+// line number, returns the line number in b1_next_line_num variable
+static B1_T_ERROR b1_int_st_restore(B1_T_INDEX offset)
+{
+	B1_T_ERROR err;
+	B1_TOKENDATA td;
+
+	// get restore line number
+	err = b1_tok_get_line_num(&offset);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	err = b1_tok_get(offset, 0, &td);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	if(td.length != 0)
+	{
+		return B1_RES_ESYNTAX;
+	}
+
+	return b1_ex_prg_data_go_next(b1_next_line_num == B1_T_LINE_NUM_ABSENT ? B1_T_LINE_NUM_FIRST : b1_next_line_num);
+}
+#endif
+
+static B1_T_ERROR b1_int_st_dim_get_size(B1_T_INDEX *offset, uint8_t allow_TO_stop_word, B1_T_SUBSCRIPT *size)
+{
+	B1_T_ERROR err;
+
+	// "TO" stop token must be the first in DIM_STOP_TOKENS array
+	err = b1_rpn_build(*offset, allow_TO_stop_word ? DIM_STOP_TOKENS : (DIM_STOP_TOKENS + 1), offset);
+	if(err != B1_RES_OK) return err;
+	if(!offset || b1_rpn[0].flags == 0)
+	{
+		return B1_RES_ESYNTAX;
+	}
+
+	err = b1_eval(0, NULL);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	err = b1_var_convert(b1_rpn_eval, B1_TYPE_INT);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	if(b1_rpn_eval[0].value.i32val < B1_T_SUBSCRIPT_MIN_VALUE || b1_rpn_eval[0].value.i32val > B1_T_SUBSCRIPT_MAX_VALUE)
+	{
+		return B1_RES_ESUBSRANGE;
+	}
+
+	*size = (B1_T_SUBSCRIPT)b1_rpn_eval[0].value.i32val;
+
+	return B1_RES_OK;
+}
+
+#ifdef B1_FEATURE_STMT_FUNCTION
+// hides variable with the specified name (if any) so that a local variable with the same name can be created,
+// the variable is restored by b1_int_fn_locals_free function
+static B1_T_ERROR b1_int_fn_local(B1_T_IDHASH name_hash)
+{
+	B1_T_ERROR err;
+	B1_T_MEMOFFSET offset;
+	B1_INT_FN_LOCAL local;
+	B1_NAMED_VAR *var;
+
+	// the variable must not be declared twice within the same function call
+	for(offset = b1_int_fn_locals_base; offset != b1_int_fn_stack.top; offset += sizeof(B1_INT_FN_LOCAL))
+	{
+		err = b1_fn_stack_read(&b1_int_fn_stack, offset, &local, sizeof(B1_INT_FN_LOCAL));
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
+
+		if(local.var.id.name_hash == name_hash)
+		{
+			return B1_RES_EIDINUSE;
+		}
+	}
+
+	err = b1_ex_var_alloc(name_hash, &var);
+	if(err == B1_RES_OK)
+	{
+		b1_ex_var_free(name_hash);
+		local.var.id.name_hash = name_hash;
+		local.exists = 0;
+	}
+	else
+	if(err == B1_RES_EIDINUSE)
+	{
+		local.var = *var;
+		local.exists = 1;
+	}
+	else
+	{
+		return err;
+	}
+
+	err = b1_fn_stack_push(&b1_int_fn_stack, &local, sizeof(B1_INT_FN_LOCAL));
+	if(err != B1_RES_OK || !local.exists)
+	{
+		return err;
+	}
+
+#ifdef B1_FEATURE_VAR_SLOTS
+	b1_var_slot_free(name_hash);
+#endif
+	return b1_ex_var_free(name_hash);
+}
+
+// frees local variables of the function being executed and restores variables hidden by them
+static B1_T_ERROR b1_int_fn_locals_free()
+{
+	B1_T_ERROR err;
+	B1_INT_FN_LOCAL local;
+	B1_NAMED_VAR *var;
+
+	while(b1_int_fn_stack.top != b1_int_fn_locals_base)
+	{
+		err = b1_fn_stack_pop(&b1_int_fn_stack, &local, sizeof(B1_INT_FN_LOCAL));
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
+
+		err = b1_ex_var_alloc(local.var.id.name_hash, &var);
+		if(err == B1_RES_EIDINUSE)
+		{
+			err = b1_int_var_mem_free(var);
+		}
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
+
+		if(local.exists)
+		{
+			// restore the hidden variable in place of the local one
+			*var = local.var;
+		}
+		else
+		{
+#ifdef B1_FEATURE_VAR_SLOTS
+			b1_var_slot_free(local.var.id.name_hash);
+#endif
+			b1_ex_var_free(local.var.id.name_hash);
+		}
+	}
+
+	return B1_RES_OK;
+}
+#endif
+
+static B1_T_ERROR b1_int_st_dim(B1_T_INDEX offset)
+{
+	B1_T_ERROR err;
+	B1_T_CHAR c, ts_char;
+	uint8_t stop, type, dimsnum;
+	B1_TOKENDATA td;
+	B1_T_INDEX len;
+	B1_T_SUBSCRIPT bound1, subs_bounds[B1_MAX_VAR_DIM_NUM * 2], *subs_bnds_ptr;
+	B1_T_IDHASH hash;
+#ifdef B1_FEATURE_DEBUG
+	B1_T_INDEX id_off, id_len;
+	B1_NAMED_VAR *var;
+#endif
+#ifdef B1_FEATURE_TYPE_MAP
+	uint8_t map;
+#endif
+
+	while(1)
+	{
+		// get variable name
+		err = b1_tok_get(offset, B1_TOK_CALC_HASH, &td);
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
+
+		if(!(td.type & B1_TOKEN_TYPE_IDNAME))
+		{
+			return B1_RES_EINVTOK;
+		}
+
+		offset = td.offset;
+		len = td.length;
+
+#ifdef B1_FEATURE_DEBUG
+		id_off = offset;
+		id_len = len;
+#endif
+		offset += len;
+		type = B1_TYPE_NULL;
+		ts_char = b1_progline[offset - 1];
+#ifdef B1_FEATURE_TYPE_MAP
+		map = 0;
+#endif
+
+		dimsnum = 0;
+		subs_bnds_ptr = subs_bounds;
+
+		hash = b1_tok_id_hash;
+
+		// DIM <var_name>[(subscript[,...])] [AS <type_name>][,...]
+		err = b1_tok_get(offset, 0, &td);
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
+
+		offset = td.offset;
+		len = td.length;
+
+		if(len == 1 && b1_progline[offset] == B1_T_C_OPBRACK)
 		{
 			offset++;
 			// get array dimensions
 			while(1)
 			{
-				if(dimsnum == B1_MAX_VAR_DIM_NUM)
-				{
-					return B1_RES_EWSUBSCNT;
-				}
+				if(dimsnum == B1_MAX_VAR_DIM_NUM)
+				{
+					return B1_RES_EWSUBSCNT;
+				}
+
+				// get either dimension size or lbound
+				err = b1_int_st_dim_get_size(&offset, 1, &bound1);
+				if(err != B1_RES_OK)
+				{
+					return err;
+				}
+
+				// TO, comma or close bracket
+				c = b1_progline[offset];
+
+				if(c == B1_T_C_CLBRACK || B1_T_ISCOMMA(c))
+				{
+					*subs_bnds_ptr++ = b1_opt_base_val;
+					*subs_bnds_ptr++ = bound1;
+					dimsnum++;
+
+					offset++;
+
+					if(B1_T_ISCOMMA(c))
+					{
+						continue;
+					}
+					else
+					{
+						break;
+					}
+				}
+				else
+				{
+					// get ubound
+					offset += 2;
+					*subs_bnds_ptr++ = bound1;
+					err = b1_int_st_dim_get_size(&offset, 0, subs_bnds_ptr++);
+					if(err != B1_RES_OK)
+					{
+						return err;
+					}
+					dimsnum++;
+
+					c = b1_progline[offset];
+					offset++;
+
+					if(B1_T_ISCOMMA(c))
+					{
+						continue;
+					}
+
+					if(c == B1_T_C_CLBRACK)
+					{
+						break;
+					}
+				}
+			}
+
+			err = b1_tok_get(offset, 0, &td);
+			if(err != B1_RES_OK)
+			{
+				return err;
+			}
+
+			offset = td.offset;
+			len = td.length;
+		}
+
+		if(len == 0)
+		{
+			stop = 1;
+		}
+		else
+		if(len == 1 && B1_T_ISCOMMA(b1_progline[offset]))
+		{
+			// continue parsing string
+			stop = 0;
+		}
+		else
+		{
+			// try to get optional variable type
+			if(!b1_t_strcmpi(_AS, b1_progline + offset, len))
+			{
+				err = b1_tok_get(offset + len, 0, &td);
+				if(err != B1_RES_OK)
+				{
+					return err;
+				}
+				offset = td.offset;
+				len = td.length;
+
+#ifdef B1_FEATURE_TYPE_MAP
+				// DIM <var_name> AS MAP [OF <type_name>]
+				map = (dimsnum == 0 && !b1_t_strcmpi(_MAP, b1_progline + offset, len));
+				if(map)
+				{
+					err = b1_tok_get(offset + len, 0, &td);
+					if(err != B1_RES_OK)
+					{
+						return err;
+					}
+
+					if(!b1_t_strcmpi(_OF, b1_progline + td.offset, td.length))
+					{
+						err = b1_tok_get(td.offset + td.length, 0, &td);
+						if(err != B1_RES_OK)
+						{
+							return err;
+						}
+
+						offset = td.offset;
+						len = td.length;
+						map++;
+					}
+				}
+
+				// get variable type (type of map without OF clause depends on type specifier only)
+				err = (map == 1) ? B1_RES_OK : b1_t_get_type_by_name(b1_progline + offset, len, &type);
+#else
+				// get variable type
+				err = b1_t_get_type_by_name(b1_progline + offset, len, &type);
+#endif
+				if(err != B1_RES_OK)
+				{
+					return err;
+				}
+
+				err = b1_tok_get(offset + len, 0, &td);
+				if(err != B1_RES_OK)
+				{
+					return err;
+				}
+
+				offset = td.offset;
+				len = td.length;
+
+				if(len == 0)
+				{
+					stop = 1;
+				}
+				else
+				if(len == 1 && B1_T_ISCOMMA(b1_progline[offset]))
+				{
+					// continue parsing string
+					stop = 0;
+				}
+				else
+				{
+					return B1_RES_ESYNTAX;
+				}
+			}
+			else
+			{
+				return B1_RES_ESYNTAX;
+			}
+		}
+
+		err = b1_t_get_type_by_type_spec(ts_char, type, &type);
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
+
+#ifdef B1_FEATURE_STMT_FUNCTION
+		// variables declared within function body are local
+		if(b1_int_fn_depth != 0)
+		{
+			err = b1_int_fn_local(hash);
+			if(err != B1_RES_OK)
+			{
+				return err;
+			}
+		}
+#endif
+
+		// create variable
+#ifdef B1_FEATURE_DEBUG
+#ifdef B1_FEATURE_TYPE_MAP
+		err = map ? b1_var_map_create(hash, type, &var) : b1_var_create(hash, type, dimsnum, subs_bounds, &var);
+#else
+		err = b1_var_create(hash, type, dimsnum, subs_bounds, &var);
+#endif
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
+
+		memcpy((*var).id.name + 1, b1_progline + id_off, id_len * B1_T_CHAR_SIZE);
+		(*var).id.name[0] = (B1_T_CHAR)id_len;
+#else
+#ifdef B1_FEATURE_TYPE_MAP
+		err = map ? b1_var_map_create(hash, type, NULL) : b1_var_create(hash, type, dimsnum, subs_bounds, NULL);
+#else
+		err = b1_var_create(hash, type, dimsnum, subs_bounds, NULL);
+#endif
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
+#endif
+
+		offset += len;
+		if(stop) break;
+	}
+
+	return B1_RES_OK;
+}
+
+#if defined(B1_FEATURE_STMT_ERASE) || defined(B1_FEATURE_INIT_FREE_MEMORY) || defined(B1_FEATURE_STMT_FUNCTION)
+B1_T_ERROR b1_int_var_mem_free(B1_NAMED_VAR *var)
+{
+	B1_T_ERROR err;
+	uint8_t type, dimsnum;
+	B1_T_MEMOFFSET size, mem_size;
+	B1_T_MEM_BLOCK_DESC desc, arrdesc;
+	const B1_T_MEM_BLOCK_DESC *arrdata;
+	const B1_T_SUBSCRIPT *arrdescdata;
+	B1_T_SUBSCRIPT sub;
+	B1_T_INDEX i;
+
+	// the variable exists, free it
+	type = (*var).var.type;
+	desc = (*var).var.value.mem_desc;
+	dimsnum = B1_IDENT_GET_FLAGS_ARGNUM((*var).id.flags);
+
+	if(dimsnum == 0)
+	{
+		// free string data
+		if(type == B1_TYPE_SET(B1_TYPE_STRING, 0))
+		{
+			b1_ex_mem_free(desc);
+		}
+	}
+	else
+#ifdef B1_FEATURE_TYPE_MAP
+	if(B1_IDENT_TEST_FLAGS_VAR_MAP((*var).id.flags))
+	{
+		// free map keys and values
+		return b1_var_map_free(var);
+	}
+	else
+#endif
+	{
+		// free array data
+#ifdef B1_FEATURE_INIT_FREE_MEMORY
+		if(desc != B1_T_MEM_BLOCK_DESC_INVALID)
+		{
+#endif
+			err = b1_ex_mem_access(desc, 0, 0, B1_EX_MEM_READ, (void **)&arrdescdata);
+			if(err != B1_RES_OK)
+			{
+				return err;
+			}
+
+			// calc array size
+			size = 1;
+			while(dimsnum > 0)
+			{
+				dimsnum--;
+				sub = *arrdescdata++;
+				sub = *arrdescdata++ - sub;
+				size *= ((B1_T_MEMOFFSET)sub) + 1;
+			}
+			arrdesc = *((B1_T_MEM_BLOCK_DESC *)arrdescdata);
+
+			if(arrdesc != B1_T_MEM_BLOCK_DESC_INVALID)
+			{
+				// free array string data
+				if(B1_TYPE_TEST_STRING(type))
+				{
+					mem_size = size * (uint8_t)sizeof(B1_T_MEM_BLOCK_DESC);
+
+					for(size = 0, i = 0; size != mem_size; size += (uint8_t)sizeof(B1_T_MEM_BLOCK_DESC), i++)
+					{
+						if(i == ((B1_T_INDEX)(B1_MAX_STRING_LEN + 1)) / (uint8_t)sizeof(B1_T_MEM_BLOCK_DESC))
+						{
+							i = 0;
+						}
+
+						if(i == 0)
+						{
+							err = b1_ex_mem_access(arrdesc, size, (((B1_T_INDEX)(B1_MAX_STRING_LEN + 1)) / (uint8_t)sizeof(B1_T_MEM_BLOCK_DESC)) * (uint8_t)sizeof(B1_T_MEM_BLOCK_DESC), B1_EX_MEM_WRITE, (void **)&arrdata);
+							if(err != B1_RES_OK)
+							{
+								return err;
+							}
+						}
+
+						if(*(arrdata + i) != B1_T_MEM_BLOCK_DESC_INVALID)
+						{
+							b1_ex_mem_free(*(arrdata + i));
+						}
+					}
+				}
+
+				// free array data
+				b1_ex_mem_free(arrdesc);
+			}
+
+			// free array descriptor data
+			b1_ex_mem_free(desc);
+#ifdef B1_FEATURE_INIT_FREE_MEMORY
+		}
+#endif
+	}
+
+	return B1_RES_OK;
+}
+#endif
+
+#ifdef B1_FEATURE_STMT_ERASE
+static B1_T_ERROR b1_int_st_erase(B1_T_INDEX offset)
+{
+	B1_T_ERROR err;
+	uint8_t next, type;
+	B1_TOKENDATA td;
+	B1_T_INDEX len;
+	B1_NAMED_VAR *var;
+
+	while(1)
+	{
+		// get variable name
+		err = b1_tok_get(offset, B1_TOK_CALC_HASH, &td);
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
+
+		type = td.type;
+		offset = td.offset;
+		len = td.length;
+		if(len == 0)
+		{
+			return B1_RES_ESYNTAX;
+		}
+
+		if(!(type & B1_TOKEN_TYPE_IDNAME))
+		{
+			return B1_RES_EINVTOK;
+		}
+
+		offset += len;
+
+		err = b1_tok_get(offset, 0, &td);
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
+
+		offset = td.offset;
+		len = td.length;
+		next = (len == 1) && B1_T_ISCOMMA(*(b1_progline + offset));
+		if(!next && len != 0)
+		{
+			return B1_RES_ESYNTAX;
+		}
+		offset++;
+
+		err = b1_ex_var_alloc(b1_tok_id_hash, &var);
+		if(err != B1_RES_OK && err != B1_RES_EIDINUSE)
+		{
+			return err;
+		}
+
+		err = b1_int_var_mem_free(var);
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
+
+		// release variable memory
+#ifdef B1_FEATURE_VAR_SLOTS
+		b1_var_slot_free(b1_tok_id_hash);
+#endif
+		b1_ex_var_free(b1_tok_id_hash);
+
+		if(!next) break;
+	}
+
+	return B1_RES_OK;
+}
+#endif
+
+#ifdef B1_FEATURE_TYPE_MAP
+// DELETE <map_name>(<key>)[, <map_name>(<key>)...], deleting missing key is not an error
+static B1_T_ERROR b1_int_st_delete(B1_T_INDEX offset)
+{
+	B1_T_ERROR err;
+	B1_TOKENDATA td;
+	B1_T_IDHASH hash;
+	B1_NAMED_VAR *var;
+
+	while(1)
+	{
+		// get map name
+		err = b1_tok_get(offset, B1_TOK_CALC_HASH, &td);
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
+
+		if(!(td.type & B1_TOKEN_TYPE_IDNAME))
+		{
+			return B1_RES_EINVTOK;
+		}
+
+		hash = b1_tok_id_hash;
+
+		err = b1_tok_get(td.offset + td.length, 0, &td);
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
+
+		if(td.length != 1 || b1_progline[td.offset] != B1_T_C_OPBRACK)
+		{
+			return B1_RES_ESYNTAX;
+		}
+
+		// evaluate the key (before getting the variable: the expression can create new variables)
+		err = b1_rpn_build(td.offset + 1, DIM_STOP_TOKENS + 1, &offset);
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
+
+		if(offset == 0 || b1_rpn[0].flags == 0)
+		{
+			return B1_RES_ESYNTAX;
+		}
+
+		if(b1_progline[offset] != B1_T_C_CLBRACK)
+		{
+			return B1_RES_EWSUBSCNT;
+		}
+
+		offset++;
+
+		err = b1_eval(0, NULL);
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
+
+		err = b1_ex_var_alloc(hash, &var);
+		if(err == B1_RES_OK)
+		{
+			b1_ex_var_free(hash);
+			return B1_RES_EUNKIDENT;
+		}
+
+		if(err != B1_RES_EIDINUSE)
+		{
+			return err;
+		}
+
+		if(!B1_IDENT_TEST_FLAGS_VAR_MAP((*var).id.flags))
+		{
+			return B1_RES_ETYPMISM;
+		}
+
+		err = b1_var_map_find(var, b1_rpn_eval, 1);
+		if(err != B1_RES_OK && err != B1_RES_EUNKIDENT)
+		{
+			return err;
+		}
+
+		err = b1_tok_get(offset, 0, &td);
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
+
+		if(td.length == 0)
+		{
+			break;
+		}
+
+		if(td.length != 1 || !B1_T_ISCOMMA(b1_progline[td.offset]))
+		{
+			return B1_RES_ESYNTAX;
+		}
+
+		offset = td.offset + 1;
+	}
+
+	return B1_RES_OK;
+}
+#endif
+
+#if defined(B1_FEATURE_STMT_MAT) || defined(B1_FEATURE_STMT_SORT)
+// gets array variable name at *offset, the array must exist (MAT and SORT statements do not create variables)
+static B1_T_ERROR b1_int_get_arr_var(B1_T_INDEX *offset, B1_NAMED_VAR **var)
+{
+	B1_T_ERROR err;
+	B1_TOKENDATA td;
+
+	err = b1_tok_get(*offset, B1_TOK_CALC_HASH, &td);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	if(!(td.type & B1_TOKEN_TYPE_IDNAME))
+	{
+		return B1_RES_EINVTOK;
+	}
+
+	*offset = td.offset + td.length;
+
+	err = b1_ex_var_alloc(b1_tok_id_hash, var);
+	if(err == B1_RES_OK)
+	{
+		b1_ex_var_free(b1_tok_id_hash);
+		return B1_RES_EUNKIDENT;
+	}
+
+	if(err != B1_RES_EIDINUSE)
+	{
+		return err;
+	}
+
+	return B1_IDENT_GET_FLAGS_ARGNUM((**var).id.flags) == 0 ? B1_RES_EWSUBSCNT : B1_RES_OK;
+}
+#endif
+
+#ifdef B1_FEATURE_STMT_MAT
+// gets the next token and checks if it is the one-character token c (c = 0 stands for the statement end)
+static B1_T_ERROR b1_int_mat_test_char(B1_T_INDEX *offset, B1_T_CHAR c)
+{
+	B1_T_ERROR err;
+	B1_TOKENDATA td;
+
+	err = b1_tok_get(*offset, 0, &td);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	if(c == 0)
+	{
+		return (td.length == 0) ? B1_RES_OK : B1_RES_ESYNTAX;
+	}
+
+	if(td.length != 1 || b1_progline[td.offset] != c)
+	{
+		return B1_RES_ESYNTAX;
+	}
+
+	*offset = td.offset + 1;
+
+	return B1_RES_OK;
+}
+
+#ifdef B1_FEATURE_STMT_DATA_READ
+// MAT READ: reads array elements from DATA statements (the last subscript changes fastest)
+static B1_T_ERROR b1_int_mat_read(B1_NAMED_VAR *var)
+{
+	B1_T_ERROR err;
+	uint8_t options;
+	B1_VAR_ARRAY_INFO info;
+	B1_VAR_REF var_ref;
+
+	err = b1_var_array_get_info(var, 1, &info);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	var_ref.var = var;
+	var_ref.arr_data_desc = info.data_desc;
+
+	for(var_ref.val_off = 0; var_ref.val_off < info.size; var_ref.val_off++)
+	{
+		options = 0;
+		err = b1_int_read_next_field(&options);
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
+
+		err = b1_int_input_read_assign_value(options, &var_ref, NULL);
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
+	}
+
+	return B1_RES_OK;
+}
+#endif
+
+// MAT PRINT: prints array elements in print zones, every row (or one-dimensional array) on a separate line
+static B1_T_ERROR b1_int_mat_print(B1_NAMED_VAR *var)
+{
+	B1_T_ERROR err;
+	uint8_t i;
+	B1_VAR_ARRAY_INFO info;
+	B1_T_SUBSCRIPT subs[B1_MAX_VAR_DIM_NUM];
+	B1_T_MEMOFFSET k;
+	B1_T_CHAR *sdata;
+	B1_T_INDEX len;
+
+	err = b1_var_array_get_info(var, 0, &info);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	for(i = 0; i < info.dimnum; i++)
+	{
+		subs[i] = info.lbounds[i];
+	}
+
+	for(k = 0; k < info.size; k++)
+	{
+		if(subs[info.dimnum - 1] != info.lbounds[info.dimnum - 1])
+		{
+			err = b1_int_print_next_zone();
+			if(err != B1_RES_OK)
+			{
+				return err;
+			}
+		}
+
+		for(i = 0; i < info.dimnum; i++)
+		{
+			b1_rpn_eval[i].type = B1_TYPE_SET(B1_TYPE_INT, 0);
+			b1_rpn_eval[i].value.i32val = subs[i];
+		}
+
+		err = b1_var_get(var, b1_rpn_eval, NULL);
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
+
+		err = b1_int_print_get_value_str(&sdata, &len);
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
+
+		err = b1_int_print_str_wrap(sdata, len);
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
+
+		// next element subscripts
+		for(i = info.dimnum; i != 0;)
+		{
+			i--;
+			subs[i]++;
+			if((B1_T_MEMOFFSET)(subs[i] - info.lbounds[i]) < info.dims[i])
+			{
+				break;
+			}
+			subs[i] = info.lbounds[i];
+		}
+
+		if(subs[info.dimnum - 1] == info.lbounds[info.dimnum - 1])
+		{
+			err = b1_int_print_newline();
+			if(err != B1_RES_OK)
+			{
+				return err;
+			}
+		}
+	}
+
+	return B1_RES_OK;
+}
+
+// processes array list of MAT READ and MAT PRINT statements
+static B1_T_ERROR b1_int_mat_array_list(B1_T_INDEX offset, uint8_t read)
+{
+	B1_T_ERROR err;
+	B1_NAMED_VAR *var;
+	B1_TOKENDATA td;
+
+	while(1)
+	{
+		err = b1_int_get_arr_var(&offset, &var);
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
+
+#ifdef B1_FEATURE_STMT_DATA_READ
+		err = read ? b1_int_mat_read(var) : b1_int_mat_print(var);
+#else
+		err = b1_int_mat_print(var);
+#endif
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
+
+		err = b1_tok_get(offset, 0, &td);
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
+
+		if(td.length == 0)
+		{
+			break;
+		}
+
+		if(td.length != 1 || !B1_T_ISCOMMA(b1_progline[td.offset]))
+		{
+			return B1_RES_ESYNTAX;
+		}
+
+		offset = td.offset + 1;
+	}
+
+	return B1_RES_OK;
+}
+
+static uint8_t b1_int_mat_same_shape(const B1_VAR_ARRAY_INFO *info1, const B1_VAR_ARRAY_INFO *info2)
+{
+	uint8_t i;
+
+	if((*info1).dimnum != (*info2).dimnum)
+	{
+		return 0;
+	}
+
+	for(i = 0; i < (*info1).dimnum; i++)
+	{
+		if((*info1).dims[i] != (*info2).dims[i])
+		{
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+// element-wise operations: ZER, CON, IDN, RND, copying, addition, subtraction and multiplication by scalar
+static B1_T_ERROR b1_int_mat_elementwise(uint8_t op, const B1_VAR_ARRAY_INFO *dst, const B1_VAR_ARRAY_INFO *src1, const B1_VAR_ARRAY_INFO *src2, B1_T_ARRAY_VAL k)
+{
+	B1_T_ERROR err;
+	B1_T_MEMOFFSET offset, n, i;
+	B1_T_ARRAY_VAL *buf1, *buf2;
+
+	buf1 = b1_int_mat_buf[0];
+	buf2 = b1_int_mat_buf[1];
+
+	for(offset = 0; offset < (*dst).size; offset += n)
+	{
+		n = (*dst).size - offset;
+		if(n > B1_INT_MAT_BUF_LEN)
+		{
+			n = B1_INT_MAT_BUF_LEN;
+		}
+
+		if(op >= B1_INT_MAT_OP_COPY)
+		{
+			err = b1_var_array_copy(src1, offset, n, buf1, 0);
+			if(err != B1_RES_OK)
+			{
+				return err;
+			}
+		}
+
+		if(op == B1_INT_MAT_OP_ADD || op == B1_INT_MAT_OP_SUB)
+		{
+			err = b1_var_array_copy(src2, offset, n, buf2, 0);
+			if(err != B1_RES_OK)
+			{
+				return err;
+			}
+		}
+
+		switch(op)
+		{
+			case B1_INT_MAT_OP_ZER:
+			case B1_INT_MAT_OP_CON:
+				for(i = 0; i < n; i++) buf1[i] = (op == B1_INT_MAT_OP_CON) ? (B1_T_ARRAY_VAL)1 : (B1_T_ARRAY_VAL)0;
+				break;
+			case B1_INT_MAT_OP_IDN:
+				for(i = 0; i < n; i++) buf1[i] = ((offset + i) % ((*dst).dims[1] + 1) == 0) ? (B1_T_ARRAY_VAL)1 : (B1_T_ARRAY_VAL)0;
+				break;
+#ifdef B1_FEATURE_FUNCTIONS_MATH_BASIC
+			case B1_INT_MAT_OP_RND:
+				for(i = 0; i < n; i++) buf1[i] = B1_FN_RND_SEED_TO_FP(b1_ex_rnd_get_next_seed());
+				break;
+#endif
+			case B1_INT_MAT_OP_ADD:
+				for(i = 0; i < n; i++) buf1[i] += buf2[i];
+				break;
+			case B1_INT_MAT_OP_SUB:
+				for(i = 0; i < n; i++) buf1[i] -= buf2[i];
+				break;
+			case B1_INT_MAT_OP_SCALE:
+				for(i = 0; i < n; i++) buf1[i] *= k;
+				break;
+		}
+
+		err = b1_var_array_copy(dst, offset, n, buf1, 1);
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
+	}
+
+	return B1_RES_OK;
+}
+
+// transposes m x n src matrix to n x m dst matrix tile by tile
+static B1_T_ERROR b1_int_mat_trn(const B1_VAR_ARRAY_INFO *dst, const B1_VAR_ARRAY_INFO *src)
+{
+	B1_T_ERROR err;
+	B1_T_MEMOFFSET m, n, i0, j0, ni, nj, r, c;
+	B1_T_ARRAY_VAL *t1, *t2;
+
+	m = (*src).dims[0];
+	n = (*src).dims[1];
+
+	if((*dst).dims[0] != n || (*dst).dims[1] != m)
+	{
+		return B1_RES_ESUBSRANGE;
+	}
+
+	t1 = b1_int_mat_buf[0];
+	t2 = b1_int_mat_buf[1];
+
+	for(i0 = 0; i0 < m; i0 += ni)
+	{
+		ni = (m - i0 > B1_MAT_TILE_SIZE) ? B1_MAT_TILE_SIZE : (m - i0);
+
+		for(j0 = 0; j0 < n; j0 += nj)
+		{
+			nj = (n - j0 > B1_MAT_TILE_SIZE) ? B1_MAT_TILE_SIZE : (n - j0);
+
+			for(r = 0; r < ni; r++)
+			{
+				err = b1_var_array_copy(src, (i0 + r) * n + j0, nj, t1 + r * B1_MAT_TILE_SIZE, 0);
+				if(err != B1_RES_OK)
+				{
+					return err;
+				}
+			}
+
+			for(r = 0; r < ni; r++)
+			{
+				for(c = 0; c < nj; c++) t2[c * B1_MAT_TILE_SIZE + r] = t1[r * B1_MAT_TILE_SIZE + c];
+			}
+
+			for(c = 0; c < nj; c++)
+			{
+				err = b1_var_array_copy(dst, (j0 + c) * m + i0, ni, t2 + c * B1_MAT_TILE_SIZE, 1);
+				if(err != B1_RES_OK)
+				{
+					return err;
+				}
+			}
+		}
+	}
+
+	return B1_RES_OK;
+}
+
+// multiplies src1 by src2 using square tiles (one-dimensional src1 is treated as a row vector and
+// one-dimensional src2 as a column vector), elements are accumulated in B1_T_ARRAY_VAL type
+static B1_T_ERROR b1_int_mat_mul(const B1_VAR_ARRAY_INFO *dst, const B1_VAR_ARRAY_INFO *src1, const B1_VAR_ARRAY_INFO *src2)
+{
+	B1_T_ERROR err;
+	B1_T_MEMOFFSET m, n, p, i0, j0, k0, ni, nj, nk, r, c, k;
+	B1_T_ARRAY_VAL *ta, *tb, *tc, v;
+
+	m = ((*src1).dimnum == 1) ? 1 : (*src1).dims[0];
+	n = (*src1).dims[(*src1).dimnum - 1];
+	p = ((*src2).dimnum == 1) ? 1 : (*src2).dims[1];
+
+	if((*src2).dims[0] != n)
+	{
+		return B1_RES_ESUBSRANGE;
+	}
+
+	if((*dst).dimnum == 1 ? ((*dst).size != m * p || (m != 1 && p != 1)) : ((*dst).dims[0] != m || (*dst).dims[1] != p))
+	{
+		return B1_RES_ESUBSRANGE;
+	}
+
+	ta = b1_int_mat_buf[0];
+	tb = b1_int_mat_buf[1];
+	tc = b1_int_mat_buf[2];
+
+	for(i0 = 0; i0 < m; i0 += ni)
+	{
+		ni = (m - i0 > B1_MAT_TILE_SIZE) ? B1_MAT_TILE_SIZE : (m - i0);
+
+		for(j0 = 0; j0 < p; j0 += nj)
+		{
+			nj = (p - j0 > B1_MAT_TILE_SIZE) ? B1_MAT_TILE_SIZE : (p - j0);
+
+			for(r = 0; r < B1_INT_MAT_BUF_LEN; r++) tc[r] = (B1_T_ARRAY_VAL)0;
+
+			for(k0 = 0; k0 < n; k0 += nk)
+			{
+				nk = (n - k0 > B1_MAT_TILE_SIZE) ? B1_MAT_TILE_SIZE : (n - k0);
+
+				for(r = 0; r < ni; r++)
+				{
+					err = b1_var_array_copy(src1, (i0 + r) * n + k0, nk, ta + r * B1_MAT_TILE_SIZE, 0);
+					if(err != B1_RES_OK)
+					{
+						return err;
+					}
+				}
+
+				for(k = 0; k < nk; k++)
+				{
+					err = b1_var_array_copy(src2, (k0 + k) * p + j0, nj, tb + k * B1_MAT_TILE_SIZE, 0);
+					if(err != B1_RES_OK)
+					{
+						return err;
+					}
+				}
+
+				for(r = 0; r < ni; r++)
+				{
+					for(k = 0; k < nk; k++)
+					{
+						v = ta[r * B1_MAT_TILE_SIZE + k];
+						for(c = 0; c < nj; c++) tc[r * B1_MAT_TILE_SIZE + c] += v * tb[k * B1_MAT_TILE_SIZE + c];
+					}
+				}
+			}
+
+			for(r = 0; r < ni; r++)
+			{
+				err = b1_var_array_copy(dst, (i0 + r) * p + j0, nj, tc + r * B1_MAT_TILE_SIZE, 1);
+				if(err != B1_RES_OK)
+				{
+					return err;
+				}
+			}
+		}
+	}
+
+	return B1_RES_OK;
+}
+
+// MAT statement: MAT <arr> = ZER | CON | IDN | RND | TRN(<arr1>) | (<num_expr>) * <arr1> | <arr1> [+ | - | * <arr2>],
+// MAT READ <arr>[, <arr1>...], MAT PRINT <arr>[, <arr1>...]
+static B1_T_ERROR b1_int_st_mat(B1_T_INDEX offset)
+{
+	B1_T_ERROR err;
+	uint8_t op, stmt;
+	B1_TOKENDATA td;
+	B1_NAMED_VAR *dst, *src1, *src2;
+	B1_VAR_ARRAY_INFO dst_info, src1_info, src2_info;
+	B1_T_ARRAY_VAL k;
+	B1_T_CHAR c;
+
+	err = b1_tok_get(offset, B1_TOK_CALC_HASH, &td);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	if(td.type & B1_TOKEN_TYPE_IDNAME)
+	{
+		stmt = b1_id_get_stmt_by_hash(b1_tok_id_hash);
+
+		if(stmt == B1_ID_STMT_PRINT)
+		{
+			return b1_int_mat_array_list(td.offset + td.length, 0);
+		}
+
+#ifdef B1_FEATURE_STMT_DATA_READ
+		if(stmt == B1_ID_STMT_READ)
+		{
+			return b1_int_mat_array_list(td.offset + td.length, 1);
+		}
+#endif
+	}
+
+	err = b1_int_get_arr_var(&offset, &dst);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	err = b1_int_mat_test_char(&offset, B1_T_C_EQ);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	err = b1_tok_get(offset, 0, &td);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	src1 = NULL;
+	src2 = NULL;
+	k = (B1_T_ARRAY_VAL)1;
+
+	if(td.length == 1 && b1_progline[td.offset] == B1_T_C_OPBRACK)
+	{
+		// scalar multiplication: (<num_expr>) * <arr1>
+		op = B1_INT_MAT_OP_SCALE;
+
+		err = b1_rpn_build(td.offset, MAT_STOP_TOKEN, &offset);
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
+
+		if(!offset)
+		{
+			return B1_RES_ESYNTAX;
+		}
+
+		offset++;
+
+		err = b1_eval(0, NULL);
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
+
+		if(!B1_TYPE_TEST_NUMERIC(b1_rpn_eval[0].type))
+		{
+			return B1_RES_ETYPMISM;
+		}
+
+		err = b1_var_convert(b1_rpn_eval, B1_TYPE_FP_HIGH_PREC);
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
+
+#ifdef B1_FEATURE_TYPE_DOUBLE
+		k = b1_rpn_eval[0].value.dval;
+#else
+		k = b1_rpn_eval[0].value.sval;
+#endif
+	}
+	else
+	if(!b1_t_strcmpi(_ZER, b1_progline + td.offset, td.length))
+	{
+		op = B1_INT_MAT_OP_ZER;
+		offset = td.offset + td.length;
+	}
+	else
+	if(!b1_t_strcmpi(_CON, b1_progline + td.offset, td.length))
+	{
+		op = B1_INT_MAT_OP_CON;
+		offset = td.offset + td.length;
+	}
+	else
+	if(!b1_t_strcmpi(_IDN, b1_progline + td.offset, td.length))
+	{
+		op = B1_INT_MAT_OP_IDN;
+		offset = td.offset + td.length;
+	}
+	else
+#ifdef B1_FEATURE_FUNCTIONS_MATH_BASIC
+	if(!b1_t_strcmpi(_RND, b1_progline + td.offset, td.length))
+	{
+		op = B1_INT_MAT_OP_RND;
+		offset = td.offset + td.length;
+	}
+	else
+#endif
+	if(!b1_t_strcmpi(_TRN, b1_progline + td.offset, td.length))
+	{
+		op = B1_INT_MAT_OP_TRN;
+		offset = td.offset + td.length;
+
+		err = b1_int_mat_test_char(&offset, B1_T_C_OPBRACK);
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
+	}
+	else
+	{
+		op = B1_INT_MAT_OP_COPY;
+	}
+
+	if(op >= B1_INT_MAT_OP_COPY)
+	{
+		err = b1_int_get_arr_var(&offset, &src1);
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
+	}
+
+	if(op == B1_INT_MAT_OP_TRN)
+	{
+		err = b1_int_mat_test_char(&offset, B1_T_C_CLBRACK);
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
+	}
+	else
+	if(op == B1_INT_MAT_OP_COPY)
+	{
+		err = b1_tok_get(offset, 0, &td);
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
+
+		if(td.length != 0)
+		{
+			c = b1_progline[td.offset];
+
+			op =	(td.length != 1) ? B1_INT_MAT_OP_COPY :
+					(c == B1_T_C_PLUS) ? B1_INT_MAT_OP_ADD :
+					(c == B1_T_C_MINUS) ? B1_INT_MAT_OP_SUB :
+					(c == B1_T_C_ASTERISK) ? B1_INT_MAT_OP_MUL : B1_INT_MAT_OP_COPY;
+
+			if(op == B1_INT_MAT_OP_COPY)
+			{
+				return B1_RES_ESYNTAX;
+			}
+
+			offset = td.offset + 1;
+
+			err = b1_int_get_arr_var(&offset, &src2);
+			if(err != B1_RES_OK)
+			{
+				return err;
+			}
+		}
+	}
+
+	err = b1_int_mat_test_char(&offset, 0);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	// matrix multiplication and transposition cannot be done in place
+	if((op == B1_INT_MAT_OP_MUL || op == B1_INT_MAT_OP_TRN) && (dst == src1 || dst == src2))
+	{
+		return B1_RES_EINVARG;
+	}
+
+	// source arrays are not allocated here: non-allocated arrays are read as zero-filled
+	if(src1 != NULL)
+	{
+		err = b1_var_array_get_info(src1, 0, &src1_info);
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
+	}
+
+	if(src2 != NULL)
+	{
+		err = b1_var_array_get_info(src2, 0, &src2_info);
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
+	}
+
+	err = b1_var_array_get_info(dst, 1, &dst_info);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	// the destination array can be the same as one of the source arrays
+	if(dst == src1)
+	{
+		src1_info.data_desc = dst_info.data_desc;
+	}
+
+	if(dst == src2)
+	{
+		src2_info.data_desc = dst_info.data_desc;
+	}
+
+	if(op == B1_INT_MAT_OP_MUL || op == B1_INT_MAT_OP_TRN)
+	{
+		if(dst_info.dimnum > 2 || src1_info.dimnum > 2 || (op == B1_INT_MAT_OP_MUL && src2_info.dimnum > 2) || (op == B1_INT_MAT_OP_TRN && (src1_info.dimnum != 2 || dst_info.dimnum != 2)))
+		{
+			return B1_RES_EWSUBSCNT;
+		}
+
+		return (op == B1_INT_MAT_OP_MUL) ? b1_int_mat_mul(&dst_info, &src1_info, &src2_info) : b1_int_mat_trn(&dst_info, &src1_info);
+	}
+
+	if(op == B1_INT_MAT_OP_IDN)
+	{
+		if(dst_info.dimnum != 2)
+		{
+			return B1_RES_EWSUBSCNT;
+		}
+
+		if(dst_info.dims[0] != dst_info.dims[1])
+		{
+			return B1_RES_ESUBSRANGE;
+		}
+	}
+
+	if((src1 != NULL && !b1_int_mat_same_shape(&dst_info, &src1_info)) || (src2 != NULL && !b1_int_mat_same_shape(&dst_info, &src2_info)))
+	{
+		return B1_RES_ESUBSRANGE;
+	}
+
+	return b1_int_mat_elementwise(op, &dst_info, &src1_info, &src2_info, k);
+}
+#endif
+
+#ifdef B1_FEATURE_STMT_SORT
+// loads key of the element to compare other elements with (b1_int_sort_key or b1_tmp_buf1 for string array)
+static B1_T_ERROR b1_int_sort_load(B1_T_MEMOFFSET i)
+{
+	if(b1_int_sort_arrs[0].type == B1_TYPE_STRING)
+	{
+		return b1_var_array_get_str(b1_int_sort_arrs, i, b1_tmp_buf1);
+	}
+
+	return b1_var_array_copy(b1_int_sort_arrs, i, 1, &b1_int_sort_key, 0);
+}
+
+// compares the element with the loaded key: *res is negative if the element is less than the key,
+// zero if they are equal and positive if the element is greater
+static B1_T_ERROR b1_int_sort_cmp(B1_T_MEMOFFSET i, int8_t *res)
+{
+	B1_T_ERROR err;
+	B1_T_ARRAY_VAL val;
+
+	if(b1_int_sort_arrs[0].type == B1_TYPE_STRING)
+	{
+		err = b1_var_array_get_str(b1_int_sort_arrs, i, b1_tmp_buf);
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
+
+		*res = B1_T_STRCMP_L(b1_tmp_buf, b1_tmp_buf1 + 1, *b1_tmp_buf1);
+
+		return B1_RES_OK;
+	}
+
+	err = b1_var_array_copy(b1_int_sort_arrs, i, 1, &val, 0);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	*res = (val < b1_int_sort_key) ? (int8_t)-1 : (val > b1_int_sort_key) ? (int8_t)1 : (int8_t)0;
+
+	return B1_RES_OK;
+}
+
+// swaps two elements of the array being sorted and of all the arrays rearranged together with it
+static B1_T_ERROR b1_int_sort_swap(B1_T_MEMOFFSET i, B1_T_MEMOFFSET j)
+{
+	B1_T_ERROR err;
+	uint8_t a;
+
+	for(a = 0; a < b1_int_sort_arr_num; a++)
+	{
+		err = b1_var_array_swap(b1_int_sort_arrs + a, i, j);
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
+	}
+
+	return B1_RES_OK;
+}
+
+// loads the key of element i and swaps elements i and j if element j is greater than the key
+static B1_T_ERROR b1_int_sort_order(B1_T_MEMOFFSET i, B1_T_MEMOFFSET j)
+{
+	B1_T_ERROR err;
+	int8_t res;
+
+	err = b1_int_sort_load(i);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	err = b1_int_sort_cmp(j, &res);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	return (res > 0) ? b1_int_sort_swap(j, i) : B1_RES_OK;
+}
+
+static B1_T_ERROR b1_int_sort_insertion(B1_T_MEMOFFSET lo, B1_T_MEMOFFSET hi)
+{
+	B1_T_ERROR err;
+	B1_T_MEMOFFSET i, j;
+	int8_t res;
+
+	for(i = lo + 1; i <= hi; i++)
+	{
+		err = b1_int_sort_load(i);
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
+
+		for(j = i; j > lo; j--)
+		{
+			err = b1_int_sort_cmp(j - 1, &res);
+			if(err != B1_RES_OK)
+			{
+				return err;
+			}
 
-				// get either dimension size or lbound
-				err = b1_int_st_dim_get_size(&offset, 1, &bound1);
-				if(err != B1_RES_OK)
-				{
-					return err;
-				}
+			if(res <= 0)
+			{
+				break;
+			}
 
-				// TO, comma or close bracket
-				c = b1_progline[offset];
+			err = b1_int_sort_swap(j - 1, j);
+			if(err != B1_RES_OK)
+			{
+				return err;
+			}
+		}
+	}
 
-				if(c == B1_T_C_CLBRACK || B1_T_ISCOMMA(c))
-				{
-					*subs_bnds_ptr++ = b1_opt_base_val;
-					*subs_bnds_ptr++ = bound1;
-					dimsnum++;
+	return B1_RES_OK;
+}
 
-					offset++;
+// sifts down root element of the heap consisting of n elements starting from lo
+static B1_T_ERROR b1_int_sort_sift(B1_T_MEMOFFSET lo, B1_T_MEMOFFSET root, B1_T_MEMOFFSET n)
+{
+	B1_T_ERROR err;
+	B1_T_MEMOFFSET child;
+	int8_t res;
 
-					if(B1_T_ISCOMMA(c))
-					{
-						continue;
-					}
-					else
-					{
-						break;
-					}
-				}
-				else
-				{
-					// get ubound
-					offset += 2;
-					*subs_bnds_ptr++ = bound1;
-					err = b1_int_st_dim_get_size(&offset, 0, subs_bnds_ptr++);
-					if(err != B1_RES_OK)
-					{
-						return err;
-					}
-					dimsnum++;
+	while(root < n / 2)
+	{
+		child = root * 2 + 1;
 
-					c = b1_progline[offset];
-					offset++;
+		if(child + 1 < n)
+		{
+			err = b1_int_sort_load(lo + child + 1);
+			if(err != B1_RES_OK)
+			{
+				return err;
+			}
 
-					if(B1_T_ISCOMMA(c))
-					{
-						continue;
-					}
+			err = b1_int_sort_cmp(lo + child, &res);
+			if(err != B1_RES_OK)
+			{
+				return err;
+			}
+
+			if(res < 0)
+			{
+				child++;
+			}
+		}
+
+		err = b1_int_sort_load(lo + child);
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
+
+		err = b1_int_sort_cmp(lo + root, &res);
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
+
+		if(res >= 0)
+		{
+			break;
+		}
+
+		err = b1_int_sort_swap(lo + root, lo + child);
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
+
+		root = child;
+	}
+
+	return B1_RES_OK;
+}
+
+static B1_T_ERROR b1_int_sort_heap(B1_T_MEMOFFSET lo, B1_T_MEMOFFSET hi)
+{
+	B1_T_ERROR err;
+	B1_T_MEMOFFSET n, i;
+
+	n = hi - lo + 1;
+
+	for(i = n / 2; i > 0;)
+	{
+		i--;
+		err = b1_int_sort_sift(lo, i, n);
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
+	}
+
+	for(i = n - 1; i > 0; i--)
+	{
+		err = b1_int_sort_swap(lo, lo + i);
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
+
+		err = b1_int_sort_sift(lo, 0, i);
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
+	}
+
+	return B1_RES_OK;
+}
+
+// Hoare partition with median of three pivot, all elements of [lo, *p] range are not greater
+// than elements of [*p + 1, hi] range after the call (lo <= *p < hi)
+static B1_T_ERROR b1_int_sort_partition(B1_T_MEMOFFSET lo, B1_T_MEMOFFSET hi, B1_T_MEMOFFSET *p)
+{
+	B1_T_ERROR err;
+	B1_T_MEMOFFSET i, j;
+	int8_t res;
+
+	i = lo + (hi - lo) / 2;
+
+	err = b1_int_sort_order(i, lo);
+	if(err == B1_RES_OK)
+	{
+		err = b1_int_sort_order(hi, i);
+	}
+	if(err == B1_RES_OK)
+	{
+		err = b1_int_sort_order(i, lo);
+	}
+	if(err == B1_RES_OK)
+	{
+		err = b1_int_sort_load(i);
+	}
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	i = lo;
+	j = hi;
+
+	while(1)
+	{
+		while(1)
+		{
+			err = b1_int_sort_cmp(i, &res);
+			if(err != B1_RES_OK)
+			{
+				return err;
+			}
+
+			if(res >= 0)
+			{
+				break;
+			}
+
+			i++;
+		}
+
+		while(1)
+		{
+			err = b1_int_sort_cmp(j, &res);
+			if(err != B1_RES_OK)
+			{
+				return err;
+			}
+
+			if(res <= 0)
+			{
+				break;
+			}
+
+			j--;
+		}
+
+		if(i >= j)
+		{
+			break;
+		}
+
+		err = b1_int_sort_swap(i, j);
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
+
+		i++;
+		j--;
+	}
+
+	*p = j;
+
+	return B1_RES_OK;
+}
+
+// introsort: quicksort switching to heapsort when recursion depth limit is exceeded and to insertion
+// sort for short ranges, the larger part of partitioned range is pushed to stack and the smaller one
+// is processed first so the stack never holds more than log2(size) ranges
+static B1_T_ERROR b1_int_sort_intro(B1_T_MEMOFFSET size)
+{
+	B1_T_ERROR err;
+	B1_T_MEMOFFSET lo, hi, p, n;
+	B1_T_MEMOFFSET stk_lo[B1_INT_SORT_STACK_LEN], stk_hi[B1_INT_SORT_STACK_LEN];
+	uint8_t stk_depth[B1_INT_SORT_STACK_LEN];
+	uint8_t sp, depth;
+
+	depth = 0;
+	for(n = size; n > 1; n /= 2)
+	{
+		depth += 2;
+	}
 
-					if(c == B1_T_C_CLBRACK)
-					{
-						break;
-					}
-				}
-			}
+	sp = 0;
+	lo = 0;
+	hi = size - 1;
 
-			err = b1_tok_get(offset, 0, &td);
+	while(1)
+	{
+		if(hi - lo < B1_INT_SORT_INSERTION_LEN || depth == 0)
+		{
+			err = (hi - lo < B1_INT_SORT_INSERTION_LEN) ? b1_int_sort_insertion(lo, hi) : b1_int_sort_heap(lo, hi);
 			if(err != B1_RES_OK)
 			{
 				return err;
 			}
 
-			offset = td.offset;
-			len = td.length;
+			if(sp == 0)
+			{
+				break;
+			}
+
+			sp--;
+			lo = stk_lo[sp];
+			hi = stk_hi[sp];
+			depth = stk_depth[sp];
+			continue;
 		}
 
-		if(len == 0)
+		depth--;
+
+		err = b1_int_sort_partition(lo, hi, &p);
+		if(err != B1_RES_OK)
 		{
-			stop = 1;
+			return err;
 		}
-		else
-		if(len == 1 && B1_T_ISCOMMA(b1_progline[offset]))
+
+		stk_depth[sp] = depth;
+
+		if(p - lo < hi - p)
 		{
-			// continue parsing string
-			stop = 0;
+			stk_lo[sp] = p + 1;
+			stk_hi[sp] = hi;
+			hi = p;
 		}
 		else
 		{
-			// try to get optional variable type
-			if(!b1_t_strcmpi(_AS, b1_progline + offset, len))
-			{
-				err = b1_tok_get(offset + len, 0, &td);
-				if(err != B1_RES_OK)
-				{
-					return err;
-				}
-				offset = td.offset;
-				len = td.length;
+			stk_lo[sp] = lo;
+			stk_hi[sp] = p;
+			lo = p + 1;
+		}
 
-				// get variable type
-				err = b1_t_get_type_by_name(b1_progline + offset, len, &type);
-				if(err != B1_RES_OK)
-				{
-					return err;
-				}
+		sp++;
+	}
 
-				err = b1_tok_get(offset + len, 0, &td);
-				if(err != B1_RES_OK)
-				{
-					return err;
-				}
+	return B1_RES_OK;
+}
 
-				offset = td.offset;
-				len = td.length;
+// SORT statement: SORT <arr>[, <arr1>, ... <arrN>], sorts one-dimensional array in ascending order
+// rearranging elements of the next arrays (if any) the same way
+static B1_T_ERROR b1_int_st_sort(B1_T_INDEX offset)
+{
+	B1_T_ERROR err;
+	uint8_t a;
+	B1_TOKENDATA td;
+	B1_NAMED_VAR *vars[B1_MAX_SORT_ARR_NUM];
 
-				if(len == 0)
-				{
-					stop = 1;
-				}
-				else
-				if(len == 1 && B1_T_ISCOMMA(b1_progline[offset]))
-				{
-					// continue parsing string
-					stop = 0;
-				}
-				else
-				{
-					return B1_RES_ESYNTAX;
-				}
+	b1_int_sort_arr_num = 0;
+
+	while(1)
+	{
+		if(b1_int_sort_arr_num == B1_MAX_SORT_ARR_NUM)
+		{
+			return B1_RES_EWRARGCNT;
+		}
+
+		err = b1_int_get_arr_var(&offset, vars + b1_int_sort_arr_num);
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
+
+		for(a = 0; a < b1_int_sort_arr_num; a++)
+		{
+			if(vars[a] == vars[b1_int_sort_arr_num])
+			{
+				return B1_RES_EINVARG;
 			}
-			else
+		}
+
+		err = b1_var_array_get_info(vars[b1_int_sort_arr_num], 0, b1_int_sort_arrs + b1_int_sort_arr_num);
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
+
+		if(b1_int_sort_arrs[b1_int_sort_arr_num].dimnum != 1)
+		{
+			return B1_RES_EWSUBSCNT;
+		}
+
+		if(b1_int_sort_arrs[b1_int_sort_arr_num].size != b1_int_sort_arrs[0].size)
+		{
+			return B1_RES_ESUBSRANGE;
+		}
+
+		b1_int_sort_arr_num++;
+
+		err = b1_tok_get(offset, 0, &td);
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
+
+		if(td.length == 0)
+		{
+			break;
+		}
+
+		if(td.length != 1 || !B1_T_ISCOMMA(b1_progline[td.offset]))
+		{
+			return B1_RES_ESYNTAX;
+		}
+
+		offset = td.offset + 1;
+	}
+
+	// elements of non-allocated array are all equal
+	if(b1_int_sort_arrs[0].data_desc == B1_T_MEM_BLOCK_DESC_INVALID)
+	{
+		return B1_RES_OK;
+	}
+
+	return b1_int_sort_intro(b1_int_sort_arrs[0].size);
+}
+#endif
+
+// linen_index = 0 for simple GOTO statement, linen_index != 0 for ON ... GOTO statement
+// sets b1_next_line_num to line number to move control to
+static B1_T_ERROR b1_int_st_go(B1_T_INDEX offset, uint8_t linen_index)
+{
+	B1_T_ERROR err;
+	B1_TOKENDATA td;
+	B1_T_INDEX len;
+	uint8_t	i;
+
+	// get line number
+	i = 1;
+
+	while(1)
+	{
+		err = b1_tok_get_line_num(&offset);
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
+
+		if(b1_next_line_num == B1_T_LINE_NUM_ABSENT)
+		{
+			return B1_RES_ESYNTAX;
+		}
+
+		if(i == linen_index)
+		{
+			break;
+		}
+
+		err = b1_tok_get(offset, 0, &td);
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
+
+		offset = td.offset;
+		len = td.length;
+
+		if(!linen_index)
+		{
+			if(len)
 			{
 				return B1_RES_ESYNTAX;
 			}
+
+			break;
 		}
 
-		err = b1_t_get_type_by_type_spec(ts_char, type, &type);
-		if(err != B1_RES_OK)
-		{
-			return err;
-		}
+		if(!(td.type & B1_TOKEN_TYPE_OPERATION) && len != 1 && !B1_T_ISCOMMA(b1_progline[offset]))
+		{
+			return B1_RES_ESYNTAX;
+		}
+
+		offset += len;
+		i++;
+	}
+
+	return B1_RES_OK;
+}
+
+static B1_T_ERROR b1_int_st_if(B1_T_INDEX offset)
+{
+	B1_T_ERROR err;
+
+	// build RPN for the IF statement condition
+	err = b1_rpn_build(offset, IF_STOP_TOKENS, &offset);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	// no THEN clause found
+	if(!offset)
+	{
+		return B1_RES_ESYNTAX;
+	}
+
+	// evaluate the condition
+	err = b1_eval(0, NULL);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	if(!B1_TYPE_TEST_BOOL(b1_rpn_eval[0].type))
+	{
+		return B1_RES_ETYPMISM;
+	}
+
+	// only one stop token for IF statement ("THEN")
+	if(b1_rpn_eval[0].value.bval)
+	{
+		// add "THEN" keyword length
+		b1_curr_prog_line_offset = offset + (B1_T_INDEX)4;
+	}
+
+	return B1_RES_OK;
+}
+
+static B1_T_ERROR b1_int_st_on(B1_T_INDEX offset, uint8_t *result)
+{
+	B1_T_ERROR err;
+
+	err = b1_rpn_build(offset, ON_STOP_TOKENS, &b1_curr_prog_line_offset);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	// no GOTO (GOSUB) clause found
+	if(b1_curr_prog_line_offset == 0)
+	{
+		return B1_RES_ESYNTAX;
+	}
+
+	// evaluate the condition
+	err = b1_eval(0, NULL);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	err = b1_var_convert(b1_rpn_eval, B1_TYPE_INT);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	if(b1_rpn_eval[0].value.i32val > 0)
+		*result = (uint8_t)b1_rpn_eval[0].value.i32val;
+	else
+		return B1_RES_EINVARG;
+
+	return B1_RES_OK;
+}
+
+static B1_T_ERROR b1_int_save_stmt_state(uint8_t new_state)
+{
+	B1_INT_STMT_STK_REC *stk_rec;
 
-		// create variable
-#ifdef B1_FEATURE_DEBUG
-		err = b1_var_create(hash, type, dimsnum, subs_bounds, &var);
-		if(err != B1_RES_OK)
-		{
-			return err;
-		}
+	if(b1_int_stmt_stack_ptr == B1_MAX_STMT_NEST_DEPTH)
+	{
+		return B1_RES_ESTSTKOVF;
+	}
 
-		memcpy((*var).id.name + 1, b1_progline + id_off, id_len * B1_T_CHAR_SIZE);
-		(*var).id.name[0] = (B1_T_CHAR)id_len;
+	stk_rec = b1_int_stmt_stack + b1_int_stmt_stack_ptr;
+	b1_int_stmt_stack_ptr++;
+
+	(*stk_rec).state = b1_int_curr_stmt_state;
+	(*stk_rec).ret_line_cnt = b1_curr_prog_line_cnt;
+
+	b1_int_curr_stmt_state = new_state;
+
+	return B1_RES_OK;
+}
+
+static B1_T_ERROR b1_int_restore_stmt_state()
+{
+#ifdef B1_FEATURE_STMT_FUNCTION
+	// function body cannot unwind statements of the caller
+	if(b1_int_stmt_stack_ptr == b1_int_stmt_stack_base)
 #else
-		err = b1_var_create(hash, type, dimsnum, subs_bounds, NULL);
-		if(err != B1_RES_OK)
-		{
-			return err;
-		}
+	if(b1_int_stmt_stack_ptr == 0)
 #endif
+	{
+		return B1_RES_ESTSTKUDF;
+	}
 
-		offset += len;
-		if(stop) break;
+	b1_int_stmt_stack_ptr--;
+
+	// do no restore program line for IF statement
+	if(!(b1_int_curr_stmt_state & B1_INT_STATE_IF))
+	{
+		b1_curr_prog_line_cnt = (*(b1_int_stmt_stack + b1_int_stmt_stack_ptr)).ret_line_cnt;
 	}
 
+	b1_int_curr_stmt_state = (*(b1_int_stmt_stack + b1_int_stmt_stack_ptr)).state;
+
 	return B1_RES_OK;
 }
 
-#if defined(B1_FEATURE_STMT_ERASE) || defined(B1_FEATURE_INIT_FREE_MEMORY)
-B1_T_ERROR b1_int_var_mem_free(B1_NAMED_VAR *var)
+// options = 1 stands for ON/OFF value represented with 0/1/2 values: 0 = OFF, 1 = ON, 2 = <no_value>
+static B1_T_ERROR b1_int_st_option_set(B1_T_INDEX *offset, const B1_T_CHAR *s, uint8_t value_type, uint8_t options, uint8_t *value)
 {
 	B1_T_ERROR err;
-	uint8_t type, dimsnum;
-	B1_T_MEMOFFSET size, mem_size;
-	B1_T_MEM_BLOCK_DESC desc, arrdesc;
-	const B1_T_MEM_BLOCK_DESC *arrdata;
-	const B1_T_SUBSCRIPT *arrdescdata;
-	B1_T_SUBSCRIPT sub;
-	B1_T_INDEX i;
+	B1_TOKENDATA td;
+	B1_T_INDEX len;
+	uint16_t val;
 
-	// the variable exists, free it
-	type = (*var).var.type;
-	desc = (*var).var.value.mem_desc;
-	dimsnum = B1_IDENT_GET_FLAGS_ARGNUM((*var).id.flags);
+	err = b1_tok_get(*offset, 0, &td);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
 
-	if(dimsnum == 0)
+	len = td.length;
+
+	if(!b1_t_strcmpi(s, b1_progline + td.offset, len))
 	{
-		// free string data
-		if(type == B1_TYPE_SET(B1_TYPE_STRING, 0))
+		err = b1_tok_get(td.offset + len, B1_TOK_COPY_VALUE, &td);
+		if(err != B1_RES_OK)
 		{
-			b1_ex_mem_free(desc);
+			return err;
 		}
-	}
-	else
-	{
-		// free array data
-#ifdef B1_FEATURE_INIT_FREE_MEMORY
-		if(desc != B1_T_MEM_BLOCK_DESC_INVALID)
+
+		len = td.length;
+		*offset = td.offset;
+
+		if(len != 0 && !(td.type & value_type))
 		{
-#endif
-			err = b1_ex_mem_access(desc, 0, 0, B1_EX_MEM_READ, (void **)&arrdescdata);
+			return B1_RES_EINVARG;
+		}
+
+		if(value_type == B1_TOKEN_TYPE_NUMERIC)
+		{
+			if(len == 0 || len > 3)
+			{
+				return B1_RES_EINVARG;
+			}
+
+			b1_tmp_buf[len + 1] = 0;
+			err = b1_t_strtoui16(b1_tmp_buf + 1, &val);
 			if(err != B1_RES_OK)
 			{
 				return err;
 			}
 
-			// calc array size
-			size = 1;
-			while(dimsnum > 0)
+			if(val > UINT8_MAX)
 			{
-				dimsnum--;
-				sub = *arrdescdata++;
-				sub = *arrdescdata++ - sub;
-				size *= ((B1_T_MEMOFFSET)sub) + 1;
+				return B1_RES_EINVARG;
 			}
-			arrdesc = *((B1_T_MEM_BLOCK_DESC *)arrdescdata);
 
-			if(arrdesc != B1_T_MEM_BLOCK_DESC_INVALID)
+			*value = (uint8_t)val;
+		}
+		else
+		if(value_type == B1_TOKEN_TYPE_IDNAME)
+		{
+			if(options & 0x1)
 			{
-				// free array string data
-				if(B1_TYPE_TEST_STRING(type))
+				if(len == 0)
 				{
-					mem_size = size * (uint8_t)sizeof(B1_T_MEM_BLOCK_DESC);
-
-					for(size = 0, i = 0; size != mem_size; size += (uint8_t)sizeof(B1_T_MEM_BLOCK_DESC), i++)
-					{
-						if(i == ((B1_T_INDEX)(B1_MAX_STRING_LEN + 1)) / (uint8_t)sizeof(B1_T_MEM_BLOCK_DESC))
-						{
-							i = 0;
-						}
-
-						if(i == 0)
-						{
-							err = b1_ex_mem_access(arrdesc, size, (((B1_T_INDEX)(B1_MAX_STRING_LEN + 1)) / (uint8_t)sizeof(B1_T_MEM_BLOCK_DESC)) * (uint8_t)sizeof(B1_T_MEM_BLOCK_DESC), B1_EX_MEM_WRITE, (void **)&arrdata);
-							if(err != B1_RES_OK)
-							{
-								return err;
-							}
-						}
-
-						if(*(arrdata + i) != B1_T_MEM_BLOCK_DESC_INVALID)
-						{
-							b1_ex_mem_free(*(arrdata + i));
-						}
-					}
+					*value = 2;
+				}
+				else
+				if(!b1_t_strcmpi(_ON, b1_tmp_buf + 1, len))
+				{
+					*value = 1;
+				}
+				else
+				if(!b1_t_strcmpi(_OFF, b1_tmp_buf + 1, len))
+				{
+					*value = 0;
+				}
+				else
+				{
+					return B1_RES_EINVARG;
 				}
-
-				// free array data
-				b1_ex_mem_free(arrdesc);
 			}
-
-			// free array descriptor data
-			b1_ex_mem_free(desc);
-#ifdef B1_FEATURE_INIT_FREE_MEMORY
+			else
+			{
+				*value = (uint8_t)len;
+			}
+		}
+		else
+		{
+			return B1_RES_EINVARG;
 		}
-#endif
+	}
+	else
+	{
+		return B1_RES_EEOF;
 	}
 
 	return B1_RES_OK;
 }
-#endif
 
-#ifdef B1_FEATURE_STMT_ERASE
-static B1_T_ERROR b1_int_st_erase(B1_T_INDEX offset)
+static B1_T_ERROR b1_int_st_option(B1_T_INDEX offset)
 {
 	B1_T_ERROR err;
-	uint8_t next, type;
-	B1_TOKENDATA td;
-	B1_T_INDEX len;
-	B1_NAMED_VAR *var;
+	uint8_t value;
 
-	while(1)
+	err = b1_int_st_option_set(&offset, _BASE, B1_TOKEN_TYPE_NUMERIC, 0, &value);
+	if(err == B1_RES_OK)
 	{
-		// get variable name
-		err = b1_tok_get(offset, B1_TOK_CALC_HASH, &td);
-		if(err != B1_RES_OK)
+		if(value == 0)
 		{
-			return err;
+			b1_opt_base_val = 0;
 		}
-
-		type = td.type;
-		offset = td.offset;
-		len = td.length;
-		if(len == 0)
+		else
+		if(value == 1)
 		{
-			return B1_RES_ESYNTAX;
+			b1_opt_base_val = 1;
 		}
-
-		if(!(type & B1_TOKEN_TYPE_IDNAME))
+		else
 		{
-			return B1_RES_EINVTOK;
+			return B1_RES_EINVARG;
 		}
 
-		offset += len;
-
-		err = b1_tok_get(offset, 0, &td);
-		if(err != B1_RES_OK)
-		{
-			return err;
-		}
+		return B1_RES_OK;
+	}
+	else
+	if(err != B1_RES_EEOF)
+	{
+		return err;
+	}
 
-		offset = td.offset;
-		len = td.length;
-		next = (len == 1) && B1_T_ISCOMMA(*(b1_progline + offset));
-		if(!next && len != 0)
+	err = b1_int_st_option_set(&offset, _EXPLICIT, B1_TOKEN_TYPE_IDNAME, 1, &value);
+	if(err == B1_RES_OK)
+	{
+		// omitted value corresponds to ON
+		if(value == 0)
 		{
-			return B1_RES_ESYNTAX;
+			b1_opt_explicit_val = 0;
 		}
-		offset++;
-
-		err = b1_ex_var_alloc(b1_tok_id_hash, &var);
-		if(err != B1_RES_OK && err != B1_RES_EIDINUSE)
+		else
+		if(value <= 2)
 		{
-			return err;
+			b1_opt_explicit_val = 1;
 		}
-
-		err = b1_int_var_mem_free(var);
-		if(err != B1_RES_OK)
+		else
 		{
-			return err;
+			return B1_RES_EINVARG;
 		}
 
-		// release variable memory
-		b1_ex_var_free(b1_tok_id_hash);
-
-		if(!next) break;
+		return B1_RES_OK;
+	}
+	else
+	if(err == B1_RES_EEOF)
+	{
+		return B1_RES_EINVSTAT;
 	}
 
 	return B1_RES_OK;
 }
-#endif
 
-// linen_index = 0 for simple GOTO statement, linen_index != 0 for ON ... GOTO statement
-// sets b1_next_line_num to line number to move control to
-static B1_T_ERROR b1_int_st_go(B1_T_INDEX offset, uint8_t linen_index)
+#define B1_INT_ST_FOR_INTVAR_CREATE 0x0
+#define B1_INT_ST_FOR_INTVAR_ACCESS 0x1
+#define B1_INT_ST_FOR_INTVAR_FREE 0x2
+
+static B1_T_ERROR b1_int_st_for_get_intvar(uint8_t var_hash_base, uint8_t var_op, uint8_t var_type, B1_VAR_REF *var_ref)
 {
 	B1_T_ERROR err;
-	B1_TOKENDATA td;
-	B1_T_INDEX len;
-	uint8_t	i;
-
-	// get line number
-	i = 1;
-
-	while(1)
-	{
-		err = b1_tok_get_line_num(&offset);
-		if(err != B1_RES_OK)
-		{
-			return err;
-		}
+	B1_NAMED_VAR *var;
 
-		if(b1_next_line_num == B1_T_LINE_NUM_ABSENT)
-		{
-			return B1_RES_ESYNTAX;
-		}
+	var_hash_base += b1_int_stmt_stack_ptr - 1;
 
-		if(i == linen_index)
-		{
-			break;
-		}
+	err = b1_var_create(var_hash_base, var_type, 0, NULL, &var);
 
-		err = b1_tok_get(offset, 0, &td);
+	if(var_op == B1_INT_ST_FOR_INTVAR_CREATE)
+	{
 		if(err != B1_RES_OK)
 		{
 			return err;
 		}
 
-		offset = td.offset;
-		len = td.length;
+#ifdef B1_FEATURE_DEBUG
+		memcpy((*var).id.name, _DBG_FORVAR, (((B1_T_INDEX)_DBG_FORVAR[0]) + 1) * B1_T_CHAR_SIZE);
+#endif
 
-		if(!linen_index)
-		{
-			if(len)
-			{
-				return B1_RES_ESYNTAX;
-			}
+		(*var_ref).var = var;
 
-			break;
-		}
+		return b1_var_set(b1_rpn_eval, var_ref);
+	}
 
-		if(!(td.type & B1_TOKEN_TYPE_OPERATION) && len != 1 && !B1_T_ISCOMMA(b1_progline[offset]))
-		{
-			return B1_RES_ESYNTAX;
-		}
+	if(err != B1_RES_EIDINUSE)
+	{
+		return err;
+	}
 
-		offset += len;
-		i++;
+	if(var_op == B1_INT_ST_FOR_INTVAR_ACCESS)
+	{
+		b1_rpn_eval[1] = (*var).var;
+	}
+	else
+	if(var_op == B1_INT_ST_FOR_INTVAR_FREE)
+	{
+#ifdef B1_FEATURE_VAR_SLOTS
+		b1_var_slot_free(var_hash_base);
+#endif
+		b1_ex_var_free(var_hash_base);
 	}
 
 	return B1_RES_OK;
 }
 
-static B1_T_ERROR b1_int_st_if(B1_T_INDEX offset)
+static B1_T_ERROR b1_int_st_for_start(B1_T_INDEX offset)
 {
+	//LET own1 = limit
+	//LET own2 = increment
+	//LET v = initial-value
+
 	B1_T_ERROR err;
+	uint8_t type;
+	B1_VAR_REF var_ref;
 
-	// build RPN for the IF statement condition
-	err = b1_rpn_build(offset, IF_STOP_TOKENS, &offset);
+	// get initial value of loop control variable
+	err = b1_int_st_let(offset, &var_ref, FOR_STOP_TOKEN1, &offset);
 	if(err != B1_RES_OK)
 	{
 		return err;
 	}
 
-	// no THEN clause found
-	if(!offset)
+	// no "TO" keyword
+	if(offset == 0)
 	{
 		return B1_RES_ESYNTAX;
 	}
 
-	// evaluate the condition
-	err = b1_eval(0, NULL);
-	if(err != B1_RES_OK)
-	{
-		return err;
-	}
+	(*(b1_int_stmt_stack + b1_int_stmt_stack_ptr - 1)).var = var_ref.var;
 
-	if(!B1_TYPE_TEST_BOOL(b1_rpn_eval[0].type))
+	// save control variable name hash and forbid using arrays and non-numeric variables as loop control variable
+	if(B1_IDENT_GET_FLAGS_ARGNUM((*var_ref.var).id.flags) != 0)
 	{
-		return B1_RES_ETYPMISM;
+		return B1_RES_EFORSUBSVAR;
 	}
 
-	// only one stop token for IF statement ("THEN")
-	if(b1_rpn_eval[0].value.bval)
+	type = B1_TYPE_GET((*var_ref.var).var.type);
+	
+	if(!B1_TYPE_TEST_NUMERIC(type))
 	{
-		// add "THEN" keyword length
-		b1_curr_prog_line_offset = offset + (B1_T_INDEX)4;
+		return B1_RES_ETYPMISM;
 	}
 
-	return B1_RES_OK;
-}
-
-static B1_T_ERROR b1_int_st_on(B1_T_INDEX offset, uint8_t *result)
-{
-	B1_T_ERROR err;
+	// skip "TO" keyword
+	offset += 2;
 
-	err = b1_rpn_build(offset, ON_STOP_TOKENS, &b1_curr_prog_line_offset);
+	// build RPN for limit expression
+	err = b1_rpn_build(offset, FOR_STOP_TOKEN2, &offset);
 	if(err != B1_RES_OK)
 	{
 		return err;
 	}
 
-	// no GOTO (GOSUB) clause found
-	if(b1_curr_prog_line_offset == 0)
-	{
-		return B1_RES_ESYNTAX;
-	}
-
-	// evaluate the condition
+	// evaluate limit
 	err = b1_eval(0, NULL);
 	if(err != B1_RES_OK)
 	{
 		return err;
 	}
 
-	err = b1_var_convert(b1_rpn_eval, B1_TYPE_INT);
+	if(!B1_TYPE_TEST_NUMERIC(b1_rpn_eval[0].type))
+	{
+		return B1_RES_ETYPMISM;
+	}
+
+	// create special variable for limit value
+	err = b1_int_st_for_get_intvar(0, B1_INT_ST_FOR_INTVAR_CREATE, type, &var_ref);
 	if(err != B1_RES_OK)
 	{
 		return err;
 	}
 
-	if(b1_rpn_eval[0].value.i32val > 0)
-		*result = (uint8_t)b1_rpn_eval[0].value.i32val;
-	else
-		return B1_RES_EINVARG;
-
-	return B1_RES_OK;
-}
-
-static B1_T_ERROR b1_int_save_stmt_state(uint8_t new_state)
-{
-	B1_INT_STMT_STK_REC *stk_rec;
-
-	if(b1_int_stmt_stack_ptr == B1_MAX_STMT_NEST_DEPTH)
+	// check for "STEP" keyword presence
+	if(offset != 0)
 	{
-		return B1_RES_ESTSTKOVF;
-	}
+		// skip "STEP" keyword
+		offset += 4;
 
-	stk_rec = b1_int_stmt_stack + b1_int_stmt_stack_ptr;
-	b1_int_stmt_stack_ptr++;
+		// build RPN for step expression
+		err = b1_rpn_build(offset, NULL, &offset);
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
 
-	(*stk_rec).state = b1_int_curr_stmt_state;
-	(*stk_rec).ret_line_cnt = b1_curr_prog_line_cnt;
+		// step value expression should be the last in the line
+		if(offset != 0)
+		{
+			return B1_RES_ESYNTAX;
+		}
 
-	b1_int_curr_stmt_state = new_state;
+		// evaluate step value
+		err = b1_eval(0, NULL);
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
 
-	return B1_RES_OK;
-}
+		// set step negative flag
+		b1_rpn_eval[1] = b1_rpn_eval[0];
 
-static B1_T_ERROR b1_int_restore_stmt_state()
-{
-	if(b1_int_stmt_stack_ptr == 0)
-	{
-		return B1_RES_ESTSTKUDF;
-	}
+		err = b1_var_init_empty(B1_TYPE_GET(b1_rpn_eval[0].type), 0, NULL, b1_rpn_eval + 2);
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
 
-	b1_int_stmt_stack_ptr--;
+		err = b1_eval_cmp(b1_rpn_eval + 1, B1_T_C_LT, 0, B1_TYPE_GET(b1_rpn_eval[0].type));
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
 
-	// do no restore program line for IF statement
-	if(!(b1_int_curr_stmt_state & B1_INT_STATE_IF))
+		if(b1_rpn_eval[1].value.bval)
+		{
+			b1_int_curr_stmt_state |= B1_INT_STATE_FOR_NEG_STEP;
+		}
+	}
+	else
 	{
-		b1_curr_prog_line_cnt = (*(b1_int_stmt_stack + b1_int_stmt_stack_ptr)).ret_line_cnt;
+		// step = 1
+		b1_rpn_eval[0].type = type;
+#ifdef B1_FEATURE_TYPE_SINGLE
+		if(type == B1_TYPE_SINGLE)
+			b1_rpn_eval[0].value.sval = 1.0f;
+		else
+#endif
+#ifdef B1_FEATURE_TYPE_DOUBLE
+		if(type == B1_TYPE_DOUBLE)
+			b1_rpn_eval[0].value.dval = 1.0;
+		else
+#endif
+		if(type == B1_TYPE_INT)
+			b1_rpn_eval[0].value.i32val = 1;
+#ifdef B1_FEATURE_TYPE_SMALL
+		else
+		if(type == B1_TYPE_INT16)
+			b1_rpn_eval[0].value.i16val = 1;
+		else
+		if(type == B1_TYPE_WORD)
+			b1_rpn_eval[0].value.ui16val = 1;
+		else
+		if(type == B1_TYPE_BYTE)
+			b1_rpn_eval[0].value.ui8val = 1;
+#endif
 	}
 
-	b1_int_curr_stmt_state = (*(b1_int_stmt_stack + b1_int_stmt_stack_ptr)).state;
-
-	return B1_RES_OK;
+	return b1_int_st_for_get_intvar(0x80, B1_INT_ST_FOR_INTVAR_CREATE, type, &var_ref);
 }
 
-// options = 1 stands for ON/OFF value represented with 0/1/2 values: 0 = OFF, 1 = ON, 2 = <no_value>
-static B1_T_ERROR b1_int_st_option_set(B1_T_INDEX *offset, const B1_T_CHAR *s, uint8_t value_type, uint8_t options, uint8_t *value)
+static B1_T_ERROR b1_int_st_for_end()
 {
+	// dispose own1 (limit) and own2 (step) variables
+
 	B1_T_ERROR err;
-	B1_TOKENDATA td;
-	B1_T_INDEX len;
-	uint16_t val;
 
-	err = b1_tok_get(*offset, 0, &td);
+	// free internal loop variables
+	err = b1_int_st_for_get_intvar(0, B1_INT_ST_FOR_INTVAR_FREE, 0, NULL);
 	if(err != B1_RES_OK)
 	{
 		return err;
 	}
 
-	len = td.length;
-
-	if(!b1_t_strcmpi(s, b1_progline + td.offset, len))
-	{
-		err = b1_tok_get(td.offset + len, B1_TOK_COPY_VALUE, &td);
-		if(err != B1_RES_OK)
-		{
-			return err;
-		}
+	return b1_int_st_for_get_intvar(0x80, B1_INT_ST_FOR_INTVAR_FREE, 0, NULL);
+}
 
-		len = td.length;
-		*offset = td.offset;
+static B1_T_ERROR b1_int_st_for_test()
+{
+	//IF (v-limit) * SGN (step) > 0 THEN line2
 
-		if(len != 0 && !(td.type & value_type))
-		{
-			return B1_RES_EINVARG;
-		}
+	B1_T_ERROR err;
+	uint8_t negstep, stop;
+	B1_INT_STMT_STK_REC *stk_rec;
 
-		if(value_type == B1_TOKEN_TYPE_NUMERIC)
-		{
-			if(len == 0 || len > 3)
-			{
-				return B1_RES_EINVARG;
-			}
+#ifdef B1_FEATURE_TYPE_SMALL
+	// extra loop exit condition for unsigned data types
+	stop = (b1_int_curr_stmt_state & B1_INT_STATE_FOR_STOP);
 
-			b1_tmp_buf[len + 1] = 0;
-			err = b1_t_strtoui16(b1_tmp_buf + 1, &val);
-			if(err != B1_RES_OK)
-			{
-				return err;
-			}
+	if(!stop)
+	{
+#endif
+		negstep = b1_int_curr_stmt_state & B1_INT_STATE_FOR_NEG_STEP;
 
-			if(val > UINT8_MAX)
-			{
-				return B1_RES_EINVARG;
-			}
+		stk_rec = b1_int_stmt_stack + b1_int_stmt_stack_ptr - 1;
+		b1_rpn_eval[0] = (*(*stk_rec).var).var;
 
-			*value = (uint8_t)val;
-		}
-		else
-		if(value_type == B1_TOKEN_TYPE_IDNAME)
+		// get limit
+		err = b1_int_st_for_get_intvar(0, B1_INT_ST_FOR_INTVAR_ACCESS, 0, NULL);
+		if (err != B1_RES_OK)
 		{
-			if(options & 0x1)
-			{
-				if(len == 0)
-				{
-					*value = 2;
-				}
-				else
-				if(!b1_t_strcmpi(_ON, b1_tmp_buf + 1, len))
-				{
-					*value = 1;
-				}
-				else
-				if(!b1_t_strcmpi(_OFF, b1_tmp_buf + 1, len))
-				{
-					*value = 0;
-				}
-				else
-				{
-					return B1_RES_EINVARG;
-				}
-			}
-			else
-			{
-				*value = (uint8_t)len;
-			}
+			return err;
 		}
-		else
+
+		err = b1_eval_cmp(b1_rpn_eval, negstep ? B1_T_C_LT : B1_T_C_GT, 0, b1_rpn_eval[0].type);
+		if (err != B1_RES_OK)
 		{
-			return B1_RES_EINVARG;
+			return err;
 		}
-	}
-	else
-	{
-		return B1_RES_EEOF;
-	}
 
-	return B1_RES_OK;
-}
+		stop = b1_rpn_eval[0].value.bval;
 
-static B1_T_ERROR b1_int_st_option(B1_T_INDEX offset)
-{
-	B1_T_ERROR err;
-	uint8_t value;
+#ifdef B1_FEATURE_TYPE_SMALL
+	}
+#endif
 
-	err = b1_int_st_option_set(&offset, _BASE, B1_TOKEN_TYPE_NUMERIC, 0, &value);
-	if(err == B1_RES_OK)
+	if(stop)
 	{
-		if(value == 0)
+		err = b1_int_st_for_end();
+		if(err != B1_RES_OK)
 		{
-			b1_opt_base_val = 0;
+			return err;
 		}
-		else
-		if(value == 1)
+
+		err = b1_int_restore_stmt_state();
+		if(err != B1_RES_OK)
 		{
-			b1_opt_base_val = 1;
+			return err;
 		}
-		else
+
+		err = b1_ex_prg_for_go_next();
+		if(err != B1_RES_OK)
 		{
-			return B1_RES_EINVARG;
+			return err;
 		}
-
-		return B1_RES_OK;
 	}
 	else
-	if(err != B1_RES_EEOF)
 	{
-		return err;
-	}
+#ifdef B1_FEATURE_TYPE_SMALL
+		// check if the loop control variable has reached its limit value (is necessary for unsigned types)
+		b1_rpn_eval[0] = (*(*stk_rec).var).var;
 
-	err = b1_int_st_option_set(&offset, _EXPLICIT, B1_TOKEN_TYPE_IDNAME, 1, &value);
-	if(err == B1_RES_OK)
-	{
-		// omitted value corresponds to ON
-		if(value == 0)
-		{
-			b1_opt_explicit_val = 0;
-		}
-		else
-		if(value <= 2)
+		err = b1_eval_cmp(b1_rpn_eval, B1_T_C_EQ, 0, b1_rpn_eval[0].type);
+		if(err != B1_RES_OK)
 		{
-			b1_opt_explicit_val = 1;
+			return err;
 		}
-		else
+
+		if(b1_rpn_eval[0].value.bval)
 		{
-			return B1_RES_EINVARG;
+			b1_int_curr_stmt_state |= B1_INT_STATE_FOR_STOP;
 		}
-
-		return B1_RES_OK;
-	}
-	else
-	if(err == B1_RES_EEOF)
-	{
-		return B1_RES_EINVSTAT;
+#endif
+		// set program line counter to the first line of the loop body
+		b1_curr_prog_line_cnt = (*stk_rec).ret_line_cnt;
 	}
 
 	return B1_RES_OK;
 }
 
-#define B1_INT_ST_FOR_INTVAR_CREATE 0x0
-#define B1_INT_ST_FOR_INTVAR_ACCESS 0x1
-#define B1_INT_ST_FOR_INTVAR_FREE 0x2
-
-static B1_T_ERROR b1_int_st_for_get_intvar(uint8_t var_hash_base, uint8_t var_op, uint8_t var_type, B1_VAR_REF *var_ref)
+static B1_T_ERROR b1_int_st_for_next(B1_T_INDEX offset)
 {
+	//LET v = v + own2
+	//GOTO line1
+
 	B1_T_ERROR err;
+	B1_VAR_REF var_ref;
+	B1_TOKENDATA td;
 	B1_NAMED_VAR *var;
 
-	var_hash_base += b1_int_stmt_stack_ptr - 1;
-
-	err = b1_var_create(var_hash_base, var_type, 0, NULL, &var);
+	var = (*(b1_int_stmt_stack + b1_int_stmt_stack_ptr - 1)).var;
 
-	if(var_op == B1_INT_ST_FOR_INTVAR_CREATE)
+	// check NEXT statement control variable if specified
+	if(!(b1_int_curr_stmt_state & B1_INT_STATE_FOR_NEXT_CHECKED))
 	{
+		b1_int_curr_stmt_state |= B1_INT_STATE_FOR_NEXT_CHECKED;
+		
+		err = b1_tok_get(offset, B1_TOK_CALC_HASH, &td);
 		if(err != B1_RES_OK)
 		{
 			return err;
 		}
 
-#ifdef B1_FEATURE_DEBUG
-		memcpy((*var).id.name, _DBG_FORVAR, (((B1_T_INDEX)_DBG_FORVAR[0]) + 1) * B1_T_CHAR_SIZE);
-#endif
-
-		(*var_ref).var = var;
+		if(td.length != 0)
+		{
+			if(!(td.type & B1_TOKEN_TYPE_IDNAME))
+			{
+				return B1_RES_EINVTOK;
+			}
 
-		return b1_var_set(b1_rpn_eval, var_ref);
+			if(b1_tok_id_hash != (*var).id.name_hash)
+			{
+				return B1_RES_ENXTWOFOR;
+			}
+		}
 	}
 
-	if(err != B1_RES_EIDINUSE)
+	err = b1_int_st_for_get_intvar(0x80, B1_INT_ST_FOR_INTVAR_ACCESS, 0, NULL);
+	if(err != B1_RES_OK)
 	{
 		return err;
 	}
 
-	if(var_op == B1_INT_ST_FOR_INTVAR_ACCESS)
-	{
-		b1_rpn_eval[1] = (*var).var;
-	}
-	else
-	if(var_op == B1_INT_ST_FOR_INTVAR_FREE)
+	b1_rpn_eval[0] = (*var).var;
+	err = b1_eval_add(b1_rpn_eval, b1_rpn_eval[0].type);
+	if(err != B1_RES_OK)
 	{
-		b1_ex_var_free(var_hash_base);
+		return err;
 	}
 
-	return B1_RES_OK;
+	var_ref.var = var;
+	var_ref.val_off = 0;
+	err = b1_var_set(b1_rpn_eval, &var_ref);
+
+	return err;
 }
 
-static B1_T_ERROR b1_int_st_for_start(B1_T_INDEX offset)
+#ifdef B1_FEATURE_FUNCTIONS_USER
+static B1_T_INDEX b1_int_find_hash(const B1_T_IDHASH *hashes, B1_T_INDEX hash_num, B1_T_IDHASH hash)
 {
-	//LET own1 = limit
-	//LET own2 = increment
-	//LET v = initial-value
-
-	B1_T_ERROR err;
-	uint8_t type;
-	B1_VAR_REF var_ref;
+	B1_T_INDEX i;
 
-	// get initial value of loop control variable
-	err = b1_int_st_let(offset, &var_ref, FOR_STOP_TOKEN1, &offset);
-	if(err != B1_RES_OK)
+	for(i = 0; i < hash_num; i++)
 	{
-		return err;
+		if(*(hashes + i) == hash)
+		{
+			break;
+		}
 	}
 
-	// no "TO" keyword
-	if(offset == 0)
-	{
-		return B1_RES_ESYNTAX;
-	}
+	return i;
+}
 
-	(*(b1_int_stmt_stack + b1_int_stmt_stack_ptr - 1)).var = var_ref.var;
+// <fn_name>[(<arg1_name[, arg2_name, ...argN_name]>)] header of DEF and FUNCTION statements, creates new
+// user function, on exit offset points to the header end
+static B1_T_ERROR b1_int_fn_header(B1_T_INDEX *offset, B1_UDEF_FN **fn_ptr, B1_T_IDHASH *arg_hashes)
+{
+	B1_T_ERROR err;
+	B1_TOKENDATA td;
+	B1_T_INDEX i, len;
+	uint8_t argnum;
+	B1_UDEF_FN *fn;
 
-	// save control variable name hash and forbid using arrays and non-numeric variables as loop control variable
-	if(B1_IDENT_GET_FLAGS_ARGNUM((*var_ref.var).id.flags) != 0)
+	// get function name
+	err = b1_tok_get(*offset, B1_TOK_CALC_HASH, &td);
+	if(err != B1_RES_OK)
 	{
-		return B1_RES_EFORSUBSVAR;
+		return err;
 	}
 
-	type = B1_TYPE_GET((*var_ref.var).var.type);
-	
-	if(!B1_TYPE_TEST_NUMERIC(type))
+	if(!(td.type & B1_TOKEN_TYPE_IDNAME))
 	{
-		return B1_RES_ETYPMISM;
+		return B1_RES_EINVTOK;
 	}
 
-	// skip "TO" keyword
-	offset += 2;
+	*offset = td.offset + td.length;
 
-	// build RPN for limit expression
-	err = b1_rpn_build(offset, FOR_STOP_TOKEN2, &offset);
-	if(err != B1_RES_OK)
+	// check for existence
+	err = b1_fn_get_params(b1_tok_id_hash, 1, (B1_FN **)fn_ptr);
+	if(err == B1_RES_OK)
 	{
-		return err;
+		return B1_RES_EIDINUSE;
 	}
 
-	// evaluate limit
-	err = b1_eval(0, NULL);
-	if(err != B1_RES_OK)
+	if(err != B1_RES_EUNKIDENT)
 	{
 		return err;
 	}
 
-	if(!B1_TYPE_TEST_NUMERIC(b1_rpn_eval[0].type))
-	{
-		return B1_RES_ETYPMISM;
-	}
+	fn = *fn_ptr;
 
-	// create special variable for limit value
-	err = b1_int_st_for_get_intvar(0, B1_INT_ST_FOR_INTVAR_CREATE, type, &var_ref);
+	// create new user function
+	(*fn).fn.id.name_hash = b1_tok_id_hash;
+	(*fn).fn.id.flags = B1_IDENT_FLAGS_SET_FN(0, 0);
+	b1_t_get_type_by_type_spec(b1_progline[*offset - 1], B1_TYPE_NULL, &(*fn).fn.ret_type);
+#ifdef B1_FEATURE_FUNCTIONS_USER_MEMO
+	(*fn).memo = 0;
+#endif
+
+	err = b1_tok_get(*offset, 0, &td);
 	if(err != B1_RES_OK)
 	{
 		return err;
 	}
 
-	// check for "STEP" keyword presence
-	if(offset != 0)
+	if(td.length != 1 || b1_progline[td.offset] != B1_T_C_OPBRACK)
 	{
-		// skip "STEP" keyword
-		offset += 4;
+		return B1_RES_OK;
+	}
 
-		// build RPN for step expression
-		err = b1_rpn_build(offset, NULL, &offset);
+	*offset = td.offset + td.length;
+
+	argnum = 0;
+
+	// read function arguments
+	while(1)
+	{
+		err = b1_tok_get(*offset, B1_TOK_CALC_HASH, &td);
 		if(err != B1_RES_OK)
 		{
 			return err;
 		}
 
-		// step value expression should be the last in the line
-		if(offset != 0)
+		len = td.length;
+
+		if(!(td.type & B1_TOKEN_TYPE_IDNAME))
 		{
 			return B1_RES_ESYNTAX;
 		}
 
-		// evaluate step value
-		err = b1_eval(0, NULL);
-		if(err != B1_RES_OK)
+		if(argnum == B1_MAX_FN_ARGS_NUM)
 		{
-			return err;
+			return B1_RES_EWRARGCNT;
 		}
 
-		// set step negative flag
-		b1_rpn_eval[1] = b1_rpn_eval[0];
+		// process function argument
+		i = b1_int_find_hash(arg_hashes, argnum, b1_tok_id_hash);
+		if(i != argnum)
+		{
+			return B1_RES_EIDINUSE;
+		}
 
-		err = b1_var_init_empty(B1_TYPE_GET(b1_rpn_eval[0].type), 0, NULL, b1_rpn_eval + 2);
+#if defined(B1_FEATURE_STMT_FUNCTION) && defined(B1_FEATURE_DEBUG)
+		(*fn).arg_offsets[argnum] = td.offset;
+		(*fn).arg_lengths[argnum] = len;
+#endif
+
+		*offset = td.offset + len;
+		b1_t_get_type_by_type_spec(b1_progline[*offset - 1], B1_TYPE_NULL, &(*fn).fn.argtypes[argnum]);
+
+		arg_hashes[argnum] = b1_tok_id_hash;
+		argnum++;
+
+		err = b1_tok_get(*offset, 0, &td);
 		if(err != B1_RES_OK)
 		{
 			return err;
 		}
 
-		err = b1_eval_cmp(b1_rpn_eval + 1, B1_T_C_LT, 0, B1_TYPE_GET(b1_rpn_eval[0].type));
-		if(err != B1_RES_OK)
+		if(td.length != 1 || !(td.type & B1_TOKEN_TYPE_OPERATION))
 		{
-			return err;
+			return B1_RES_ESYNTAX;
 		}
 
-		if(b1_rpn_eval[1].value.bval)
+		*offset = td.offset + td.length;
+
+		if(b1_progline[td.offset] == B1_T_C_CLBRACK)
 		{
-			b1_int_curr_stmt_state |= B1_INT_STATE_FOR_NEG_STEP;
+			break;
+		}
+
+		if(!B1_T_ISCOMMA(b1_progline[td.offset]))
+		{
+			return B1_RES_ESYNTAX;
 		}
 	}
-	else
+
+	(*fn).fn.id.flags = B1_IDENT_FLAGS_SET_FN(argnum, 0);
+
+	return B1_RES_OK;
+}
+
+// copies DEF expression token text to b1_fn_udef_fn_text buffer (b1_progline points to the buffer while the
+// function is evaluated), the token offset is changed to point to the copy
+static B1_T_ERROR b1_int_st_def_copy_text(B1_T_INDEX *offset, B1_T_INDEX len)
+{
+	if(len >= B1_MAX_UDEF_FN_TEXT_LEN - b1_fn_udef_fn_text_off)
 	{
-		// step = 1
-		b1_rpn_eval[0].type = type;
-#ifdef B1_FEATURE_TYPE_SINGLE
-		if(type == B1_TYPE_SINGLE)
-			b1_rpn_eval[0].value.sval = 1.0f;
-		else
-#endif
-#ifdef B1_FEATURE_TYPE_DOUBLE
-		if(type == B1_TYPE_DOUBLE)
-			b1_rpn_eval[0].value.dval = 1.0;
-		else
-#endif
-		if(type == B1_TYPE_INT)
-			b1_rpn_eval[0].value.i32val = 1;
-#ifdef B1_FEATURE_TYPE_SMALL
-		else
-		if(type == B1_TYPE_INT16)
-			b1_rpn_eval[0].value.i16val = 1;
-		else
-		if(type == B1_TYPE_WORD)
-			b1_rpn_eval[0].value.ui16val = 1;
-		else
-		if(type == B1_TYPE_BYTE)
-			b1_rpn_eval[0].value.ui8val = 1;
-#endif
+		return B1_RES_EMANYDEF;
 	}
 
-	return b1_int_st_for_get_intvar(0x80, B1_INT_ST_FOR_INTVAR_CREATE, type, &var_ref);
+	memcpy(b1_fn_udef_fn_text + b1_fn_udef_fn_text_off, b1_progline + *offset, len * B1_T_CHAR_SIZE);
+	*offset = b1_fn_udef_fn_text_off;
+	b1_fn_udef_fn_text_off += len;
+	// terminate the token
+	b1_fn_udef_fn_text[b1_fn_udef_fn_text_off++] = 0;
+
+	return B1_RES_OK;
 }
 
-static B1_T_ERROR b1_int_st_for_end()
+// DEF <fn_name>[(<arg1_name[, arg2_name, ...argN_name]>)] = <expression>
+static B1_T_ERROR b1_int_st_def(B1_T_INDEX offset, B1_T_PROG_LINE_CNT def_line_cnt)
 {
-	// dispose own1 (limit) and own2 (step) variables
-
 	B1_T_ERROR err;
+	B1_TOKENDATA td;
+	B1_T_INDEX i, len;
+	B1_T_IDHASH arg_hashes[B1_MAX_FN_ARGS_NUM];
+	uint8_t argnum, tflags;
+	B1_UDEF_FN *fn;
+	B1_RPNREC *rpnrec;
+#ifdef B1_FEATURE_FUNCTIONS_USER_MEMO
+	uint8_t pure;
+	B1_FN *fn1;
 
-	// free internal loop variables
-	err = b1_int_st_for_get_intvar(0, B1_INT_ST_FOR_INTVAR_FREE, 0, NULL);
+	pure = 1;
+#endif
+
+	err = b1_int_fn_header(&offset, &fn, arg_hashes);
 	if(err != B1_RES_OK)
 	{
 		return err;
 	}
 
-	return b1_int_st_for_get_intvar(0x80, B1_INT_ST_FOR_INTVAR_FREE, 0, NULL);
-}
-
-static B1_T_ERROR b1_int_st_for_test()
-{
-	//IF (v-limit) * SGN (step) > 0 THEN line2
+	argnum = B1_IDENT_GET_FLAGS_ARGNUM((*fn).fn.id.flags);
 
-	B1_T_ERROR err;
-	uint8_t negstep, stop;
-	B1_INT_STMT_STK_REC *stk_rec;
+	err = b1_tok_get(offset, 0, &td);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
 
-#ifdef B1_FEATURE_TYPE_SMALL
-	// extra loop exit condition for unsigned data types
-	stop = (b1_int_curr_stmt_state & B1_INT_STATE_FOR_STOP);
+	if(td.length != 1 || b1_progline[td.offset] != B1_T_C_EQ)
+	{
+		return B1_RES_ESYNTAX;
+	}
 
-	if(!stop)
+	// build function expression RPN
+	err = b1_rpn_build(td.offset + td.length, NULL, NULL);
+	if(err != B1_RES_OK)
 	{
-#endif
-		negstep = b1_int_curr_stmt_state & B1_INT_STATE_FOR_NEG_STEP;
+		return err;
+	}
 
-		stk_rec = b1_int_stmt_stack + b1_int_stmt_stack_ptr - 1;
-		b1_rpn_eval[0] = (*(*stk_rec).var).var;
+	// save function RPN
+	i = 0;
 
-		// get limit
-		err = b1_int_st_for_get_intvar(0, B1_INT_ST_FOR_INTVAR_ACCESS, 0, NULL);
-		if (err != B1_RES_OK)
+	(*fn).def_line_cnt = def_line_cnt;
+	(*fn).rpn_start_pos = b1_fn_udef_fn_rpn_off;
+
+	while(1)
+	{
+		tflags = (*(b1_rpn + i)).flags;
+
+		if(tflags == 0)
 		{
-			return err;
+			if(i == 0)
+			{
+				return B1_RES_ESYNTAX;
+			}
+
+			break;
 		}
 
-		err = b1_eval_cmp(b1_rpn_eval, negstep ? B1_T_C_LT : B1_T_C_GT, 0, b1_rpn_eval[0].type);
-		if (err != B1_RES_OK)
+		if(b1_fn_udef_fn_rpn_off > B1_MAX_UDEF_FN_RPN_LEN - 1)
 		{
-			return err;
+			return B1_RES_EMANYDEF;
 		}
 
-		stop = b1_rpn_eval[0].value.bval;
-
-#ifdef B1_FEATURE_TYPE_SMALL
-	}
-#endif
+		rpnrec = b1_fn_udef_fn_rpn + b1_fn_udef_fn_rpn_off;
 
-	if(stop)
-	{
-		err = b1_int_st_for_end();
-		if(err != B1_RES_OK)
-		{
-			return err;
-		}
+		memcpy(rpnrec, b1_rpn + i, sizeof(B1_RPNREC));
 
-		err = b1_int_restore_stmt_state();
-		if(err != B1_RES_OK)
+		if(tflags == (B1_RPNREC_TYPE_FNVAR | (uint8_t)(0 << (B1_RPNREC_FN_ARG_INDEX_SHIFT))))
 		{
-			return err;
+			len = b1_int_find_hash(arg_hashes, argnum, (*rpnrec).data.id.hash);
+			if(len != argnum)
+			{
+				(*rpnrec).flags = B1_RPNREC_TYPE_FN_ARG | (uint8_t)(len << (B1_RPNREC_FN_ARG_INDEX_SHIFT));
+			}
 		}
 
-		err = b1_ex_prg_for_go_next();
-		if(err != B1_RES_OK)
+		// constants (and identifier names in debug builds) are read from the program line when the
+		// function is evaluated, copy them
+		tflags = (*rpnrec).flags;
+		if(B1_RPNREC_GET_TYPE(tflags) == B1_RPNREC_TYPE_IMM_VALUE && !B1_RPNREC_TEST_IMM_VALUE_NULL_ARG(tflags))
 		{
-			return err;
+			err = b1_int_st_def_copy_text(&(*rpnrec).data.token.offset, (*rpnrec).data.token.length);
+			if(err != B1_RES_OK)
+			{
+				return err;
+			}
 		}
-	}
-	else
-	{
-#ifdef B1_FEATURE_TYPE_SMALL
-		// check if the loop control variable has reached its limit value (is necessary for unsigned types)
-		b1_rpn_eval[0] = (*(*stk_rec).var).var;
-
-		err = b1_eval_cmp(b1_rpn_eval, B1_T_C_EQ, 0, b1_rpn_eval[0].type);
-		if(err != B1_RES_OK)
+#ifdef B1_FEATURE_DEBUG
+		else
+		if(B1_RPNREC_GET_TYPE(tflags) == B1_RPNREC_TYPE_FNVAR)
 		{
-			return err;
+			err = b1_int_st_def_copy_text(&(*rpnrec).data.id.offset, (*rpnrec).data.id.length);
+			if(err != B1_RES_OK)
+			{
+				return err;
+			}
 		}
+#endif
 
-		if(b1_rpn_eval[0].value.bval)
+#ifdef B1_FEATURE_FUNCTIONS_USER_MEMO
+		// variables, non-deterministic and not yet defined functions make the function impure (recursive
+		// calls are allowed)
+		if(pure && B1_RPNREC_GET_TYPE(tflags) == B1_RPNREC_TYPE_FNVAR && (*rpnrec).data.id.hash != (*fn).fn.id.name_hash)
 		{
-			b1_int_curr_stmt_state |= B1_INT_STATE_FOR_STOP;
+			if(b1_fn_get_params((*rpnrec).data.id.hash, 0, &fn1) != B1_RES_OK)
+			{
+				pure = 0;
+			}
+			else
+			if(B1_IDENT_TEST_FLAGS_FN_BLTIN((*fn1).id.flags))
+			{
+				pure = b1_fn_bltin_is_pure(fn1);
+			}
+			else
+			{
+				pure = (*((B1_UDEF_FN *)fn1)).memo & B1_UDEF_FN_PURE;
+			}
 		}
 #endif
-		// set program line counter to the first line of the loop body
-		b1_curr_prog_line_cnt = (*stk_rec).ret_line_cnt;
-	}
-
-	return B1_RES_OK;
-}
-
-static B1_T_ERROR b1_int_st_for_next(B1_T_INDEX offset)
-{
-	//LET v = v + own2
-	//GOTO line1
-
-	B1_T_ERROR err;
-	B1_VAR_REF var_ref;
-	B1_TOKENDATA td;
-	B1_NAMED_VAR *var;
 
-	var = (*(b1_int_stmt_stack + b1_int_stmt_stack_ptr - 1)).var;
+		i++;
+		b1_fn_udef_fn_rpn_off++;
+	}
 
-	// check NEXT statement control variable if specified
-	if(!(b1_int_curr_stmt_state & B1_INT_STATE_FOR_NEXT_CHECKED))
+	(*fn).rpn_len = i;
+
+#ifdef B1_FEATURE_FUNCTIONS_USER_MEMO
+	if(pure)
 	{
-		b1_int_curr_stmt_state |= B1_INT_STATE_FOR_NEXT_CHECKED;
-		
-		err = b1_tok_get(offset, B1_TOK_CALC_HASH, &td);
-		if(err != B1_RES_OK)
-		{
-			return err;
-		}
+		(*fn).memo = B1_UDEF_FN_PURE;
 
-		if(td.length != 0)
+		// only numeric arguments and results are cached
+		tflags = !B1_TYPE_TEST_STRING((*fn).fn.ret_type);
+		for(i = 0; i < argnum; i++)
 		{
-			if(!(td.type & B1_TOKEN_TYPE_IDNAME))
+			if(B1_TYPE_TEST_STRING((*fn).fn.argtypes[i]))
 			{
-				return B1_RES_EINVTOK;
+				tflags = 0;
 			}
+		}
 
-			if(b1_tok_id_hash != (*var).id.name_hash)
-			{
-				return B1_RES_ENXTWOFOR;
-			}
+		if(tflags)
+		{
+			(*fn).memo |= B1_UDEF_FN_MEMO;
 		}
 	}
+#endif
 
-	err = b1_int_st_for_get_intvar(0x80, B1_INT_ST_FOR_INTVAR_ACCESS, 0, NULL);
+	return B1_RES_OK;
+}
+#endif
+
+#ifdef B1_FEATURE_STMT_FUNCTION
+// FUNCTION <fn_name>[(<arg1_name[, arg2_name, ...argN_name]>)]
+static B1_T_ERROR b1_int_st_function(B1_T_INDEX offset, B1_T_PROG_LINE_CNT def_line_cnt, B1_UDEF_FN **fn)
+{
+	B1_T_ERROR err;
+	B1_TOKENDATA td;
+	B1_T_IDHASH arg_hashes[B1_MAX_FN_ARGS_NUM];
+
+	err = b1_int_fn_header(&offset, fn, arg_hashes);
 	if(err != B1_RES_OK)
 	{
 		return err;
 	}
 
-	b1_rpn_eval[0] = (*var).var;
-	err = b1_eval_add(b1_rpn_eval, b1_rpn_eval[0].type);
+	err = b1_tok_get(offset, 0, &td);
 	if(err != B1_RES_OK)
 	{
 		return err;
 	}
 
-	var_ref.var = var;
-	var_ref.val_off = 0;
-	err = b1_var_set(b1_rpn_eval, &var_ref);
-
-	return err;
-}
-
-#ifdef B1_FEATURE_FUNCTIONS_USER
-static B1_T_INDEX b1_int_find_hash(const B1_T_IDHASH *hashes, B1_T_INDEX hash_num, B1_T_IDHASH hash)
-{
-	B1_T_INDEX i;
-
-	for(i = 0; i < hash_num; i++)
+	if(td.length != 0)
 	{
-		if(*(hashes + i) == hash)
-		{
-			break;
-		}
+		return B1_RES_ESYNTAX;
 	}
 
-	return i;
+	memcpy((**fn).arg_hashes, arg_hashes, sizeof(arg_hashes));
+	(**fn).def_line_cnt = def_line_cnt;
+	(**fn).end_line_cnt = 0;
+	(**fn).rpn_start_pos = 0;
+	(**fn).rpn_len = 0;
+
+	return B1_RES_OK;
 }
 
-// DEF <fn_name>[(<arg1_name[, arg2_name, ...argN_name]>)] = <expression>
-static B1_T_ERROR b1_int_st_def(B1_T_INDEX offset, B1_T_PROG_LINE_CNT def_line_cnt)
+// skips function body when FUNCTION statement is reached
+static B1_T_ERROR b1_int_st_function_skip(B1_T_INDEX offset)
 {
 	B1_T_ERROR err;
 	B1_TOKENDATA td;
-	B1_T_INDEX i, len;
-	B1_T_CHAR c;
-	B1_T_IDHASH arg_hashes[B1_MAX_FN_ARGS_NUM];
-	uint8_t argnum, tflags;
-	B1_UDEF_FN *fn;
-	B1_RPNREC *rpnrec;
+	B1_FN *fn;
 
-	// get function name
 	err = b1_tok_get(offset, B1_TOK_CALC_HASH, &td);
 	if(err != B1_RES_OK)
 	{
 		return err;
 	}
 
-	if(!(td.type & B1_TOKEN_TYPE_IDNAME))
+	err = b1_fn_get_params(b1_tok_id_hash, 0, &fn);
+	if(err != B1_RES_OK)
 	{
-		return B1_RES_EINVTOK;
+		return err;
 	}
 
-	offset = td.offset;
-	len = td.length;
+	b1_curr_prog_line_cnt = (*((B1_UDEF_FN *)fn)).end_line_cnt;
 
-	offset += len;
+	return B1_RES_OK;
+}
 
-	// check for existence
-	err = b1_fn_get_params(b1_tok_id_hash, 1, (B1_FN **)&fn);
-	if(err == B1_RES_OK)
+// RETURN <expression> (sets return value of the function being executed), does nothing if the expression is absent
+static B1_T_ERROR b1_int_st_function_return(B1_T_INDEX offset)
+{
+	B1_T_ERROR err;
+	B1_TOKENDATA td;
+
+	err = b1_tok_get(offset, 0, &td);
+	if(err != B1_RES_OK)
 	{
-		return B1_RES_EIDINUSE;
+		return err;
 	}
 
-	if(err != B1_RES_EUNKIDENT)
+	if(td.length == 0)
 	{
-		return err;
+		return B1_RES_OK;
 	}
 
-	// create new user function
-	(*fn).fn.id.name_hash = b1_tok_id_hash;
-	b1_t_get_type_by_type_spec(b1_progline[offset - 1], B1_TYPE_NULL, &(*fn).fn.ret_type);
+	if(b1_int_fn_depth == 0)
+	{
+		return B1_RES_ESYNTAX;
+	}
 
-	err = b1_tok_get(offset, 0, &td);
+	err = b1_rpn_build(td.offset, NULL, NULL);
 	if(err != B1_RES_OK)
 	{
 		return err;
 	}
 
-	offset = td.offset;
-	len = td.length;
-
-	if(len != 1 || !(td.type & B1_TOKEN_TYPE_OPERATION))
+	err = b1_eval(0, NULL);
+	if(err != B1_RES_OK)
 	{
-		return B1_RES_ESYNTAX;
+		return err;
 	}
 
-	c = b1_progline[offset];
-	offset += len;
-
-	argnum = 0;
-
-	if(c == B1_T_C_OPBRACK)
+	if(b1_rpn_eval[0].type == B1_TYPE_SET(B1_TYPE_STRING, B1_TYPE_REF_FLAG))
 	{
-		// read function arguments
-		while(1)
+		// the variable the value refers to can be local
+		err = b1_var_var2str(b1_rpn_eval, b1_tmp_buf);
+		if(err != B1_RES_OK)
 		{
-			err = b1_tok_get(offset, B1_TOK_CALC_HASH, &td);
-			if(err != B1_RES_OK)
-			{
-				return err;
-			}
-
-			offset = td.offset;
-			len = td.length;
-
-			if(!(td.type & B1_TOKEN_TYPE_IDNAME))
-			{
-				return B1_RES_ESYNTAX;
-			}
-
-			if(argnum == B1_MAX_FN_ARGS_NUM)
-			{
-				return B1_RES_EWRARGCNT;
-			}
-
-			// process function argument
-			i = b1_int_find_hash(arg_hashes, argnum, b1_tok_id_hash);
-			if(i != argnum)
-			{
-				return B1_RES_EIDINUSE;
-			}
-
-			offset += len;
-			b1_t_get_type_by_type_spec(b1_progline[offset - 1], B1_TYPE_NULL, &(*fn).fn.argtypes[argnum]);
-
-			arg_hashes[argnum] = b1_tok_id_hash;
-			argnum++;
-
-			err = b1_tok_get(offset, 0, &td);
-			if(err != B1_RES_OK)
-			{
-				return err;
-			}
-
-			offset = td.offset;
-			len = td.length;
-
-			if(len != 1 || !(td.type & B1_TOKEN_TYPE_OPERATION))
-			{
-				return B1_RES_ESYNTAX;
-			}
-
-			c = b1_progline[offset];
-			offset += len;
-
-			if(c == B1_T_C_CLBRACK)
-			{
-				break;
-			}
-
-			if(!B1_T_ISCOMMA(c))
-			{
-				return B1_RES_ESYNTAX;
-			}
+			return err;
 		}
 
-		err = b1_tok_get(offset, 0, &td);
+		err = b1_var_str2var(b1_tmp_buf, b1_rpn_eval);
 		if(err != B1_RES_OK)
 		{
 			return err;
 		}
+	}
 
-		offset = td.offset;
-		len = td.length;
-
-		if(len != 1 || !(td.type & B1_TOKEN_TYPE_OPERATION))
-		{
-			return B1_RES_ESYNTAX;
-		}
+	b1_int_fn_ret_val = b1_rpn_eval[0];
+	b1_int_fn_ret = 1;
 
-		c = b1_progline[offset];
-		offset += len;
-	}
+	return B1_RES_OK;
+}
 
-	if(c != B1_T_C_EQ)
-	{
-		return B1_RES_ESYNTAX;
-	}
+// END FUNCTION (returns from the function being executed), END statement without FUNCTION keyword stops the program
+static B1_T_ERROR b1_int_st_end(B1_T_INDEX offset)
+{
+	B1_T_ERROR err;
+	B1_TOKENDATA td;
 
-	// build function expression RPN
-	err = b1_rpn_build(offset, NULL, NULL);
+	err = b1_tok_get(offset, B1_TOK_CALC_HASH, &td);
 	if(err != B1_RES_OK)
 	{
 		return err;
 	}
 
-	// save function RPN
-	i = 0;
-
-	(*fn).def_line_cnt = def_line_cnt;
-	(*fn).rpn_start_pos = b1_fn_udef_fn_rpn_off;
-
-	while(1)
+	if(!(td.type & B1_TOKEN_TYPE_IDNAME) || b1_id_get_stmt_by_hash(b1_tok_id_hash) != B1_ID_STMT_FUNCTION)
 	{
-		tflags = (*(b1_rpn + i)).flags;
-
-		if(tflags == 0)
-		{
-			if(i == 0)
-			{
-				return B1_RES_ESYNTAX;
-			}
-
-			break;
-		}
-
-		if(b1_fn_udef_fn_rpn_off > B1_MAX_UDEF_FN_RPN_LEN - 1)
-		{
-			return B1_RES_EMANYDEF;
-		}
-
-		rpnrec = b1_fn_udef_fn_rpn + b1_fn_udef_fn_rpn_off;
-
-		memcpy(rpnrec, b1_rpn + i, sizeof(B1_RPNREC));
-
-		if(tflags == (B1_RPNREC_TYPE_FNVAR | (uint8_t)(0 << (B1_RPNREC_FN_ARG_INDEX_SHIFT))))
-		{
-			len = b1_int_find_hash(arg_hashes, argnum, (*rpnrec).data.id.hash);
-			if(len != argnum)
-			{
-				(*rpnrec).flags = B1_RPNREC_TYPE_FN_ARG | (uint8_t)(len << (B1_RPNREC_FN_ARG_INDEX_SHIFT));
-			}
-		}
+		return B1_RES_END;
+	}
 
-		i++;
-		b1_fn_udef_fn_rpn_off++;
+	if(b1_int_fn_depth == 0)
+	{
+		return B1_RES_EINVSTAT;
 	}
 
-	(*fn).fn.id.flags = B1_IDENT_FLAGS_SET_FN(argnum, 0);
-	(*fn).rpn_len = i;
+	b1_int_fn_ret = 2;
 
 	return B1_RES_OK;
 }
@@ -2313,14 +4690,66 @@ static B1_T_ERROR b1_int_st_set(B1_T_INDEX offset)
 
 		return B1_RES_OK;
 	}
-	else
-	if(err == B1_RES_EEOF)
+	else
+	if(err == B1_RES_EEOF)
+	{
+		return B1_RES_EINVSTAT;
+	}
+
+	return B1_RES_OK;
+}
+
+#ifdef B1_FEATURE_FUNCTIONS_MATH_BASIC
+#ifdef B1_FRACTIONAL_TYPE_EXISTS
+#ifdef B1_FEATURE_RANDOMIZE_SEED
+// RANDOMIZE [<num_expr>]: the same expression value always starts the same random values sequence
+static B1_T_ERROR b1_int_st_randomize(B1_T_INDEX offset)
+{
+	B1_T_ERROR err;
+	B1_TOKENDATA td;
+
+	err = b1_tok_get(offset, 0, &td);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	if(td.length == 0)
+	{
+		b1_ex_rnd_randomize(0);
+		return B1_RES_OK;
+	}
+
+	err = b1_rpn_build(td.offset, NULL, NULL);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	err = b1_eval(0, NULL);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	if(!B1_TYPE_TEST_NUMERIC(b1_rpn_eval[0].type))
+	{
+		return B1_RES_ETYPMISM;
+	}
+
+	err = b1_var_convert(b1_rpn_eval, B1_TYPE_INT);
+	if(err != B1_RES_OK)
 	{
-		return B1_RES_EINVSTAT;
+		return err;
 	}
 
+	b1_ex_rnd_seed((uint32_t)b1_rpn_eval[0].value.i32val);
+
 	return B1_RES_OK;
 }
+#endif
+#endif
+#endif
 
 #ifdef B1_FEATURE_STMT_WHILE_WEND
 static B1_T_ERROR b1_int_st_while(B1_T_INDEX offset)
@@ -2547,6 +4976,14 @@ static B1_T_ERROR b1_int_interpret_stmt(uint8_t stmt)
 
 	if(stmt == B1_ID_STMT_RETURN)
 	{
+#ifdef B1_FEATURE_STMT_FUNCTION
+		err = b1_int_st_function_return(offset);
+		if(err != B1_RES_OK || b1_int_fn_ret)
+		{
+			return err;
+		}
+#endif
+
 		// RETURN should unwind statements stack
 		while(!(b1_int_curr_stmt_state & B1_INT_STATE_GOSUB))
 		{
@@ -2726,6 +5163,32 @@ static B1_T_ERROR b1_int_interpret_stmt(uint8_t stmt)
 	}
 #endif
 
+#ifdef B1_FEATURE_STMT_FILE
+	if(stmt == B1_ID_STMT_PRINT)
+	{
+		return b1_int_st_print_file(offset);
+	}
+
+	if(stmt == B1_ID_STMT_INPUT)
+	{
+		return b1_int_st_input_file(offset);
+	}
+
+	if(stmt == B1_ID_STMT_LINE)
+	{
+		return b1_int_st_line_input(offset);
+	}
+
+	if(stmt == B1_ID_STMT_OPEN)
+	{
+		return b1_int_st_open(offset);
+	}
+
+	if(stmt == B1_ID_STMT_CLOSE)
+	{
+		return b1_int_st_close(offset);
+	}
+#else
 	if(stmt == B1_ID_STMT_PRINT)
 	{
 		return b1_int_st_print(offset);
@@ -2735,6 +5198,7 @@ static B1_T_ERROR b1_int_interpret_stmt(uint8_t stmt)
 	{
 		return b1_int_st_input(offset);
 	}
+#endif
 
 	if(stmt == B1_ID_STMT_DIM)
 	{
@@ -2748,12 +5212,37 @@ static B1_T_ERROR b1_int_interpret_stmt(uint8_t stmt)
 	}
 #endif
 
+#ifdef B1_FEATURE_STMT_MAT
+	if(stmt == B1_ID_STMT_MAT)
+	{
+		return b1_int_st_mat(offset);
+	}
+#endif
+
+#ifdef B1_FEATURE_STMT_SORT
+	if(stmt == B1_ID_STMT_SORT)
+	{
+		return b1_int_st_sort(offset);
+	}
+#endif
+
+#ifdef B1_FEATURE_TYPE_MAP
+	if(stmt == B1_ID_STMT_DELETE)
+	{
+		return b1_int_st_delete(offset);
+	}
+#endif
+
 #ifdef B1_FEATURE_FUNCTIONS_MATH_BASIC
 #ifdef B1_FRACTIONAL_TYPE_EXISTS
 	if(stmt == B1_ID_STMT_RANDOMIZE)
 	{
+#ifdef B1_FEATURE_RANDOMIZE_SEED
+		return b1_int_st_randomize(offset);
+#else
 		b1_ex_rnd_randomize(0);
 		return B1_RES_OK;
+#endif
 	}
 #endif
 #endif
@@ -2772,6 +5261,19 @@ static B1_T_ERROR b1_int_interpret_stmt(uint8_t stmt)
 	}
 #endif
 
+#ifdef B1_FEATURE_STMT_FUNCTION
+	// FUNCTION <fn_name>[(<arg1_name[, arg2_name, ...argN_name]>)]
+	if(stmt == B1_ID_STMT_FUNCTION)
+	{
+		if(b1_int_curr_stmt_state & B1_INT_STATE_IF)
+		{
+			return B1_RES_EINVSTAT;
+		}
+
+		return b1_int_st_function_skip(offset);
+	}
+#endif
+
 	if(stmt == B1_ID_STMT_SET)
 	{
 		return b1_int_st_set(offset);
@@ -2779,7 +5281,11 @@ static B1_T_ERROR b1_int_interpret_stmt(uint8_t stmt)
 
 	if(stmt == B1_ID_STMT_END)
 	{
+#ifdef B1_FEATURE_STMT_FUNCTION
+		return b1_int_st_end(offset);
+#else
 		return B1_RES_END;
+#endif
 	}
 
 #ifdef B1_FEATURE_STMT_STOP
@@ -2794,16 +5300,292 @@ static B1_T_ERROR b1_int_interpret_stmt(uint8_t stmt)
 	return b1_int_st_let(offset, &var_ref, NULL, NULL);
 }
 
+#ifdef B1_FEATURE_STMT_FUNCTION
+// executes FUNCTION ... END FUNCTION procedure, function arguments are taken from b1_rpn_eval buffer starting
+// from argsbase index, the function result is stored in place of the first argument
+B1_T_ERROR b1_int_fn_call(const B1_UDEF_FN *fn, B1_T_INDEX argsbase)
+{
+	B1_T_ERROR err, err1;
+	uint8_t stmt, argnum, state, ret;
+	B1_T_INDEX i, line_offset, stmt_stack_ptr, stmt_stack_base;
+	B1_T_PROG_LINE_CNT line_cnt, err_line_cnt;
+	B1_T_LINE_NUM next_line_num;
+	B1_T_IDHASH id_hash;
+	B1_T_MEMOFFSET top, locals_base, rpn_size;
+	const B1_T_CHAR *progline;
+	const B1_RPNREC *rpn;
+	B1_VAR_REF var_ref;
+
+	if(b1_int_fn_depth == B1_MAX_UDEF_CALL_NEST_DEPTH)
+	{
+		return B1_RES_EUDEFOVF;
+	}
+
+	argnum = B1_IDENT_GET_FLAGS_ARGNUM((*fn).fn.id.flags);
+
+	// string references can become invalid while the function is executed
+	for(i = 0; i != argsbase + argnum; i++)
+	{
+		if(b1_rpn_eval[i].type == B1_TYPE_SET(B1_TYPE_STRING, B1_TYPE_REF_FLAG))
+		{
+			err = b1_var_var2str(b1_rpn_eval + i, b1_tmp_buf);
+			if(err != B1_RES_OK)
+			{
+				return err;
+			}
+
+			err = b1_var_str2var(b1_tmp_buf, b1_rpn_eval + i);
+			if(err != B1_RES_OK)
+			{
+				return err;
+			}
+		}
+	}
+
+	// save the caller context: RPN and temp. stack are overwritten by the function statements
+	i = 0;
+	while(i != B1_MAX_RPN_LEN - 1 && b1_rpn_buf[i].flags != 0)
+	{
+		i++;
+	}
+	// including the terminating record
+	rpn_size = (B1_T_MEMOFFSET)(i + 1) * sizeof(B1_RPNREC);
+
+	top = b1_int_fn_stack.top;
+
+	err = b1_fn_stack_push(&b1_int_fn_stack, b1_rpn_buf, rpn_size);
+	if(err == B1_RES_OK)
+	{
+		err = b1_fn_stack_push(&b1_int_fn_stack, b1_rpn_eval, (B1_T_MEMOFFSET)argsbase * sizeof(B1_VAR));
+	}
+
+	if(err != B1_RES_OK)
+	{
+		b1_int_fn_stack.top = top;
+		return err;
+	}
+
+	progline = b1_progline;
+	line_cnt = b1_curr_prog_line_cnt;
+	line_offset = b1_curr_prog_line_offset;
+	next_line_num = b1_next_line_num;
+	state = b1_int_curr_stmt_state;
+	stmt_stack_ptr = b1_int_stmt_stack_ptr;
+	stmt_stack_base = b1_int_stmt_stack_base;
+	locals_base = b1_int_fn_locals_base;
+	id_hash = b1_tok_id_hash;
+	rpn = b1_rpn;
+
+	b1_int_fn_depth++;
+	b1_int_fn_locals_base = b1_int_fn_stack.top;
+	b1_int_stmt_stack_base = stmt_stack_ptr;
+	b1_int_curr_stmt_state = 0;
+	b1_int_fn_ret = 0;
+
+	err = B1_RES_OK;
+
+#ifdef B1_FEATURE_DEBUG
+	// argument names are taken from the function header
+	if(err == B1_RES_OK)
+	{
+		b1_curr_prog_line_cnt = (*fn).def_line_cnt - 1;
+		err = b1_ex_prg_get_prog_line(B1_T_LINE_NUM_NEXT);
+	}
+#endif
+
+	// arguments are local variables
+	var_ref.val_off = 0;
+	var_ref.arr_data_desc = B1_T_MEM_BLOCK_DESC_INVALID;
+
+	for(i = 0; err == B1_RES_OK && i != argnum; i++)
+	{
+		err = b1_int_fn_local((*fn).arg_hashes[i]);
+		if(err == B1_RES_OK)
+		{
+			err = b1_var_create((*fn).arg_hashes[i], (*fn).fn.argtypes[i], 0, NULL, &var_ref.var);
+		}
+
+		if(err == B1_RES_OK)
+		{
+#ifdef B1_FEATURE_DEBUG
+			memcpy((*var_ref.var).id.name + 1, b1_progline + (*fn).arg_offsets[i], (*fn).arg_lengths[i] * B1_T_CHAR_SIZE);
+			(*var_ref.var).id.name[0] = (B1_T_CHAR)(*fn).arg_lengths[i];
+#endif
+			err = b1_var_set(b1_rpn_eval + argsbase + i, &var_ref);
+		}
+	}
+
+	// execute the function body
+	b1_curr_prog_line_cnt = (*fn).def_line_cnt;
+	b1_curr_prog_line_offset = 0;
+	b1_next_line_num = B1_T_LINE_NUM_NEXT;
+
+	while(err == B1_RES_OK && !b1_int_fn_ret)
+	{
+		if(b1_curr_prog_line_offset == 0)
+		{
+			err = b1_ex_prg_get_prog_line(b1_next_line_num);
+			if(err == B1_RES_EPROGUNEND)
+			{
+				err = B1_RES_EFNWOEND;
+			}
+			if(err != B1_RES_OK)
+			{
+				break;
+			}
+		}
+
+		err = b1_tok_stmt_init(&stmt);
+		if(err == B1_RES_OK)
+		{
+			err = b1_int_interpret_stmt(stmt);
+		}
+	}
+
+	ret = b1_int_fn_ret;
+
+	// unwind statements of the function body (RETURN can be executed within loops)
+	err_line_cnt = b1_curr_prog_line_cnt;
+
+	while(b1_int_stmt_stack_ptr != b1_int_stmt_stack_base)
+	{
+		if(b1_int_curr_stmt_state & B1_INT_STATE_FOR)
+		{
+			b1_int_st_for_end();
+		}
+
+		b1_int_restore_stmt_state();
+	}
+
+	b1_curr_prog_line_cnt = err_line_cnt;
+
+	// free local variables and restore the caller context
+	err1 = b1_int_fn_locals_free();
+	if(err == B1_RES_OK)
+	{
+		err = err1;
+	}
+
+	err1 = b1_fn_stack_read(&b1_int_fn_stack, top, b1_rpn_buf, rpn_size);
+	if(err1 == B1_RES_OK)
+	{
+		err1 = b1_fn_stack_read(&b1_int_fn_stack, top + rpn_size, b1_rpn_eval, (B1_T_MEMOFFSET)argsbase * sizeof(B1_VAR));
+	}
+	if(err == B1_RES_OK)
+	{
+		err = err1;
+	}
+
+	b1_int_fn_stack.top = top;
+
+	b1_int_fn_depth--;
+	b1_int_fn_locals_base = locals_base;
+	b1_int_stmt_stack_base = stmt_stack_base;
+	b1_int_curr_stmt_state = state;
+	b1_tok_id_hash = id_hash;
+	b1_rpn = rpn;
+	b1_int_fn_ret = 0;
+
+	// the line causing error remains current one
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	b1_curr_prog_line_cnt = line_cnt - 1;
+	err = b1_ex_prg_get_prog_line(B1_T_LINE_NUM_NEXT);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	// the caller can be user defined function evaluated with b1_progline pointing to constants buffer
+	b1_progline = progline;
+	b1_curr_prog_line_offset = line_offset;
+	b1_next_line_num = next_line_num;
+
+	if(ret == 1)
+	{
+		b1_rpn_eval[argsbase] = b1_int_fn_ret_val;
+		return b1_var_convert(b1_rpn_eval + argsbase, (*fn).fn.ret_type);
+	}
+
+	// END FUNCTION statement returns default value
+	return b1_var_init_empty((*fn).fn.ret_type, 0, NULL, b1_rpn_eval + argsbase);
+}
+#endif
+
+#ifdef B1_FEATURE_VAR_SLOTS
+// assigns slots to identifiers used in the current program line (statement keywords and known
+// function names are skipped), tokenizer errors are ignored here and reported by b1_int_run
+static void b1_int_var_slots_collect(uint8_t stmt)
+{
+	B1_T_INDEX offset;
+	B1_T_IDHASH hash;
+	B1_TOKENDATA td;
+	B1_FN *fn;
+
+	if(stmt == B1_ID_STMT_REM
+#ifdef B1_FEATURE_STMT_DATA_READ
+		|| stmt == B1_ID_STMT_DATA
+#endif
+		)
+	{
+		return;
+	}
+
+	offset = b1_curr_prog_line_offset;
+
+	// hashes are calculated for identifiers only (string and numeric constants are not hashed)
+	while(b1_tok_get(offset, 0, &td) == B1_RES_OK && td.length != 0)
+	{
+		if((td.type & B1_TOKEN_TYPE_IDNAME)
+#ifdef B1_FEATURE_TOKEN_TYPE_DEVNAME
+			&& !(td.type & B1_TOKEN_TYPE_DEVNAME)
+#endif
+			)
+		{
+			hash = b1_id_calc_hash(b1_progline + td.offset, td.length * B1_T_CHAR_SIZE);
+
+			if(b1_id_get_stmt_by_hash(hash) == B1_ID_STMT_UNKNOWN &&
+#ifdef B1_FEATURE_FUNCTIONS_USER
+				b1_fn_get_params(hash, 0, &fn) == B1_RES_EUNKIDENT
+#else
+				b1_fn_get_params(hash, &fn) == B1_RES_EUNKIDENT
+#endif
+				)
+			{
+				b1_var_slot_add(hash);
+			}
+		}
+
+		offset = td.offset + td.length;
+	}
+}
+#endif
+
 B1_T_ERROR b1_int_prerun()
 {
 	B1_T_ERROR err;
 	uint8_t stmt, for_nest;
 	B1_T_LINE_NUM prev_line_n;
 	B1_T_PROG_LINE_CNT line_cnt;
+#ifdef B1_FEATURE_STMT_FUNCTION
+	B1_TOKENDATA td;
+	B1_UDEF_FN *fn;
+
+	// the function being defined
+	fn = NULL;
+#endif
 
 	prev_line_n = B1_T_LINE_NUM_ABSENT;
 	for_nest = 0;
 
+#ifdef B1_FEATURE_FUNCTIONS_USER_INLINE
+	// DEF functions RPN must not contain inlined bodies
+	b1_rpn_udef_inline = 0;
+#endif
+
 	while(1)
 	{
 		err = b1_ex_prg_get_prog_line(B1_T_LINE_NUM_NEXT);
@@ -2843,6 +5625,10 @@ B1_T_ERROR b1_int_prerun()
 
 		line_cnt = b1_curr_prog_line_cnt;
 
+#ifdef B1_FEATURE_VAR_SLOTS
+		b1_int_var_slots_collect(stmt);
+#endif
+
 		if(stmt == B1_ID_STMT_FOR)
 		{
 			if(for_nest == B1_MAX_STMT_NEST_DEPTH)
@@ -2876,6 +5662,43 @@ B1_T_ERROR b1_int_prerun()
 		}
 #endif
 
+#ifdef B1_FEATURE_STMT_FUNCTION
+		if(stmt == B1_ID_STMT_FUNCTION)
+		{
+			// nested functions are not allowed
+			if(fn != NULL)
+			{
+				return B1_RES_EFNWOEND;
+			}
+
+			err = b1_int_st_function(b1_curr_prog_line_offset, line_cnt, &fn);
+			if(err != B1_RES_OK)
+			{
+				return err;
+			}
+		}
+
+		if(stmt == B1_ID_STMT_END)
+		{
+			err = b1_tok_get(b1_curr_prog_line_offset, B1_TOK_CALC_HASH, &td);
+			if(err != B1_RES_OK)
+			{
+				return err;
+			}
+
+			if((td.type & B1_TOKEN_TYPE_IDNAME) && b1_id_get_stmt_by_hash(b1_tok_id_hash) == B1_ID_STMT_FUNCTION)
+			{
+				if(fn == NULL)
+				{
+					return B1_RES_EENDWOFN;
+				}
+
+				(*fn).end_line_cnt = line_cnt;
+				fn = NULL;
+			}
+		}
+#endif
+
 		b1_curr_prog_line_offset = 0;
 	}
 
@@ -2886,13 +5709,30 @@ B1_T_ERROR b1_int_prerun()
 		return B1_RES_EFORWONXT;
 	}
 
+#ifdef B1_FEATURE_STMT_FUNCTION
+	if(fn != NULL)
+	{
+		b1_curr_prog_line_cnt = (*fn).def_line_cnt;
+
+		return B1_RES_EFNWOEND;
+	}
+#endif
+
 	b1_curr_prog_line_cnt = 0;
 	b1_next_line_num = B1_T_LINE_NUM_NEXT;
 
+#ifdef B1_FEATURE_FUNCTIONS_USER_INLINE
+	b1_rpn_udef_inline = 1;
+#endif
+
 	return B1_RES_OK;
 }
 
+#ifdef B1_FEATURE_IO_PRINT_STR
+static B1_T_ERROR b1_int_run_lines()
+#else
 B1_T_ERROR b1_int_run()
+#endif
 {
 	B1_T_ERROR err;
 	uint8_t stmt;
@@ -2947,3 +5787,17 @@ B1_T_ERROR b1_int_run()
 
 	return err;
 }
+
+#ifdef B1_FEATURE_IO_PRINT_STR
+B1_T_ERROR b1_int_run()
+{
+	B1_T_ERROR err, err1;
+
+	err = b1_int_run_lines();
+
+	// the program can stop or fail in the middle of a line
+	err1 = b1_ex_io_print_flush();
+
+	return (err == B1_RES_OK) ? err1 : err;
+}
+#endif
@@ -14,6 +14,7 @@
 
 #include "b1.h"
 #include "b1var.h"
+#include "b1fn.h"
 
 
 #define B1_MAX_STMT_NEST_DEPTH ((B1_T_INDEX)10)
@@ -49,6 +50,15 @@ typedef struct
 	B1_T_PROG_LINE_CNT ret_line_cnt;
 } B1_INT_STMT_STK_REC;
 
+#ifdef B1_FEATURE_STMT_FUNCTION
+// variable hidden by local variable of a function (exists = 0 if there was no variable with the same name)
+typedef struct
+{
+	B1_NAMED_VAR var;
+	uint8_t exists;
+} B1_INT_FN_LOCAL;
+#endif
+
 
 extern uint8_t b1_int_print_zone_width;
 extern uint8_t b1_int_print_curr_pos;
@@ -64,8 +74,12 @@ extern B1_T_ERROR b1_int_reset();
 extern B1_T_ERROR b1_int_prerun();
 extern B1_T_ERROR b1_int_run();
 
-#if defined(B1_FEATURE_STMT_ERASE) || defined(B1_FEATURE_INIT_FREE_MEMORY)
+#if defined(B1_FEATURE_STMT_ERASE) || defined(B1_FEATURE_INIT_FREE_MEMORY) || defined(B1_FEATURE_STMT_FUNCTION)
 extern B1_T_ERROR b1_int_var_mem_free(B1_NAMED_VAR *var);
 #endif
 
+#ifdef B1_FEATURE_STMT_FUNCTION
+extern B1_T_ERROR b1_int_fn_call(const B1_UDEF_FN *fn, B1_T_INDEX argsbase);
+#endif
+
 #endif
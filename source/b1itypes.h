@@ -68,13 +68,20 @@
 #define B1_T_LINE_NUM_MAX_VALUE ((B1_T_LINE_NUM)((UINT16_MAX) - 5))
 
 #define B1_T_MEM_BLOCK_DESC_INVALID ((B1_T_MEM_BLOCK_DESC)NULL)
+// invalid memory block descriptor value consists of zero bits only (comment the macro out if NULL pointer
+// representation is not all-zero on the target platform)
+#define B1_T_MEM_BLOCK_DESC_INVALID_ZERO_BITS
 
 // reserved values for B1_T_LINE_NUM type
 #define B1_T_LINE_NUM_ABSENT ((B1_T_LINE_NUM)(B1_T_LINE_NUM_MAX_VALUE + 3))
 #define B1_T_LINE_NUM_FIRST ((B1_T_LINE_NUM)(B1_T_LINE_NUM_MAX_VALUE + 2))
 #define B1_T_LINE_NUM_NEXT ((B1_T_LINE_NUM)(B1_T_LINE_NUM_MAX_VALUE + 1))
 
+#ifdef B1_FEATURE_RAND_SEED_32BIT
+#define B1_T_RAND_SEED_MAX_VALUE (UINT32_MAX)
+#else
 #define B1_T_RAND_SEED_MAX_VALUE (UINT16_MAX)
+#endif
 
 
 // type for error codes
@@ -122,6 +129,11 @@ typedef uint16_t B1_T_IDHASH;
 #endif
 // type for random generator (an unsigned integer type, floating point value returned by RND function
 // is the result of the next expression: ((float)(seed - ((seed == B1_T_RAND_SEED_MAX_VALUE) ? 1 : 0))) / (float)B1_T_RAND_SEED_MAX_VALUE
+// for 16-bit seed and seed / 2^32 for 32-bit one, see B1_FN_RND_SEED_TO_FP macro)
+#ifdef B1_FEATURE_RAND_SEED_32BIT
+typedef uint32_t B1_T_RAND_SEED;
+#else
 typedef uint16_t B1_T_RAND_SEED;
+#endif
 
 #endif
@@ -8,6 +8,7 @@
 
 
 #include <stdlib.h>
+#include <string.h>
 
 #include "b1.h"
 #include "b1ex.h"
@@ -16,6 +17,9 @@
 #include "b1types.h"
 #include "b1dbg.h"
 #include "b1err.h"
+#ifdef B1_FEATURE_FUNCTIONS_USER_INLINE
+#include "b1fn.h"
+#endif
 
 
 // buffer for an expression represented in RPN
@@ -24,6 +28,10 @@ B1_RPNREC b1_rpn_buf[B1_MAX_RPN_LEN];
 const B1_RPNREC *b1_rpn;
 // needed for expression evaluation
 B1_VAR b1_rpn_eval[B1_MAX_RPN_EVAL_BUFFER_LEN];
+#ifdef B1_FEATURE_FUNCTIONS_USER_INLINE
+// DEF functions are inlined after all of them are defined (set by b1_int_prerun function)
+uint8_t b1_rpn_udef_inline;
+#endif
 
 
 static const B1_T_CHAR *b1_rpn_op_names[] =
@@ -78,6 +86,114 @@ static B1_T_ERROR b1_rpn_test_type_copy(B1_T_INDEX stack_top_index, uint8_t type
 	return flags;
 }
 
+#ifdef B1_FEATURE_FUNCTIONS_USER_INLINE
+// returns short DEF function that can be inlined or NULL
+static const B1_UDEF_FN *b1_rpn_udef_get_inline(B1_T_IDHASH name_hash)
+{
+	B1_T_ERROR err;
+	B1_T_INDEX i;
+	B1_FN *fn;
+	const B1_UDEF_FN *udef;
+	const B1_RPNREC *rpnrec;
+
+	if(b1_fn_get_params(name_hash, 0, &fn) != B1_RES_OK || B1_IDENT_TEST_FLAGS_FN_BLTIN((*fn).id.flags))
+	{
+		return NULL;
+	}
+
+	udef = (const B1_UDEF_FN *)fn;
+
+	// zero RPN length stands for FUNCTION ... END FUNCTION procedure
+	if((*udef).rpn_len == 0 || (*udef).rpn_len > B1_MAX_UDEF_INLINE_LEN)
+	{
+		return NULL;
+	}
+
+	// the function body can refer to variables and built-in functions only (no recursion and nested
+	// inlined bodies)
+	rpnrec = b1_fn_udef_fn_rpn + (*udef).rpn_start_pos;
+
+	for(i = 0; i < (*udef).rpn_len; i++, rpnrec++)
+	{
+		if(B1_RPNREC_GET_TYPE((*rpnrec).flags) == B1_RPNREC_TYPE_FNVAR)
+		{
+			err = b1_fn_get_params((*rpnrec).data.id.hash, 0, &fn);
+			if(err == B1_RES_OK ? !B1_IDENT_TEST_FLAGS_FN_BLTIN((*fn).id.flags) : err != B1_RES_EUNKIDENT)
+			{
+				return NULL;
+			}
+		}
+	}
+
+	return udef;
+}
+
+// inserts short DEF function bodies after their call records, the call record converts arguments, the body
+// is evaluated with b1_fn_udef_fn_text buffer as program line and B1_RPNREC_FN_ARG_INLINE_END record
+// converts and moves the result (len is the RPN terminating record index)
+static void b1_rpn_udef_inline_all(B1_T_INDEX len)
+{
+	B1_T_INDEX i, j;
+	const B1_UDEF_FN *udef;
+	const B1_RPNREC *rpnrec;
+
+	for(i = 0; i < len; i++)
+	{
+		if(B1_RPNREC_GET_TYPE(b1_rpn_buf[i].flags) != B1_RPNREC_TYPE_FNVAR)
+		{
+			continue;
+		}
+
+		udef = b1_rpn_udef_get_inline(b1_rpn_buf[i].data.id.hash);
+
+		// leave the call if the inlined body does not fit the buffer
+		if(udef == NULL || len + (*udef).rpn_len + 1 >= B1_MAX_RPN_LEN)
+		{
+			continue;
+		}
+
+		// move the rest of the RPN including the terminating record
+		memmove(b1_rpn_buf + i + (*udef).rpn_len + 2, b1_rpn_buf + i + 1, (len - i) * sizeof(B1_RPNREC));
+		len += (*udef).rpn_len + 1;
+
+		b1_rpn_buf[i].flags |= B1_RPNREC_FNVAR_INLINE;
+
+		rpnrec = b1_fn_udef_fn_rpn + (*udef).rpn_start_pos;
+
+		for(j = 0; j < (*udef).rpn_len; j++)
+		{
+			i++;
+			b1_rpn_buf[i] = *(rpnrec + j);
+#ifdef B1_FEATURE_MINIMAL_EVALUATION_AND_OR
+			// logical operator identifiers of the body must differ from the caller ones
+			if(b1_rpn_buf[i].flags == B1_RPNREC_TYPE_SPEC_LOGIC)
+			{
+				b1_rpn_buf[i].data.nestlevel += B1_RPNREC_LOGIC_ID_INLINE_SHIFT;
+			}
+			else
+			if(B1_RPNREC_GET_TYPE(b1_rpn_buf[i].flags) == B1_RPNREC_TYPE_OPER && b1_rpn_buf[i].data.oper.id != 0)
+			{
+				b1_rpn_buf[i].data.oper.id += B1_RPNREC_LOGIC_ID_INLINE_SHIFT;
+			}
+			else
+#endif
+#ifdef B1_FEATURE_MINIMAL_EVALUATION
+			// caller expression nesting levels are less than B1_MAX_RPN_BRACK_NEST_DEPTH, the body ones must
+			// differ from them
+			if(B1_RPNREC_TEST_SPEC_ARG(b1_rpn_buf[i].flags))
+			{
+				b1_rpn_buf[i].data.nestlevel += B1_MAX_RPN_BRACK_NEST_DEPTH;
+			}
+#endif
+		}
+
+		i++;
+		b1_rpn_buf[i].flags = B1_RPNREC_FN_ARG_INLINE_END;
+		b1_rpn_buf[i].data.id.flags = (*udef).fn.ret_type;
+	}
+}
+#endif
+
 // build RPN for expressions without assignment operation
 B1_T_ERROR b1_rpn_build(B1_T_INDEX offset, const B1_T_CHAR **stop_tokens, B1_T_INDEX *continue_offset)
 {
@@ -92,6 +208,9 @@ B1_T_ERROR b1_rpn_build(B1_T_INDEX offset, const B1_T_CHAR **stop_tokens, B1_T_I
 #ifdef B1_FEATURE_MINIMAL_EVALUATION
 	uint8_t iif;
 #endif
+#ifdef B1_FEATURE_MINIMAL_EVALUATION_AND_OR
+	uint8_t logic_id;
+#endif
 
 	// use the same array for both output queue and operator stack
 	// output queue index variable
@@ -145,6 +264,9 @@ B1_T_ERROR b1_rpn_build(B1_T_INDEX offset, const B1_T_CHAR **stop_tokens, B1_T_I
 #ifdef B1_FEATURE_MINIMAL_EVALUATION
 	iif = 0;
 #endif
+#ifdef B1_FEATURE_MINIMAL_EVALUATION_AND_OR
+	logic_id = B1_RPNREC_LOGIC_ID_BASE;
+#endif
 
 	while(1)
 	{
@@ -365,6 +487,13 @@ B1_T_ERROR b1_rpn_build(B1_T_INDEX offset, const B1_T_CHAR **stop_tokens, B1_T_I
 				rr.data.id.length = len;
 #endif
 				rr.data.id.hash = b1_tok_id_hash;
+#ifdef B1_FEATURE_VAR_SLOTS
+				rr.data.id.slot = b1_var_slot_get(b1_tok_id_hash);
+#endif
+#ifdef B1_FEATURE_BLTIN_FN_BINDING
+				// built-in function names cannot be redefined so they are bound once
+				rr.data.id.fn_index = b1_fn_bltin_get_index(b1_tok_id_hash);
+#endif
 #ifdef B1_FEATURE_MINIMAL_EVALUATION
 				// set iif flag if hash corresponds to IIF or IIF$ name
 				if(b1_tok_id_hash == B1_FN_IIF_FN_HASH || b1_tok_id_hash == B1_FN_STRIIF_FN_HASH)
@@ -399,6 +528,9 @@ B1_T_ERROR b1_rpn_build(B1_T_INDEX offset, const B1_T_CHAR **stop_tokens, B1_T_I
 			rr.flags = tmp;
 			rr.data.oper.c = c;
 			rr.data.oper.c1 = c1;
+#ifdef B1_FEATURE_MINIMAL_EVALUATION_AND_OR
+			rr.data.oper.id = 0;
+#endif
 
 			unop = 0;
 
@@ -423,6 +555,25 @@ B1_T_ERROR b1_rpn_build(B1_T_INDEX offset, const B1_T_CHAR **stop_tokens, B1_T_I
 				top++;
 			}
 
+#ifdef B1_FEATURE_MINIMAL_EVALUATION_AND_OR
+			// the left operand of binary AND or OR operator is in the output queue already, mark its end
+			// (no marker if identifiers are exhausted: the operator is evaluated completely then)
+			if(tmp != 0 && (c == B1_T_C_AMPERSAND || c == B1_T_C_PIPE) && logic_id < B1_RPNREC_LOGIC_ID_INLINE_SHIFT)
+			{
+				if(i == top)
+				{
+					return B1_RES_EEXPLONG;
+				}
+
+				rr.data.oper.id = logic_id | (c == B1_T_C_PIPE ? B1_RPNREC_LOGIC_ID_OR : (uint8_t)0);
+				logic_id++;
+
+				b1_rpn_buf[i].flags = B1_RPNREC_TYPE_SPEC_LOGIC;
+				b1_rpn_buf[i].data.nestlevel = rr.data.oper.id;
+				i++;
+			}
+#endif
+
 			STACK_PUSH(top, rr);
 		}
 	}
@@ -446,6 +597,13 @@ B1_T_ERROR b1_rpn_build(B1_T_INDEX offset, const B1_T_CHAR **stop_tokens, B1_T_I
 
 	b1_rpn_buf[i].flags = 0;
 
+#ifdef B1_FEATURE_FUNCTIONS_USER_INLINE
+	if(b1_rpn_udef_inline)
+	{
+		b1_rpn_udef_inline_all(i);
+	}
+#endif
+
 	if(len == 0)
 	{
 		offset = 0;
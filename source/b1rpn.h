@@ -23,7 +23,8 @@
 #define B1_RPNREC_TYPE_OPER ((uint8_t)0x4)
 // special type used during RPN building only (b1_rpn_build function output never contains such records)
 #define B1_RPNREC_TYPE_OPEN_BRAC ((uint8_t)0x8)
-// special type used with RPN for user defined functions (b1_rpn_build function output never contains such records)
+// special type used with RPN for user defined functions (b1_rpn_build function output contains such records
+// only within inlined function bodies)
 #define B1_RPNREC_TYPE_FN_ARG ((uint8_t)0x8)
 #define B1_RPNREC_TYPE_MASK ((uint8_t)0xF)
 
@@ -35,6 +36,16 @@
 #define B1_RPNREC_TEST_SPEC_ARG(FLAGS) ((((uint8_t)FLAGS) & ((uint8_t)0x3F)) == (uint8_t)0x3F)
 #endif
 
+#ifdef B1_FEATURE_MINIMAL_EVALUATION_AND_OR
+// the record following left operand of AND and OR operators, data.nestlevel holds the operator identifier
+// (the same identifier is stored in data.oper.id of the operator record)
+#define B1_RPNREC_TYPE_SPEC_LOGIC ((uint8_t)0xBF)
+// operator identifiers differ from IIF nesting levels, identifiers of inlined function bodies are shifted
+#define B1_RPNREC_LOGIC_ID_BASE ((uint8_t)0x10)
+#define B1_RPNREC_LOGIC_ID_INLINE_SHIFT ((uint8_t)0x40)
+#define B1_RPNREC_LOGIC_ID_OR ((uint8_t)0x80)
+#endif
+
 #define B1_RPNREC_IMM_VALUE_NULL_ARG ((uint8_t)0x10)
 
 #define B1_RPNREC_FNVAR_ARG_NUM_MASK ((uint8_t)0x70)
@@ -43,6 +54,13 @@
 #define B1_RPNREC_FN_ARG_INDEX_MASK ((uint8_t)0x70)
 #define B1_RPNREC_FN_ARG_INDEX_SHIFT ((uint8_t)0x4)
 
+#ifdef B1_FEATURE_FUNCTIONS_USER_INLINE
+// user function call record followed by the function body
+#define B1_RPNREC_FNVAR_INLINE ((uint8_t)0x80)
+// the record terminating inlined function body (the function return type is stored in data.id.flags)
+#define B1_RPNREC_FN_ARG_INLINE_END ((uint8_t)(B1_RPNREC_TYPE_FN_ARG | B1_RPNREC_FN_ARG_INDEX_MASK))
+#endif
+
 #define B1_RPNREC_OPER_PRI_MASK ((uint8_t)0x70)
 #define B1_RPNREC_OPER_PRI_SHIFT ((uint8_t)0x4)
 #define B1_RPNREC_OPER_LEFT_ASSOC ((uint8_t)0x80)
@@ -56,6 +74,10 @@
 
 #define B1_RPNREC_GET_FN_ARG_INDEX(FLAGS) ((((uint8_t)(FLAGS)) & (B1_RPNREC_FN_ARG_INDEX_MASK)) >> (B1_RPNREC_FN_ARG_INDEX_SHIFT))
 
+#ifdef B1_FEATURE_FUNCTIONS_USER_INLINE
+#define B1_RPNREC_TEST_FNVAR_INLINE(FLAGS) (((uint8_t)(FLAGS)) & B1_RPNREC_FNVAR_INLINE)
+#endif
+
 #define B1_RPNREC_GET_OPER_PRI(FLAGS) ((((uint8_t)(FLAGS)) & (B1_RPNREC_OPER_PRI_MASK)) >> (B1_RPNREC_OPER_PRI_SHIFT))
 #define B1_RPNREC_TEST_OPER_PRI(FLAGS, PRIORITY) ((((uint8_t)(FLAGS)) & (B1_RPNREC_OPER_PRI_MASK)) == (((uint8_t)(PRIORITY)) << (B1_RPNREC_OPER_PRI_SHIFT)))
 
@@ -66,6 +88,13 @@ typedef struct
 {
 	uint8_t flags;
 	B1_T_IDHASH hash;
+#ifdef B1_FEATURE_VAR_SLOTS
+	uint8_t slot;
+#endif
+#ifdef B1_FEATURE_BLTIN_FN_BINDING
+	// built-in function index (B1_FN_BLTIN_NONE for variables and user functions)
+	uint8_t fn_index;
+#endif
 #ifdef B1_FEATURE_DEBUG
 	B1_T_INDEX offset;
 	B1_T_INDEX length;
@@ -76,6 +105,10 @@ typedef struct
 {
 	B1_T_CHAR c;
 	B1_T_CHAR c1;
+#ifdef B1_FEATURE_MINIMAL_EVALUATION_AND_OR
+	// AND and OR operator identifier (0 for other operators)
+	uint8_t id;
+#endif
 } B1_T_RPN_OPER;
 
 typedef union
@@ -95,8 +128,12 @@ typedef struct
 } B1_RPNREC;
 
 
+extern B1_RPNREC b1_rpn_buf[B1_MAX_RPN_LEN];
 extern const B1_RPNREC *b1_rpn;
 extern B1_VAR b1_rpn_eval[B1_MAX_RPN_EVAL_BUFFER_LEN];
+#ifdef B1_FEATURE_FUNCTIONS_USER_INLINE
+extern uint8_t b1_rpn_udef_inline;
+#endif
 
 extern B1_T_ERROR b1_rpn_build(B1_T_INDEX offset, const B1_T_CHAR **stop_tokens, B1_T_INDEX *continue_offset);
 
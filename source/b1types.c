@@ -15,6 +15,9 @@
 
 #include "b1types.h"
 #include "b1err.h"
+#ifdef B1_FEATURE_FP_SHORTEST_DIGITS
+#include <math.h>
+#endif
 
 
 // types should be defined according to their converting priorities (from highest to lowest)
@@ -89,6 +92,25 @@ const B1_T_CHAR _AND[] = { 3, 'A', 'N', 'D' };
 const B1_T_CHAR _OR[] = { 2, 'O', 'R' };
 const B1_T_CHAR _XOR[] = { 3, 'X', 'O', 'R' };
 const B1_T_CHAR _NOT[] = { 3, 'N', 'O', 'T' };
+#ifdef B1_FEATURE_STMT_MAT
+const B1_T_CHAR _ASTERISK[] = { 1, B1_T_C_ASTERISK };
+const B1_T_CHAR _ZER[] = { 3, 'Z', 'E', 'R' };
+const B1_T_CHAR _CON[] = { 3, 'C', 'O', 'N' };
+const B1_T_CHAR _IDN[] = { 3, 'I', 'D', 'N' };
+const B1_T_CHAR _TRN[] = { 3, 'T', 'R', 'N' };
+#ifdef B1_FEATURE_FUNCTIONS_MATH_BASIC
+const B1_T_CHAR _RND[] = { 3, 'R', 'N', 'D' };
+#endif
+#endif
+#ifdef B1_FEATURE_TYPE_MAP
+const B1_T_CHAR _MAP[] = { 3, 'M', 'A', 'P' };
+const B1_T_CHAR _OF[] = { 2, 'O', 'F' };
+#endif
+#ifdef B1_FEATURE_STMT_FILE
+const B1_T_CHAR _FOR[] = { 3, 'F', 'O', 'R' };
+const B1_T_CHAR _OUTPUT[] = { 6, 'O', 'U', 'T', 'P', 'U', 'T' };
+const B1_T_CHAR _APPEND[] = { 6, 'A', 'P', 'P', 'E', 'N', 'D' };
+#endif
 
 #ifdef B1_FEATURE_DEBUG
 // string constant to designate FOR loop special variables (non-accessible directly from program)
@@ -110,6 +132,12 @@ const B1_T_CHAR *INPUT_STOP_TOKEN[2] = { _COMMA, NULL };
 const B1_T_CHAR *DIM_STOP_TOKENS[4] = { _TO, _CLBRACKET, _COMMA, NULL };
 const B1_T_CHAR *FOR_STOP_TOKEN1[2] = { _TO, NULL };
 const B1_T_CHAR *FOR_STOP_TOKEN2[2] = { _STEP, NULL };
+#ifdef B1_FEATURE_STMT_MAT
+const B1_T_CHAR *MAT_STOP_TOKEN[2] = { _ASTERISK, NULL };
+#endif
+#ifdef B1_FEATURE_STMT_FILE
+const B1_T_CHAR *OPEN_STOP_TOKEN[2] = { _FOR, NULL };
+#endif
 
 
 // converts C string to uint16_t value
@@ -328,13 +356,34 @@ B1_T_ERROR b1_t_strtoi32(const B1_T_CHAR *cs, int32_t *value)
 B1_T_ERROR b1_t_strtoi32(const B1_T_CHAR *cs, int32_t *value)
 {
 	B1_T_CHAR c;
-	int8_t neg, n;
-	int32_t val, mval;
+	uint8_t neg, n;
+	uint32_t val, lim;
+
+	c = *cs;
 
+	if(B1_T_ISCSTRTERM(c))
+	{
+		return B1_RES_EINVNUM;
+	}
+
+	neg = B1_T_ISMINUS(c);
+
+	if(neg || B1_T_ISPLUS(c))
+	{
+		cs++;
+	}
+
+	// leading zeroes do not affect the value length
+	while(*cs == B1_T_C_0)
+	{
+		cs++;
+	}
+
+	// nine digits fit uint32_t without overflow checks, the tenth digit is checked separately
 	val = 0;
-	neg = 0;
+	lim = neg ? ((uint32_t)INT32_MAX) + 1 : (uint32_t)INT32_MAX;
 
-	while(1)
+	for(n = 0; ; n++)
 	{
 		c = *cs++;
 
@@ -343,166 +392,119 @@ B1_T_ERROR b1_t_strtoi32(const B1_T_CHAR *cs, int32_t *value)
 			break;
 		}
 
-		if(neg == 0)
+		if(!B1_T_ISDIGIT(c))
 		{
-			if(B1_T_ISMINUS(c))
-			{
-				neg++;
-				continue;
-			}
-
-			neg--;
-
-			if(B1_T_ISPLUS(c))
-			{
-				continue;
-			}
+			return B1_RES_EINVNUM;
 		}
 
-		if(B1_T_ISDIGIT(c))
+		if(n >= 9)
 		{
-			n = B1_T_CHAR2NUM(c);
-
-			if(neg == 1)
+			if(n > 9 || val > lim / 10 || (val == lim / 10 && (uint32_t)B1_T_CHAR2NUM(c) > lim % 10))
 			{
-				mval = INT32_MIN;
-
-				if(val < INT32_MIN / 10)
-				{
-					return B1_RES_ENUMOVF;
-				}
-			}
-			else
-			{
-				mval = INT32_MAX;
-
-				if(val > INT32_MAX / 10)
-				{
-					return B1_RES_ENUMOVF;
-				}
+				return B1_RES_ENUMOVF;
 			}
+		}
 
-			val *= 10;
-
-			mval -= val;
+		val = val * 10 + (uint32_t)B1_T_CHAR2NUM(c);
+	}
 
-			if(neg == 1)
-			{
-				n = -n;
+	if(value != NULL)
+	{
+		*value = neg ? (val == 0 ? 0 : -(int32_t)(val - 1) - 1) : (int32_t)val;
+	}
 
-				if(mval > n)
-				{
-					return B1_RES_ENUMOVF;
-				}
-			}
-			else
-			{
-				if(mval < n)
-				{
-					return B1_RES_ENUMOVF;
-				}
-			}
+	return B1_RES_OK;
+}
 
-			val += n;
+// two-character decimal representations of numbers from 0 to 99
+static const char b1_t_digit_pairs[] =
+	"00010203040506070809"
+	"10111213141516171819"
+	"20212223242526272829"
+	"30313233343536373839"
+	"40414243444546474849"
+	"50515253545556575859"
+	"60616263646566676869"
+	"70717273747576777879"
+	"80818283848586878889"
+	"90919293949596979899";
+
+// returns the number of decimal digits in the value
+static uint8_t b1_t_u32_len(uint32_t value)
+{
+	if(value < 100000UL)
+	{
+		if(value < 100UL)
+		{
+			return value < 10UL ? 1 : 2;
+		}
 
-			continue;
+		if(value < 10000UL)
+		{
+			return value < 1000UL ? 3 : 4;
 		}
 
-		return B1_RES_EINVNUM;
+		return 5;
 	}
 
-	if(neg == 0)
+	if(value < 10000000UL)
 	{
-		return B1_RES_EINVNUM;
+		return value < 1000000UL ? 6 : 7;
 	}
 
-	if(value != NULL)
+	if(value < 1000000000UL)
 	{
-		*value = val;
+		return value < 100000000UL ? 8 : 9;
 	}
 
-	return B1_RES_OK;
+	return 10;
 }
 
 B1_T_ERROR b1_t_i32tostr(int32_t value, B1_T_CHAR *sbuf, B1_T_INDEX buflen)
 {
-#if defined(B1_FEATURE_TYPE_SINGLE) || defined(B1_FEATURE_TYPE_DOUBLE)
-#ifdef B1_FEATURE_UNICODE_UCS2
-	char tmpbuf[50];
-	B1_T_INDEX len, i;
-#endif
+	uint8_t neg, len, n;
+	uint32_t uval;
+	B1_T_CHAR *s;
+
+	neg = value < 0;
+	uval = neg ? (uint32_t)0 - (uint32_t)value : (uint32_t)value;
+	len = b1_t_u32_len(uval) + neg;
 
-	if(buflen < 13)
+	if(len >= buflen)
 	{
 		return B1_RES_EBUFSMALL;
 	}
 
-#ifdef B1_FEATURE_UNICODE_UCS2
-	len = (B1_T_CHAR)sprintf(tmpbuf, "%ld", (long int)value);
 	*sbuf = len;
-	for(i = 0; i <= len; i++)
+
+	if(neg)
 	{
-		*(sbuf + 1 + i) = (uint8_t)tmpbuf[i];
+		*(sbuf + 1) = B1_T_C_MINUS;
 	}
-#else
-	*sbuf = (B1_T_CHAR)sprintf((char *)(sbuf + 1), "%ld", (long int)value);
-#endif
-
-	return B1_RES_OK;
-#else
-	B1_T_INDEX start, end;
-	uint8_t n, dnum;
-	B1_T_CHAR c;
 
-	dnum = 0;
+	// digits are written from right to left, two at a time
+	s = sbuf + len;
 
-	if(value < 0)
+	while(uval >= 100)
 	{
-		if(buflen < 3)
-		{
-			return B1_RES_EBUFSMALL;
-		}
-
-		value = -value;
-
-		sbuf[1] = B1_T_C_MINUS;
-		dnum++;
+		n = (uint8_t)((uval % 100) * 2);
+		uval /= 100;
+		*s-- = (B1_T_CHAR)b1_t_digit_pairs[n + 1];
+		*s-- = (B1_T_CHAR)b1_t_digit_pairs[n];
 	}
 
-	end = dnum;
-	end++;
-
-	start = end;
-
-	for(; ; end++)
+	if(uval >= 10)
 	{
-		if(end == buflen)
-		{
-			return B1_RES_EBUFSMALL;
-		}
-
-		n = ((uint32_t)value) % 10;
-		value = ((uint32_t)value) / 10;
-
-		sbuf[end] = B1_T_NUM2CHAR(n);
-
-		if(value == 0)
-		{
-			break;
-		}
+		n = (uint8_t)(uval * 2);
+		*s-- = (B1_T_CHAR)b1_t_digit_pairs[n + 1];
+		*s = (B1_T_CHAR)b1_t_digit_pairs[n];
 	}
-
-	sbuf[0] = end;
-
-	for(; start < end; start++, end--)
+	else
 	{
-		c = sbuf[start];
-		sbuf[start] = sbuf[end];
-		sbuf[end] = c;
+		*s = B1_T_NUM2CHAR(uval);
 	}
 
 	return B1_RES_OK;
-#endif
 }
 
 #if defined(B1_FEATURE_TYPE_SINGLE) || defined(B1_FEATURE_TYPE_DOUBLE)
@@ -693,16 +695,692 @@ static void b1_t_fp_to_exp_form(B1_T_CHAR *s, int8_t e, uint8_t max_len)
 	// write string length
 	*s = end;
 }
+
+#ifdef B1_FEATURE_FP_SHORTEST_DIGITS
+// the shortest decimal significand of a floating point value that converts back to the same value is generated
+// with Grisu2 algorithm (by Florian Loitsch) using 64-bit integer arithmetic
+
+// 64-bit floating point number with 64-bit significand (f * 2 ^ e)
+typedef struct
+{
+	uint64_t f;
+	int16_t e;
+} B1_T_FP_DIY;
+
+// normalized significands and binary exponents of 10 ^ -348, 10 ^ -340, ..., 10 ^ 340 values
+static const uint64_t b1_t_fp_cpow_f[87] =
+{
+	0xfa8fd5a0081c0288ULL, 0xbaaee17fa23ebf76ULL, 0x8b16fb203055ac76ULL,
+	0xcf42894a5dce35eaULL, 0x9a6bb0aa55653b2dULL, 0xe61acf033d1a45dfULL,
+	0xab70fe17c79ac6caULL, 0xff77b1fcbebcdc4fULL, 0xbe5691ef416bd60cULL,
+	0x8dd01fad907ffc3cULL, 0xd3515c2831559a83ULL, 0x9d71ac8fada6c9b5ULL,
+	0xea9c227723ee8bcbULL, 0xaecc49914078536dULL, 0x823c12795db6ce57ULL,
+	0xc21094364dfb5637ULL, 0x9096ea6f3848984fULL, 0xd77485cb25823ac7ULL,
+	0xa086cfcd97bf97f4ULL, 0xef340a98172aace5ULL, 0xb23867fb2a35b28eULL,
+	0x84c8d4dfd2c63f3bULL, 0xc5dd44271ad3cdbaULL, 0x936b9fcebb25c996ULL,
+	0xdbac6c247d62a584ULL, 0xa3ab66580d5fdaf6ULL, 0xf3e2f893dec3f126ULL,
+	0xb5b5ada8aaff80b8ULL, 0x87625f056c7c4a8bULL, 0xc9bcff6034c13053ULL,
+	0x964e858c91ba2655ULL, 0xdff9772470297ebdULL, 0xa6dfbd9fb8e5b88fULL,
+	0xf8a95fcf88747d94ULL, 0xb94470938fa89bcfULL, 0x8a08f0f8bf0f156bULL,
+	0xcdb02555653131b6ULL, 0x993fe2c6d07b7facULL, 0xe45c10c42a2b3b06ULL,
+	0xaa242499697392d3ULL, 0xfd87b5f28300ca0eULL, 0xbce5086492111aebULL,
+	0x8cbccc096f5088ccULL, 0xd1b71758e219652cULL, 0x9c40000000000000ULL,
+	0xe8d4a51000000000ULL, 0xad78ebc5ac620000ULL, 0x813f3978f8940984ULL,
+	0xc097ce7bc90715b3ULL, 0x8f7e32ce7bea5c70ULL, 0xd5d238a4abe98068ULL,
+	0x9f4f2726179a2245ULL, 0xed63a231d4c4fb27ULL, 0xb0de65388cc8ada8ULL,
+	0x83c7088e1aab65dbULL, 0xc45d1df942711d9aULL, 0x924d692ca61be758ULL,
+	0xda01ee641a708deaULL, 0xa26da3999aef774aULL, 0xf209787bb47d6b85ULL,
+	0xb454e4a179dd1877ULL, 0x865b86925b9bc5c2ULL, 0xc83553c5c8965d3dULL,
+	0x952ab45cfa97a0b3ULL, 0xde469fbd99a05fe3ULL, 0xa59bc234db398c25ULL,
+	0xf6c69a72a3989f5cULL, 0xb7dcbf5354e9beceULL, 0x88fcf317f22241e2ULL,
+	0xcc20ce9bd35c78a5ULL, 0x98165af37b2153dfULL, 0xe2a0b5dc971f303aULL,
+	0xa8d9d1535ce3b396ULL, 0xfb9b7cd9a4a7443cULL, 0xbb764c4ca7a44410ULL,
+	0x8bab8eefb6409c1aULL, 0xd01fef10a657842cULL, 0x9b10a4e5e9913129ULL,
+	0xe7109bfba19c0c9dULL, 0xac2820d9623bf429ULL, 0x80444b5e7aa7cf85ULL,
+	0xbf21e44003acdd2dULL, 0x8e679c2f5e44ff8fULL, 0xd433179d9c8cb841ULL,
+	0x9e19db92b4e31ba9ULL, 0xeb96bf6ebadf77d9ULL, 0xaf87023b9bf0ee6bULL
+};
+
+static const int16_t b1_t_fp_cpow_e[87] =
+{
+	-1220, -1193, -1166, -1140, -1113, -1087, -1060, -1034, -1007, -980, -954, -927,
+	-901, -874, -847, -821, -794, -768, -741, -715, -688, -661, -635, -608,
+	-582, -555, -529, -502, -475, -449, -422, -396, -369, -343, -316, -289,
+	-263, -236, -210, -183, -157, -130, -103, -77, -50, -24, 3, 30,
+	56, 83, 109, 136, 162, 189, 216, 242, 269, 295, 322, 348,
+	375, 402, 428, 455, 481, 508, 534, 561, 588, 614, 641, 667,
+	694, 720, 747, 774, 800, 827, 853, 880, 907, 933, 960, 986,
+	1013, 1039, 1066
+};
+
+static const uint32_t b1_t_fp_pow10[10] =
+{
+	1UL, 10UL, 100UL, 1000UL, 10000UL, 100000UL, 1000000UL, 10000000UL, 100000000UL, 1000000000UL
+};
+
+static void b1_t_fp_norm(B1_T_FP_DIY *x)
+{
+	while(!((*x).f & (((uint64_t)1) << 63)))
+	{
+		(*x).f <<= 1;
+		(*x).e--;
+	}
+}
+
+// x = x * y, the product significand is rounded to 64 bits
+static void b1_t_fp_mul(B1_T_FP_DIY *x, const B1_T_FP_DIY *y)
+{
+	uint64_t a, b, c, d, ad, bc, tmp;
+
+	a = (*x).f >> 32;
+	b = (*x).f & 0xFFFFFFFFUL;
+	c = (*y).f >> 32;
+	d = (*y).f & 0xFFFFFFFFUL;
+
+	ad = a * d;
+	bc = b * c;
+	tmp = ((b * d) >> 32) + (ad & 0xFFFFFFFFUL) + (bc & 0xFFFFFFFFUL) + (((uint64_t)1) << 31);
+
+	(*x).f = a * c + (ad >> 32) + (bc >> 32) + (tmp >> 32);
+	(*x).e += (*y).e + 64;
+}
+
+// selects the cached power of ten bringing the binary exponent e of a normalized value into [-59, -32] range after
+// multiplication, returns its negated decimal exponent
+static int16_t b1_t_fp_cpow(int16_t e, B1_T_FP_DIY *c)
+{
+	int16_t i;
+
+	// ceil((-61 - e) * log10(2)) + 347, log10(2) is approximated with 78913 / 2 ^ 18
+	i = (int16_t)(((int32_t)(-61 - e) * 78913L + 347L * 262144L + 262143L) >> 18);
+	i = (i >> 3) + 1;
+	(*c).f = b1_t_fp_cpow_f[i];
+	(*c).e = b1_t_fp_cpow_e[i];
+
+	return 348 - i * 8;
+}
+
+// moves the last digit closer to the value while the digits stay within the rounding interval
+static void b1_t_fp_grisu_round(uint8_t *d, uint8_t len, uint64_t delta, uint64_t rest, uint64_t ten_kappa, uint64_t wp_w)
+{
+	while(rest < wp_w && delta - rest >= ten_kappa && (rest + ten_kappa < wp_w || wp_w - rest > rest + ten_kappa - wp_w))
+	{
+		(*(d + len - 1))--;
+		rest += ten_kappa;
+	}
+}
+
+// generates the shortest decimal significand digits of f * 2 ^ e value, lower_closer should be set if the value
+// is a power of two so that its lower neighbour is twice closer than the upper one, returns the number of digits,
+// k is set to the decimal exponent of the last digit
+static uint8_t b1_t_fp_digits(uint64_t f, int16_t e, uint8_t lower_closer, uint8_t *d, int16_t *k)
+{
+	B1_T_FP_DIY w, wp, wm, c;
+	uint64_t one, delta, wp_w, p2;
+	uint32_t p1;
+	int16_t kappa;
+	uint8_t len, dg;
+
+	// boundaries of the interval rounding to the value
+	wp.f = (f << 1) + 1;
+	wp.e = e - 1;
+	b1_t_fp_norm(&wp);
+
+	if(lower_closer)
+	{
+		wm.f = (f << 2) - 1;
+		wm.e = e - 2;
+	}
+	else
+	{
+		wm.f = (f << 1) - 1;
+		wm.e = e - 1;
+	}
+	wm.f <<= wm.e - wp.e;
+	wm.e = wp.e;
+
+	w.f = f;
+	w.e = e;
+	b1_t_fp_norm(&w);
+
+	*k = b1_t_fp_cpow(wp.e, &c);
+
+	b1_t_fp_mul(&w, &c);
+	b1_t_fp_mul(&wp, &c);
+	b1_t_fp_mul(&wm, &c);
+	wm.f++;
+	wp.f--;
+
+	delta = wp.f - wm.f;
+	wp_w = wp.f - w.f;
+	one = ((uint64_t)1) << -wp.e;
+	p1 = (uint32_t)(wp.f >> -wp.e);
+	p2 = wp.f & (one - 1);
+
+	// integer part digits
+	for(kappa = 1; kappa < 10 && p1 >= b1_t_fp_pow10[kappa]; kappa++);
+
+	len = 0;
+
+	while(kappa > 0)
+	{
+		kappa--;
+		dg = (uint8_t)(p1 / b1_t_fp_pow10[kappa]);
+		p1 %= b1_t_fp_pow10[kappa];
+
+		if(dg != 0 || len != 0)
+		{
+			*(d + len++) = dg;
+		}
+
+		if((((uint64_t)p1) << -wp.e) + p2 <= delta)
+		{
+			*k += kappa;
+			b1_t_fp_grisu_round(d, len, delta, (((uint64_t)p1) << -wp.e) + p2, ((uint64_t)b1_t_fp_pow10[kappa]) << -wp.e,
+				wp_w);
+			return len;
+		}
+	}
+
+	// fractional part digits
+	while(1)
+	{
+		p2 *= 10;
+		delta *= 10;
+		dg = (uint8_t)(p2 >> -wp.e);
+
+		if(dg != 0 || len != 0)
+		{
+			*(d + len++) = dg;
+		}
+
+		p2 &= one - 1;
+		kappa--;
+
+		if(p2 < delta)
+		{
+			*k += kappa;
+			b1_t_fp_grisu_round(d, len, delta, p2, one, -kappa < 10 ? wp_w * b1_t_fp_pow10[-kappa] : 0);
+			return len;
+		}
+	}
+}
+
+// generates cnt significand digits of f * 2 ^ e value rounded half up, k is set to the decimal exponent of the
+// last digit, returns 0 if 64-bit precision is not enough to round the value correctly (e.g. the value is too close
+// to the middle between two cnt digits long decimals)
+static uint8_t b1_t_fp_digits_fixed(uint64_t f, int16_t e, int16_t cnt, uint8_t *d, int16_t *k)
+{
+	B1_T_FP_DIY w, c;
+	uint64_t one, rest, unit, ten_kappa;
+	uint32_t p1;
+	int16_t kappa, i;
+
+	// 64-bit significand cannot provide more correct digits
+	if(cnt > 20)
+	{
+		return 0;
+	}
+
+	w.f = f;
+	w.e = e;
+	b1_t_fp_norm(&w);
+
+	*k = b1_t_fp_cpow(w.e, &c);
+	b1_t_fp_mul(&w, &c);
+
+	// the product error is less than one unit of its last place
+	unit = 1;
+	one = ((uint64_t)1) << -w.e;
+	p1 = (uint32_t)(w.f >> -w.e);
+	rest = w.f & (one - 1);
+
+	for(kappa = 1; kappa < 10 && p1 >= b1_t_fp_pow10[kappa]; kappa++);
+
+	for(i = 0; kappa > 0 && i < cnt; i++)
+	{
+		kappa--;
+		*(d + i) = (uint8_t)(p1 / b1_t_fp_pow10[kappa]);
+		p1 %= b1_t_fp_pow10[kappa];
+	}
+
+	if(i == cnt)
+	{
+		rest += ((uint64_t)p1) << -w.e;
+		ten_kappa = ((uint64_t)b1_t_fp_pow10[kappa]) << -w.e;
+	}
+	else
+	{
+		for(; i < cnt; i++)
+		{
+			if(rest <= unit)
+			{
+				return 0;
+			}
+
+			rest *= 10;
+			unit *= 10;
+			*(d + i) = (uint8_t)(rest >> -w.e);
+			rest &= one - 1;
+			kappa--;
+		}
+
+		ten_kappa = one;
+	}
+
+	*k += kappa;
+
+	if(unit >= ten_kappa || ten_kappa - unit <= unit)
+	{
+		return 0;
+	}
+
+	// the rest is surely less than a half of the last digit unit: round down
+	if(ten_kappa - rest > rest && ten_kappa - 2 * rest >= 2 * unit)
+	{
+		return 1;
+	}
+
+	// the rest is surely greater than the half: round up
+	if(rest > unit && ten_kappa - (rest - unit) <= rest - unit)
+	{
+		for(i = cnt - 1; i >= 0 && *(d + i) == 9; i--)
+		{
+			*(d + i) = 0;
+		}
+
+		if(i < 0)
+		{
+			*d = 1;
+			(*k)++;
+		}
+		else
+		{
+			(*(d + i))++;
+		}
+
+		return 1;
+	}
+
+	return 0;
+}
+
+// rounds the value to cnt significand digits (if it has more digits), e is the decimal exponent of the first digit,
+// returns 0 if the rounding cannot be performed correctly
+static uint8_t b1_t_fp_round_digits(uint64_t f, int16_t e2, uint8_t *d, uint8_t *len, int16_t *e, int16_t cnt)
+{
+	int16_t k;
+
+	if(cnt < 1)
+	{
+		cnt = 1;
+	}
+
+	if(cnt < *len)
+	{
+		if(!b1_t_fp_digits_fixed(f, e2, cnt, d, &k))
+		{
+			return 0;
+		}
+
+		*len = (uint8_t)cnt;
+		*e = cnt + k - 1;
+
+		while(*len > 1 && *(d + *len - 1) == 0)
+		{
+			(*len)--;
+		}
+	}
+
+	return 1;
+}
+
+// converts non-negative non-zero finite value to string, the output format is the same as the one produced by
+// b1_t_singletostr and b1_t_doubletostr functions: the value is written in fixed-point form if it fits max_len
+// characters and in exponential form otherwise, mant_dig and min_exp are characteristics of the value type
+// (FLT_MANT_DIG, FLT_MIN_EXP or DBL_MANT_DIG, DBL_MIN_EXP), returns 0 if the value cannot be rounded correctly
+// to fit max_len characters
+static uint8_t b1_t_fp_shortest_tostr(double value, uint8_t neg, int16_t mant_dig, int16_t min_exp, B1_T_CHAR *sbuf,
+	uint8_t max_len)
+{
+	uint8_t d[24], len, i, use_exp, lower_closer;
+	int16_t be, e, k, n;
+	int e2;
+	uint64_t f;
+	B1_T_CHAR *s;
+
+	// value = f * 2 ^ be
+	f = (uint64_t)ldexp(frexp(value, &e2), mant_dig);
+	be = (int16_t)(e2 - mant_dig);
+	min_exp -= mant_dig;
+	if(be < min_exp)
+	{
+		// denormalized value
+		f >>= min_exp - be;
+		be = min_exp;
+	}
+
+	lower_closer = (uint8_t)(f == (((uint64_t)1) << (mant_dig - 1)) && be > min_exp);
+	len = b1_t_fp_digits(f, be, lower_closer, d, &k);
+
+	// decimal exponent of the first digit
+	e = len + k - 1;
+
+	use_exp = 0;
+
+	if(e >= 0)
+	{
+		// integer part length
+		n = e + 1;
+
+		if(n > max_len)
+		{
+			use_exp = 1;
+		}
+		else
+		{
+			// leave the rest of max_len characters (except for one reserved for point) for fractional part
+			k = max_len - n;
+			if(k != 0)
+			{
+				k--;
+			}
+
+			if(len < n)
+			{
+				// write exact integer part digits instead of padding the shortest significand with zeroes
+				// (if the precision is enough)
+				if(b1_t_fp_digits_fixed(f, be, n, d, &k))
+				{
+					len = (uint8_t)n;
+					e = n + k - 1;
+
+					while(len > 1 && *(d + len - 1) == 0)
+					{
+						len--;
+					}
+				}
+				else
+				{
+					len = b1_t_fp_digits(f, be, lower_closer, d, &k);
+				}
+			}
+			else
+			if(!b1_t_fp_round_digits(f, be, d, &len, &e, n + k))
+			{
+				return 0;
+			}
+
+			// rounding can increase integer part length
+			use_exp = e + 1 > max_len;
+		}
+	}
+	else
+	{
+		if(e < -3 && max_len + e < 3)
+		{
+			use_exp = 1;
+		}
+		else
+		{
+			// fractional digits to leave, at least one significant digit
+			n = max_len - 1;
+			if(n <= -(e + 1))
+			{
+				n = -e;
+			}
+
+			if(!b1_t_fp_round_digits(f, be, d, &len, &e, n + e + 1))
+			{
+				return 0;
+			}
+		}
+	}
+
+	s = sbuf + 1;
+
+	if(neg)
+	{
+		*s++ = B1_T_C_MINUS;
+	}
+
+	if(use_exp)
+	{
+		// significand length: max_len minus point and exponent (E letter, optional minus sign, digits) lengths
+		n = max_len - 1;
+		if(e != 0)
+		{
+			n -= 2 + (e < 0) + (e > 9 || e < -9) + (e > 99 || e < -99);
+		}
+
+		if(!b1_t_fp_round_digits(f, be, d, &len, &e, n))
+		{
+			return 0;
+		}
+
+		*s++ = B1_T_NUM2CHAR(*d);
+		if(len > 1)
+		{
+			*s++ = B1_T_C_POINT;
+
+			for(i = 1; i < len; i++)
+			{
+				*s++ = B1_T_NUM2CHAR(*(d + i));
+			}
+		}
+
+		if(e != 0)
+		{
+			*s++ = B1_T_C_UCE;
+
+			if(e < 0)
+			{
+				*s++ = B1_T_C_MINUS;
+				e = -e;
+			}
+
+			if(e > 99)
+			{
+				*s++ = B1_T_NUM2CHAR(e / 100);
+			}
+
+			if(e > 9)
+			{
+				*s++ = B1_T_NUM2CHAR((e / 10) % 10);
+			}
+
+			*s++ = B1_T_NUM2CHAR(e % 10);
+		}
+	}
+	else
+	if(e >= 0)
+	{
+		// integer part (padded with zeroes) and fractional part
+		for(n = 0; n <= e; n++)
+		{
+			*s++ = n < len ? B1_T_NUM2CHAR(*(d + n)) : B1_T_C_0;
+		}
+
+		if(len > e + 1)
+		{
+			*s++ = B1_T_C_POINT;
+
+			for(; n < len; n++)
+			{
+				*s++ = B1_T_NUM2CHAR(*(d + n));
+			}
+		}
+	}
+	else
+	{
+		// less than 1 values are written without leading zero
+		*s++ = B1_T_C_POINT;
+
+		for(n = -1; n > e; n--)
+		{
+			*s++ = B1_T_C_0;
+		}
+
+		for(i = 0; i < len; i++)
+		{
+			*s++ = B1_T_NUM2CHAR(*(d + i));
+		}
+	}
+
+	*sbuf = (B1_T_CHAR)(s - sbuf - 1);
+
+	return 1;
+}
+#endif
+
+// powers of ten exactly representable with double type
+#if DBL_MANT_DIG >= 53
+#define B1_T_FP_EXACT_POW10_MAX 22
+#define B1_T_FP_EXACT_DIGITS_MAX 15
+#else
+#define B1_T_FP_EXACT_POW10_MAX 10
+#define B1_T_FP_EXACT_DIGITS_MAX 7
+#endif
+
+static const double b1_t_fp_exact_pow10[B1_T_FP_EXACT_POW10_MAX + 1] =
+{
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+#if DBL_MANT_DIG >= 53
+	1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+#endif
+};
+
+// converts C string consisting of optional sign, digits with optional point and optional exponent to double value
+// if the conversion can be done exactly: the significand digits and the power of ten are both exactly representable
+// so the only rounding is done by the final multiplication or division (Clinger's fast path), returns 0 if the string
+// has to be converted with atof function
+static uint8_t b1_t_strtofp_fast(const B1_T_CHAR *cs, double *value)
+{
+	B1_T_CHAR c;
+	uint8_t neg, eneg, digits, any;
+	int16_t e, ev;
+	double w;
+
+	neg = B1_T_ISMINUS(*cs);
+	if(neg || B1_T_ISPLUS(*cs))
+	{
+		cs++;
+	}
+
+	w = 0.0;
+	e = 0;
+	digits = 0;
+	any = 0;
+
+	// integer part
+	for(c = *cs; B1_T_ISDIGIT(c); c = *++cs)
+	{
+		any = 1;
+
+		if(digits != 0 || c != B1_T_C_0)
+		{
+			if(digits == B1_T_FP_EXACT_DIGITS_MAX)
+			{
+				return 0;
+			}
+
+			digits++;
+			w = w * 10.0 + (double)B1_T_CHAR2NUM(c);
+		}
+	}
+
+	// fractional part
+	if(c == B1_T_C_POINT)
+	{
+		for(c = *++cs; B1_T_ISDIGIT(c); c = *++cs)
+		{
+			any = 1;
+			e--;
+
+			if(digits != 0 || c != B1_T_C_0)
+			{
+				if(digits == B1_T_FP_EXACT_DIGITS_MAX)
+				{
+					return 0;
+				}
+
+				digits++;
+				w = w * 10.0 + (double)B1_T_CHAR2NUM(c);
+			}
+		}
+	}
+
+	if(!any)
+	{
+		return 0;
+	}
+
+	// exponent
+	if(c == B1_T_C_UCE || c == B1_T_C_LCE)
+	{
+		c = *++cs;
+		eneg = B1_T_ISMINUS(c);
+		if(eneg || B1_T_ISPLUS(c))
+		{
+			c = *++cs;
+		}
+
+		if(!B1_T_ISDIGIT(c))
+		{
+			return 0;
+		}
+
+		for(ev = 0; B1_T_ISDIGIT(c); c = *++cs)
+		{
+			if(ev > 999)
+			{
+				return 0;
+			}
+
+			ev = ev * 10 + B1_T_CHAR2NUM(c);
+		}
+
+		e += eneg ? -ev : ev;
+	}
+
+	if(!B1_T_ISCSTRTERM(c))
+	{
+		return 0;
+	}
+
+	if(w != 0.0)
+	{
+		if(e < -B1_T_FP_EXACT_POW10_MAX || e > B1_T_FP_EXACT_POW10_MAX)
+		{
+			return 0;
+		}
+
+		w = e < 0 ? w / b1_t_fp_exact_pow10[-e] : w * b1_t_fp_exact_pow10[e];
+	}
+
+	*value = neg ? -w : w;
+
+	return 1;
+}
 #endif
 
 #ifdef B1_FEATURE_TYPE_SINGLE
-// temporary implementation: just a replace to atof
+// uses atof function if the fast path conversion cannot be done
 B1_T_ERROR b1_t_strtosingle(const B1_T_CHAR *cs, float *value)
 {
 #ifdef B1_FEATURE_UNICODE_UCS2
 	char tmpbuf[51];
 	B1_T_INDEX i;
+#endif
+	double d;
+
+	if(b1_t_strtofp_fast(cs, &d))
+	{
+		*value = (float)d;
+		return B1_RES_OK;
+	}
 
+#ifdef B1_FEATURE_UNICODE_UCS2
 	for(i = 0; i < 50; i++)
 	{
 		if(cs[i] == 0)
@@ -783,6 +1461,23 @@ B1_T_ERROR b1_t_singletostr(float value, B1_T_CHAR *sbuf, B1_T_INDEX buflen, uin
 		}
 	}
 
+#ifdef B1_FEATURE_FP_SHORTEST_DIGITS
+	if(!nan)
+	{
+		// the value can be written in fixed-point form with integer part padded with zeroes (up to max_len characters)
+		if(buflen - 4 < max_len)
+		{
+			return B1_RES_EBUFSMALL;
+		}
+
+		// the value is converted with sprintf function below if the digits cannot be rounded correctly here
+		if(b1_t_fp_shortest_tostr(value, neg, FLT_MANT_DIG, FLT_MIN_EXP, sbuf, max_len))
+		{
+			return B1_RES_OK;
+		}
+	}
+#endif
+
 #ifdef B1_FEATURE_UNICODE_UCS2
 	n = (B1_T_INDEX)sprintf(tmpbuf, lt1 ? "%.47f" : "%.9f", value);
 	for(start = 0; start <= n; start++)
@@ -911,13 +1606,20 @@ B1_T_ERROR b1_t_singletostr(float value, B1_T_CHAR *sbuf, B1_T_INDEX buflen, uin
 #endif
 
 #ifdef B1_FEATURE_TYPE_DOUBLE
-// temporary implementation: just a replace to atof
+// uses atof function if the fast path conversion cannot be done
 B1_T_ERROR b1_t_strtodouble(const B1_T_CHAR *cs, double *value)
 {
 #ifdef B1_FEATURE_UNICODE_UCS2
 	char tmpbuf[51];
 	B1_T_INDEX i;
+#endif
 
+	if(b1_t_strtofp_fast(cs, value))
+	{
+		return B1_RES_OK;
+	}
+
+#ifdef B1_FEATURE_UNICODE_UCS2
 	for(i = 0; i < 50; i++)
 	{
 		if(cs[i] == 0)
@@ -1001,6 +1703,24 @@ B1_T_ERROR b1_t_doubletostr(double value, B1_T_CHAR *sbuf, B1_T_INDEX buflen, ui
 			lt1++;
 		}
 	}
+
+#ifdef B1_FEATURE_FP_SHORTEST_DIGITS
+	if(!nan)
+	{
+		// the value can be written in fixed-point form with integer part padded with zeroes (up to max_len characters)
+		if(buflen - 4 < max_len)
+		{
+			return B1_RES_EBUFSMALL;
+		}
+
+		// the value is converted with sprintf function below if the digits cannot be rounded correctly here
+		if(b1_t_fp_shortest_tostr(value, neg, DBL_MANT_DIG, DBL_MIN_EXP, sbuf, max_len))
+		{
+			return B1_RES_OK;
+		}
+	}
+#endif
+
 #ifdef B1_FEATURE_UNICODE_UCS2
 	n = (B1_T_INDEX)sprintf(tmpbuf, lt1 ? "%.47f" : "%.18f", value);
 	for(start = 0; start <= n; start++)
@@ -1131,46 +1851,31 @@ B1_T_ERROR b1_t_doubletostr(double value, B1_T_CHAR *sbuf, B1_T_INDEX buflen, ui
 
 int8_t b1_t_strcmpi(const B1_T_CHAR *s1, const B1_T_CHAR *s2data, B1_T_INDEX s2len)
 {
-	B1_T_INDEX s1len, i;
+	B1_T_INDEX s1len, len;
 	B1_T_CHAR c1, c2;
 	
-	i = 0;
 	s1len = *s1++;
+	len = s1len < s2len ? s1len : s2len;
 
-	while(1)
+	while(len-- != 0)
 	{
-		if(i == s1len && i == s2len)
-		{
-			break;
-		}
+		c1 = *s1++;
+		c2 = *s2data++;
 
-		if(i == s1len)
+		// convert characters to upper case only if they differ
+		if(c1 != c2)
 		{
-			return -1;
-		}
+			c1 = B1_T_TOUPPER(c1);
+			c2 = B1_T_TOUPPER(c2);
 
-		if(i == s2len)
-		{
-			return 1;
-		}
-
-		c1 = B1_T_TOUPPER(*(s1 + i));
-		c2 = B1_T_TOUPPER(*(s2data + i));
-
-		if(c1 > c2)
-		{
-			return 1;
-		}
-		
-		if(c1 < c2)
-		{
-			return -1;
+			if(c1 != c2)
+			{
+				return c1 > c2 ? 1 : -1;
+			}
 		}
-
-		i++;
 	}
 
-	return 0;
+	return s1len == s2len ? 0 : s1len > s2len ? 1 : -1;
 }
 
 B1_T_ERROR b1_t_get_type_by_type_spec(B1_T_CHAR type_spec_char, uint8_t expl_type, uint8_t *res_type)
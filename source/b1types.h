@@ -46,6 +46,10 @@
 // internally used boolean value
 #define B1_TYPE_BOOL ((uint8_t)0x10)
 
+#ifdef B1_FEATURE_FUNCTIONS_ARRAY
+// special type: whole array reference (argument of array functions)
+#define B1_TYPE_ARRAY_REF ((uint8_t)0x1A)
+#endif
 // special TAB value (PRINT statement TAB function)
 #define B1_TYPE_TAB_FN ((uint8_t)0x1B)
 // special SPC value (PRINT statement SPC function)
@@ -149,9 +153,10 @@
 	|| ((B1_T_CHAR)(C) == B1_T_C_OPBRACK) || ((B1_T_CHAR)(C) == B1_T_C_CLBRACK) || ((B1_T_CHAR)(C) == B1_T_C_EQ) \
 	|| ((B1_T_CHAR)(C) == B1_T_C_LT) || ((B1_T_CHAR)(C) == B1_T_C_GT) || B1_T_ISCOMMA(C)  || B1_T_ISSEMICOLON(C))
 
-// the macros below should support English letters only (they are used for processing program keywords)
-#define B1_T_ISUPPER(C) (((B1_T_CHAR)(C) >= B1_T_C_UCA) && ((B1_T_CHAR)(C) <= B1_T_C_UCZ))
-#define B1_T_ISLOWER(C) (((B1_T_CHAR)(C) >= B1_T_C_LCA) && ((B1_T_CHAR)(C) <= B1_T_C_LCZ))
+// the macros below should support English letters only (they are used for processing program keywords),
+// B1_T_CHAR type is unsigned so a range check needs one comparison only
+#define B1_T_ISUPPER(C) ((B1_T_CHAR)((B1_T_CHAR)(C) - B1_T_C_UCA) <= (B1_T_CHAR)(B1_T_C_UCZ - B1_T_C_UCA))
+#define B1_T_ISLOWER(C) ((B1_T_CHAR)((B1_T_CHAR)(C) - B1_T_C_LCA) <= (B1_T_CHAR)(B1_T_C_LCZ - B1_T_C_LCA))
 #define B1_T_ISALPHA(C) (B1_T_ISUPPER(C) || B1_T_ISLOWER(C))
 #define B1_T_ALPHA2NUM(C) (B1_T_TOUPPER(C) - B1_T_C_UCA)
 #define B1_T_TOUPPER(C) (B1_T_ISLOWER(C) ? ((B1_T_CHAR)(((B1_T_CHAR)(C)) - B1_T_C_LCA + B1_T_C_UCA)) : (B1_T_CHAR)(C))
@@ -260,6 +265,25 @@ extern const B1_T_CHAR _AND[];
 extern const B1_T_CHAR _OR[];
 extern const B1_T_CHAR _XOR[];
 extern const B1_T_CHAR _NOT[];
+#ifdef B1_FEATURE_STMT_MAT
+extern const B1_T_CHAR _ASTERISK[];
+extern const B1_T_CHAR _ZER[];
+extern const B1_T_CHAR _CON[];
+extern const B1_T_CHAR _IDN[];
+extern const B1_T_CHAR _TRN[];
+#ifdef B1_FEATURE_FUNCTIONS_MATH_BASIC
+extern const B1_T_CHAR _RND[];
+#endif
+#endif
+#ifdef B1_FEATURE_TYPE_MAP
+extern const B1_T_CHAR _MAP[];
+extern const B1_T_CHAR _OF[];
+#endif
+#ifdef B1_FEATURE_STMT_FILE
+extern const B1_T_CHAR _FOR[];
+extern const B1_T_CHAR _OUTPUT[];
+extern const B1_T_CHAR _APPEND[];
+#endif
 
 #ifdef B1_FEATURE_DEBUG
 extern const B1_T_CHAR _DBG_FORVAR[];
@@ -278,6 +302,12 @@ extern const B1_T_CHAR *INPUT_STOP_TOKEN[];
 extern const B1_T_CHAR *DIM_STOP_TOKENS[];
 extern const B1_T_CHAR *FOR_STOP_TOKEN1[];
 extern const B1_T_CHAR *FOR_STOP_TOKEN2[];
+#ifdef B1_FEATURE_STMT_MAT
+extern const B1_T_CHAR *MAT_STOP_TOKEN[];
+#endif
+#ifdef B1_FEATURE_STMT_FILE
+extern const B1_T_CHAR *OPEN_STOP_TOKEN[];
+#endif
 
 
 extern B1_T_ERROR b1_t_strtoui16(const B1_T_CHAR *cs, uint16_t *value);
@@ -301,6 +331,10 @@ extern B1_T_ERROR b1_t_get_type_by_name(const B1_T_CHAR *str, B1_T_INDEX len, ui
 #error B1_FEATURE_FUNCTIONS_STANDARD must be enabled for B1_FEATURE_MINIMAL_EVALUATION feature
 #endif
 
+#if defined(B1_FEATURE_MINIMAL_EVALUATION_AND_OR) && !defined(B1_FEATURE_MINIMAL_EVALUATION)
+#error B1_FEATURE_MINIMAL_EVALUATION_AND_OR feature requires B1_FEATURE_MINIMAL_EVALUATION feature to be enabled
+#endif
+
 #if defined(B1_FEATURE_DEBUG) && !defined(B1_FEATURE_INIT_FREE_MEMORY)
 #error B1_FEATURE_DEBUG feature requires B1_FEATURE_INIT_FREE_MEMORY to be enabled
 #endif
@@ -313,6 +347,54 @@ extern B1_T_ERROR b1_t_get_type_by_name(const B1_T_CHAR *str, B1_T_INDEX len, ui
 #error no one fractional type is supported, check B1_FRACTIONAL_TYPE_EXISTS definition
 #endif
 
+#if defined(B1_FEATURE_STMT_MAT) && !defined(B1_FRACTIONAL_TYPE_EXISTS)
+#error B1_FEATURE_STMT_MAT feature requires SINGLE or DOUBLE type to be enabled
+#endif
+
+#if defined(B1_FEATURE_FUNCTIONS_ARRAY) && !defined(B1_FRACTIONAL_TYPE_EXISTS)
+#error B1_FEATURE_FUNCTIONS_ARRAY feature requires SINGLE or DOUBLE type to be enabled
+#endif
+
+#if defined(B1_FEATURE_FP_SHORTEST_DIGITS) && !defined(B1_FRACTIONAL_TYPE_EXISTS)
+#error B1_FEATURE_FP_SHORTEST_DIGITS feature requires SINGLE or DOUBLE type to be enabled
+#endif
+
+#if defined(B1_FEATURE_STMT_SORT) && !defined(B1_FEATURE_FUNCTIONS_ARRAY)
+#error B1_FEATURE_STMT_SORT feature requires B1_FEATURE_FUNCTIONS_ARRAY feature to be enabled
+#endif
+
+#if defined(B1_FEATURE_TYPE_MAP) && !defined(B1_FEATURE_FUNCTIONS_ARRAY)
+#error B1_FEATURE_TYPE_MAP feature requires B1_FEATURE_FUNCTIONS_ARRAY feature to be enabled
+#endif
+
+#if defined(B1_FEATURE_STMT_FUNCTION) && !defined(B1_FEATURE_FUNCTIONS_USER)
+#error B1_FEATURE_STMT_FUNCTION feature requires B1_FEATURE_FUNCTIONS_USER feature to be enabled
+#endif
+
+#if defined(B1_FEATURE_STMT_FILE) && (!defined(B1_FEATURE_TOKEN_TYPE_DEVNAME) || !defined(B1_FEATURE_FUNCTIONS_STANDARD))
+#error B1_FEATURE_STMT_FILE feature requires B1_FEATURE_TOKEN_TYPE_DEVNAME and B1_FEATURE_FUNCTIONS_STANDARD features to be enabled
+#endif
+
+#if defined(B1_FEATURE_STMT_FILE) && (B1_MAX_FILE_CHAN_NUM < 1 || B1_MAX_FILE_CHAN_NUM > 255)
+#error B1_MAX_FILE_CHAN_NUM value must be not less than 1 and not greater than 255
+#endif
+
+#if defined(B1_FEATURE_FUNCTIONS_USER_MEMO) && !defined(B1_FEATURE_FUNCTIONS_USER)
+#error B1_FEATURE_FUNCTIONS_USER_MEMO feature requires B1_FEATURE_FUNCTIONS_USER feature to be enabled
+#endif
+
+#if defined(B1_FEATURE_BLTIN_FN_BINDING) && !(defined(B1_FEATURE_FUNCTIONS_STANDARD) || defined(B1_FEATURE_FUNCTIONS_MATH_BASIC) || defined(B1_FEATURE_FUNCTIONS_MATH_EXTRA) || defined(B1_FEATURE_FUNCTIONS_STRING) || defined(B1_FEATURE_FUNCTIONS_ARRAY))
+#error B1_FEATURE_BLTIN_FN_BINDING feature requires at least one built-in functions feature to be enabled
+#endif
+
+#if defined(B1_FEATURE_FUNCTIONS_USER_INLINE) && (!defined(B1_FEATURE_FUNCTIONS_USER) || !defined(B1_FEATURE_RPN_CACHING))
+#error B1_FEATURE_FUNCTIONS_USER_INLINE feature requires B1_FEATURE_FUNCTIONS_USER and B1_FEATURE_RPN_CACHING features to be enabled
+#endif
+
+#if defined(B1_FEATURE_FUNCTIONS_USER) && (B1_MAX_UDEF_FN_TEXT_LEN > B1_T_INDEX_MAX_VALUE)
+#error B1_MAX_UDEF_FN_TEXT_LEN value must not be greater than B1_T_INDEX_MAX_VALUE
+#endif
+
 #if defined(B1_FEATURE_FUNCTIONS_MATH_EXTRA) && !(defined(B1_FEATURE_TYPE_SINGLE) || defined(B1_FEATURE_TYPE_DOUBLE))
 #error math functions are not allowed without floating point type(-s) support
 #endif
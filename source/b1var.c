@@ -109,9 +109,14 @@ B1_T_ERROR b1_var_var2str(const B1_VAR *var, B1_T_CHAR *sbuf)
 		{
 			memcpy(sbuf, data, (*((const B1_T_CHAR *)data) + 1) * B1_T_CHAR_SIZE);
 
-			if(desc != B1_T_MEM_BLOCK_DESC_INVALID && !B1_TYPE_TEST_REF(type))
+			if(desc != B1_T_MEM_BLOCK_DESC_INVALID)
 			{
-				b1_ex_mem_free(desc);
+				b1_ex_mem_release(desc);
+
+				if(!B1_TYPE_TEST_REF(type))
+				{
+					b1_ex_mem_free(desc);
+				}
 			}
 		}
 	}
@@ -422,6 +427,11 @@ B1_T_ERROR b1_var_convert(B1_VAR *var, uint8_t otype)
 			return b1_var_convert_word(var, otype);
 		case B1_TYPE_BYTE:
 			return b1_var_convert_byte(var, otype);
+#endif
+#ifdef B1_FEATURE_FUNCTIONS_ARRAY
+		case B1_TYPE_ARRAY_REF:
+			// array name without subscripts outside of array function call
+			return B1_RES_EWSUBSCNT;
 #endif
 		default:
 			return B1_RES_ETYPMISM;
@@ -436,18 +446,19 @@ B1_T_ERROR b1_var_init_empty(uint8_t type, uint8_t argnum, const B1_T_SUBSCRIPT
 	uint8_t i;
 	B1_T_MEM_BLOCK_DESC mem_desc;
 	B1_T_SUBSCRIPT *data;
+	B1_T_MEMOFFSET size, *strides;
 
 	if(argnum)
 	{
-		argnum *= 2;
-
-		// empty array
-		err = b1_ex_mem_alloc(argnum * ((uint8_t)sizeof(B1_T_SUBSCRIPT)) + ((uint8_t)sizeof(B1_T_MEM_BLOCK_DESC)), &mem_desc, (void **)&data);
+		// empty array: subscript bounds pairs, array data memory block descriptor and dimension strides
+		err = b1_ex_mem_alloc(argnum * (uint8_t)2 * ((uint8_t)sizeof(B1_T_SUBSCRIPT)) + ((uint8_t)sizeof(B1_T_MEM_BLOCK_DESC)) + argnum * ((uint8_t)sizeof(B1_T_MEMOFFSET)), &mem_desc, (void **)&data);
 		if(err != B1_RES_OK)
 		{
 			return err;
 		}
 
+		argnum *= 2;
+
 		for(i = 0; i < argnum; i++)
 		{
 			if(subs_bounds != NULL)
@@ -463,6 +474,16 @@ B1_T_ERROR b1_var_init_empty(uint8_t type, uint8_t argnum, const B1_T_SUBSCRIPT
 		// not allocated at the moment
 		*((B1_T_MEM_BLOCK_DESC *)(data + i)) = B1_T_MEM_BLOCK_DESC_INVALID;
 
+		// precompute strides (the last subscript changes fastest)
+		strides = (B1_T_MEMOFFSET *)(((B1_T_MEM_BLOCK_DESC *)(data + i)) + 1);
+		size = 1;
+		while(i != 0)
+		{
+			i -= 2;
+			*(strides + i / 2) = size;
+			size *= ((B1_T_MEMOFFSET)*(data + i + 1)) - *(data + i) + 1;
+		}
+
 		b1_ex_mem_release(mem_desc);
 
 		(*pvar).type = B1_TYPE_SET(type, 0);
@@ -583,7 +604,7 @@ B1_T_ERROR b1_var_create(B1_T_IDHASH name_hash, uint8_t type, uint8_t argnum, co
 	return err;
 }
 
-static uint8_t b1_var_get_type_size(uint8_t type)
+uint8_t b1_var_get_type_size(uint8_t type)
 {
 	return
 #ifdef B1_FEATURE_TYPE_SINGLE
@@ -601,25 +622,44 @@ static uint8_t b1_var_get_type_size(uint8_t type)
 									(uint8_t)sizeof(B1_T_MEM_BLOCK_DESC);
 }
 
-static B1_T_ERROR b1_var_array_alloc(B1_T_MEM_BLOCK_DESC arrdesc, uint8_t type, uint8_t argnum, B1_T_MEMOFFSET size, B1_T_MEM_BLOCK_DESC *arrdatadesc)
+// allocates memory block for size values of the type and initializes them with empty values
+static B1_T_ERROR b1_var_data_alloc(uint8_t type, B1_T_MEMOFFSET size, B1_T_MEM_BLOCK_DESC *arrdatadesc)
 {
 	B1_T_ERROR err;
 	uint8_t size1;
 	B1_T_MEMOFFSET mem_size;
 	void *data;
 	B1_T_INDEX max1, i;
+#ifdef B1_FEATURE_MEM_ZEROED_ALLOC
+	uint8_t zeroed;
+#endif
 
 	size1 = b1_var_get_type_size(type);
 	max1 = ((B1_T_INDEX)(B1_MAX_STRING_LEN + 1)) / size1;
 	mem_size = size * size1;
 
+#ifdef B1_FEATURE_MEM_ZEROED_ALLOC
+	// zero-filled memory block does not need element by element initialization
+	zeroed = 1;
+#ifndef B1_T_MEM_BLOCK_DESC_INVALID_ZERO_BITS
+	// empty string elements are not represented with zero bits
+	zeroed = (type != B1_TYPE_STRING);
+#endif
+
+	err = zeroed ? b1_ex_mem_alloc_zeroed(mem_size, arrdatadesc) : b1_ex_mem_alloc(mem_size, arrdatadesc, NULL);
+#else
 	err = b1_ex_mem_alloc(mem_size, arrdatadesc, NULL);
+#endif
 	if(err != B1_RES_OK)
 	{
 		return err;
 	}
 
+#ifdef B1_FEATURE_MEM_ZEROED_ALLOC
+	for(size = zeroed ? mem_size : 0, i = 0; size != mem_size; size += size1, i++)
+#else
 	for(size = 0, i = 0; size != mem_size; size += size1, i++)
+#endif
 	{
 		if(i == max1)
 		{
@@ -682,6 +722,20 @@ static B1_T_ERROR b1_var_array_alloc(B1_T_MEM_BLOCK_DESC arrdesc, uint8_t type,
 
 	b1_ex_mem_release(*arrdatadesc);
 
+	return B1_RES_OK;
+}
+
+static B1_T_ERROR b1_var_array_alloc(B1_T_MEM_BLOCK_DESC arrdesc, uint8_t type, uint8_t argnum, B1_T_MEMOFFSET size, B1_T_MEM_BLOCK_DESC *arrdatadesc)
+{
+	B1_T_ERROR err;
+	void *data;
+
+	err = b1_var_data_alloc(type, size, arrdatadesc);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
 	err = b1_ex_mem_access(arrdesc, argnum * (uint8_t)2 * (uint8_t)sizeof(B1_T_SUBSCRIPT), sizeof(B1_T_MEM_BLOCK_DESC), B1_EX_MEM_WRITE, &data);
 	if(err != B1_RES_OK)
 	{
@@ -706,227 +760,850 @@ B1_T_ERROR b1_var_array_get_data_ptr(B1_T_MEM_BLOCK_DESC arr_data_desc, uint8_t
 	return b1_ex_mem_access(arr_data_desc, offset * size1, size1, B1_EX_MEM_READ | B1_EX_MEM_WRITE, data);
 }
 
-// copies value from named variable to temp. stack variable (dst_var must point on a temp. stack variable that can consist of
-// the variable itself and its subscripts), fills B1_VAR_REF structure if src_var_ref parameter is not NULL
-// the function always returns references to string data if src_var is a string variable (B1_TYPE_SET(B1_TYPE_STRING, B1_TYPE_REF_FLAG))
-B1_T_ERROR b1_var_get(B1_NAMED_VAR *src_var, B1_VAR *dst_var, B1_VAR_REF *src_var_ref)
+// calculates array value offset from subscripts, returns array data memory block descriptor
+// (B1_T_MEM_BLOCK_DESC_INVALID for non-allocated array) and array size
+static B1_T_ERROR b1_var_array_get_offset(const B1_NAMED_VAR *var, const B1_VAR *subs_var, B1_T_MEM_BLOCK_DESC *arrdatadesc, B1_T_MEMOFFSET *arrsize, B1_T_MEMOFFSET *offset)
 {
 	B1_T_ERROR err;
-	uint8_t i, argnum, type;
-	B1_T_SUBSCRIPT *arrdata, subs, ubound;
-	B1_T_MEMOFFSET arrsize, offset;
-	B1_T_MEM_BLOCK_DESC arrdatadesc;
-	void *data;
+	uint8_t i, argnum;
+	B1_T_SUBSCRIPT *arrdata, subs;
+	B1_T_MEMOFFSET *strides;
 
-	if(src_var_ref)
+	argnum = B1_IDENT_GET_FLAGS_ARGNUM((*var).id.flags);
+
+	// get array descriptor data
+	err = b1_ex_mem_access((*var).var.value.mem_desc, 0, 0, B1_EX_MEM_READ, (void **)&arrdata);
+	if(err != B1_RES_OK)
 	{
-		(*src_var_ref).var = src_var;
-		(*src_var_ref).val_off = 0;
+		return err;
 	}
 
-	argnum = B1_IDENT_GET_FLAGS_ARGNUM((*src_var).id.flags);
-	type = B1_TYPE_GET((*src_var).var.type);
+	*arrdatadesc = *((B1_T_MEM_BLOCK_DESC *)(arrdata + argnum * (uint8_t)2));
+	strides = (B1_T_MEMOFFSET *)(((B1_T_MEM_BLOCK_DESC *)(arrdata + argnum * (uint8_t)2)) + 1);
 
-	arrsize = 1;
-	offset = 0;
+	// array size in elements
+	*arrsize = (((B1_T_MEMOFFSET)*(arrdata + 1)) - *arrdata + 1) * *strides;
 
-	if(argnum == 0)
+	*offset = 0;
+
+	// check array subscripts
+	for(i = 0; i < argnum; i++, arrdata += 2)
 	{
-		*dst_var = (*src_var).var;
-		if((*dst_var).type == B1_TYPE_SET(B1_TYPE_STRING, 0))
+		if(!B1_TYPE_TEST_INT((*(subs_var + i)).type))
 		{
-			(*dst_var).type = B1_TYPE_SET(B1_TYPE_STRING, B1_TYPE_REF_FLAG);
+			b1_ex_mem_release((*var).var.value.mem_desc);
+			return B1_RES_ETYPMISM;
+		}
+
+		subs = (B1_T_SUBSCRIPT)(*(subs_var + i)).value.i32val;
+
+		// lbound and ubound
+		if(subs < *arrdata || subs > *(arrdata + 1))
+		{
+			b1_ex_mem_release((*var).var.value.mem_desc);
+			return B1_RES_ESUBSRANGE;
 		}
+
+		// zero-based offset
+		*offset += (((B1_T_MEMOFFSET)subs) - *arrdata) * *(strides + i);
+	}
+
+	b1_ex_mem_release((*var).var.value.mem_desc);
+
+	return B1_RES_OK;
+}
+
+#ifdef B1_FEATURE_TYPE_MAP
+// map key converted to string
+static B1_T_CHAR b1_var_map_key[B1_MAX_STRING_LEN + 1];
+
+// copies data from map memory block to buf or from buf to the memory block (write != 0)
+static B1_T_ERROR b1_var_map_copy(B1_T_MEM_BLOCK_DESC desc, B1_T_MEMOFFSET offset, B1_T_INDEX size, void *buf, uint8_t write)
+{
+	B1_T_ERROR err;
+	void *data;
+
+	err = b1_ex_mem_access(desc, offset, size, write ? B1_EX_MEM_WRITE : B1_EX_MEM_READ, &data);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	if(write)
+	{
+		memcpy(data, buf, size);
 	}
 	else
 	{
-		// get array descriptor data
-		err = b1_ex_mem_access((*src_var).var.value.mem_desc, 0, 0, B1_EX_MEM_READ, (void **)&arrdata);
-		if(err != B1_RES_OK)
-		{
-			return err;
-		}
+		memcpy(buf, data, size);
+	}
 
-		// check array subscripts
-		arrdata += argnum * (uint8_t)2;
-		arrdatadesc = *((B1_T_MEM_BLOCK_DESC *)arrdata);
+	b1_ex_mem_release(desc);
 
-		for(i = argnum; i != 0;)
-		{
-			i--;
+	return B1_RES_OK;
+}
 
-			if(!B1_TYPE_TEST_INT((*(dst_var + i)).type))
-			{
-				return B1_RES_ETYPMISM;
-			}
+#define B1_VAR_MAP_COPY_HDR(DESC, HDR, WRITE) b1_var_map_copy((DESC), 0, (B1_T_INDEX)sizeof(B1_VAR_MAP_HDR), (HDR), (WRITE))
+#define B1_VAR_MAP_COPY_KEY(DESC, SLOT, KEY, WRITE) b1_var_map_copy((DESC), (SLOT) * (B1_T_MEMOFFSET)sizeof(B1_VAR_MAP_KEY), (B1_T_INDEX)sizeof(B1_VAR_MAP_KEY), (KEY), (WRITE))
 
-			subs = (B1_T_SUBSCRIPT)(*(dst_var + i)).value.i32val;
+// converts the key to string (numeric keys too, so 1 and "1" keys are the same), saves it to b1_var_map_key buffer
+// and calculates its hash (FNV-1a)
+static B1_T_ERROR b1_var_map_set_key(B1_VAR *key, uint32_t *hash)
+{
+	B1_T_ERROR err;
+	B1_T_INDEX i;
 
-			arrdata--;
-			ubound = *arrdata;
+	err = b1_var_convert(key, B1_TYPE_STRING);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
 
-			// ubound
-			if(subs > ubound)
-			{
-				return B1_RES_ESUBSRANGE;
-			}
+	err = b1_var_var2str(key, b1_var_map_key);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
 
-			arrdata--;
+	*hash = (uint32_t)2166136261UL;
 
-			// lbound
-			if(subs < *arrdata)
-			{
-				return B1_RES_ESUBSRANGE;
-			}
+	for(i = 1; i <= *b1_var_map_key; i++)
+	{
+		*hash ^= (uint32_t)b1_var_map_key[i];
+		*hash *= (uint32_t)16777619UL;
+	}
+
+	return B1_RES_OK;
+}
+
+// looks for b1_var_map_key key in the hash table (linear probing), returns B1_RES_OK and the key slot if the key
+// is found, otherwise B1_RES_EUNKIDENT and the slot the key can be inserted to
+static B1_T_ERROR b1_var_map_find_slot(const B1_VAR_MAP_HDR *hdr, uint32_t hash, B1_T_MEMOFFSET *slot)
+{
+	B1_T_ERROR err;
+	B1_T_MEMOFFSET i, ins;
+	B1_VAR_MAP_KEY key;
+	const B1_T_CHAR *data;
+
+	if((*hdr).size == 0)
+	{
+		return B1_RES_EUNKIDENT;
+	}
+
+	ins = -1;
+	i = (B1_T_MEMOFFSET)(hash & (uint32_t)((*hdr).size - 1));
 
-			// now subs is not a subscript value but zero-based offset
-			offset += (((B1_T_MEMOFFSET)subs) - *arrdata) * arrsize;
-			arrsize *= ((B1_T_MEMOFFSET)ubound) - *arrdata + 1;
+	// the table always has free slots (see b1_var_map_get_slot function)
+	while(1)
+	{
+		err = B1_VAR_MAP_COPY_KEY((*hdr).keys_desc, i, &key, 0);
+		if(err != B1_RES_OK)
+		{
+			return err;
 		}
 
-		// invalid memory block descriptor means non-allocated array
-		if(!src_var_ref && arrdatadesc == B1_T_MEM_BLOCK_DESC_INVALID)
+		if(key.state == B1_VAR_MAP_SLOT_FREE)
 		{
-			// just return initial value even without memory allocation
-			err = b1_var_init_empty(type, 0, NULL, dst_var);
-			if(err != B1_RES_OK)
+			*slot = (ins < 0) ? i : ins;
+			return B1_RES_EUNKIDENT;
+		}
+
+		if(key.state == B1_VAR_MAP_SLOT_DELETED)
+		{
+			if(ins < 0)
 			{
-				return err;
+				ins = i;
 			}
 		}
 		else
+		if(key.hash == hash)
 		{
-			// allocated array
-			// return value according to subscripts
-			if(arrdatadesc == B1_T_MEM_BLOCK_DESC_INVALID)
-			{
-				// allocate memory for array values
-				err = b1_var_array_alloc((*src_var).var.value.mem_desc, type, argnum, arrsize, &arrdatadesc);
-				if(err != B1_RES_OK)
-				{
-					return err;
-				}
-			}
-
-			// return value
-			err = b1_var_array_get_data_ptr(arrdatadesc, type, offset, &data);
+			err = b1_ex_mem_access(key.desc, 0, 0, B1_EX_MEM_READ, (void **)&data);
 			if(err != B1_RES_OK)
 			{
 				return err;
 			}
 
-			// copy array value to output variabe
-#ifdef B1_FEATURE_TYPE_SINGLE
-			if(type == B1_TYPE_SINGLE)
-			{
-				(*dst_var).type = B1_TYPE_SET(B1_TYPE_SINGLE, 0);
-				(*dst_var).value.sval = *((float *)data);
-			}
-			else
-#endif
-#ifdef B1_FEATURE_TYPE_DOUBLE
-			if(type == B1_TYPE_DOUBLE)
-			{
-				(*dst_var).type = B1_TYPE_SET(B1_TYPE_DOUBLE, 0);
-				(*dst_var).value.dval = *((double *)data);
-			}
-			else
-#endif
-			if(type == B1_TYPE_INT)
-			{
-				(*dst_var).type = B1_TYPE_SET(B1_TYPE_INT, 0);
-				(*dst_var).value.i32val = *((int32_t *)data);
-			}
-			else
-#ifdef B1_FEATURE_TYPE_SMALL
-			if(type == B1_TYPE_INT16)
-			{
-				(*dst_var).type = B1_TYPE_SET(B1_TYPE_INT16, 0);
-				(*dst_var).value.i16val = *((int16_t *)data);
-			}
-			else
-			if(type == B1_TYPE_WORD)
-			{
-				(*dst_var).type = B1_TYPE_SET(B1_TYPE_WORD, 0);
-				(*dst_var).value.ui16val = *((uint16_t *)data);
-			}
-			else
-			if(type == B1_TYPE_BYTE)
+			if(*data == *b1_var_map_key && !memcmp(data + 1, b1_var_map_key + 1, *data * B1_T_CHAR_SIZE))
 			{
-				(*dst_var).type = B1_TYPE_SET(B1_TYPE_BYTE, 0);
-				(*dst_var).value.ui8val = *((uint8_t *)data);
-			}
-			else
-#endif
-			{
-				(*dst_var).type = B1_TYPE_SET(B1_TYPE_STRING, B1_TYPE_REF_FLAG);
-				(*dst_var).value.mem_desc = *((B1_T_MEM_BLOCK_DESC *)data);
+				b1_ex_mem_release(key.desc);
+				*slot = i;
+				return B1_RES_OK;
 			}
 
-			// return var reference
-			if(src_var_ref)
-			{
-				(*src_var_ref).val_off = offset;
-			}
+			b1_ex_mem_release(key.desc);
 		}
-	}
 
-	return B1_RES_OK;
+		i = (i + 1) & ((*hdr).size - 1);
+	}
 }
 
-// moves value from temp. stack to a named variable identified by dst_var_ref argument
-B1_T_ERROR b1_var_set(B1_VAR *src_var, const B1_VAR_REF *dst_var_ref)
+// allocates hash table slots memory block
+static B1_T_ERROR b1_var_map_keys_alloc(B1_T_MEMOFFSET size, B1_T_MEM_BLOCK_DESC *keys_desc)
 {
+#ifdef B1_FEATURE_MEM_ZEROED_ALLOC
+	// B1_VAR_MAP_SLOT_FREE state is represented with zero bits
+	return b1_ex_mem_alloc_zeroed(size * (B1_T_MEMOFFSET)sizeof(B1_VAR_MAP_KEY), keys_desc);
+#else
 	B1_T_ERROR err;
-	uint8_t type, argnum, access;
-	B1_T_MEM_BLOCK_DESC arrdesc, dstdesc;
-	void *data;
-
-	argnum = B1_IDENT_GET_FLAGS_ARGNUM((*(*dst_var_ref).var).id.flags);
-	type = B1_TYPE_GET((*(*dst_var_ref).var).var.type);
-	dstdesc = (*(*dst_var_ref).var).var.value.mem_desc;
+	B1_T_MEMOFFSET i;
+	B1_VAR_MAP_KEY key;
 
-	err = b1_var_convert(src_var, type);
+	err = b1_ex_mem_alloc(size * (B1_T_MEMOFFSET)sizeof(B1_VAR_MAP_KEY), keys_desc, NULL);
 	if(err != B1_RES_OK)
 	{
 		return err;
 	}
 
-	if(argnum == 0)
+	memset(&key, 0, sizeof(key));
+	key.state = B1_VAR_MAP_SLOT_FREE;
+
+	for(i = 0; i < size; i++)
 	{
-		if((*(*dst_var_ref).var).var.type == B1_TYPE_SET(B1_TYPE_STRING, 0))
+		err = B1_VAR_MAP_COPY_KEY(*keys_desc, i, &key, 1);
+		if(err != B1_RES_OK)
 		{
-			// free memory occupied by string dst_var_ref points to
-			b1_ex_mem_free(dstdesc);
+			b1_ex_mem_free(*keys_desc);
+			return err;
 		}
+	}
 
-		(*(*dst_var_ref).var).var = *src_var;
+	return B1_RES_OK;
+#endif
+}
+
+// moves keys and values to the new hash table of the specified size (deleted keys are dropped)
+static B1_T_ERROR b1_var_map_resize(B1_VAR_MAP_HDR *hdr, uint8_t type, B1_T_MEMOFFSET size)
+{
+	B1_T_ERROR err;
+	uint8_t size1;
+	B1_T_MEMOFFSET i, j;
+	B1_T_MEM_BLOCK_DESC keys_desc, vals_desc;
+	B1_VAR_MAP_KEY key, key1;
+	B1_VAL val;
+
+	if(size > B1_T_MEMOFFSET_MAX_VALUE / (B1_T_MEMOFFSET)sizeof(B1_VAR_MAP_KEY))
+	{
+		return B1_RES_ENOMEM;
 	}
-	else
+
+	err = b1_var_data_alloc(type, size, &vals_desc);
+	if(err != B1_RES_OK)
 	{
-		// array value
-		err = b1_ex_mem_access(dstdesc, argnum * (uint8_t)2 * (uint8_t)sizeof(B1_T_SUBSCRIPT), sizeof(B1_T_MEM_BLOCK_DESC), B1_EX_MEM_READ, &data);
+		return err;
+	}
+
+	err = b1_var_map_keys_alloc(size, &keys_desc);
+	if(err != B1_RES_OK)
+	{
+		b1_ex_mem_free(vals_desc);
+		return err;
+	}
+
+	size1 = b1_var_get_type_size(type);
+
+	for(i = 0; i < (*hdr).size; i++)
+	{
+		err = B1_VAR_MAP_COPY_KEY((*hdr).keys_desc, i, &key, 0);
 		if(err != B1_RES_OK)
 		{
 			return err;
 		}
 
-		arrdesc = *((B1_T_MEM_BLOCK_DESC *)data);
+		if(key.state != B1_VAR_MAP_SLOT_USED)
+		{
+			continue;
+		}
 
-		err = b1_var_array_get_data_ptr(arrdesc, type, (*dst_var_ref).val_off, &data);
+		// the new table has no deleted keys and no equal keys so the first free slot is taken
+		for(j = (B1_T_MEMOFFSET)(key.hash & (uint32_t)(size - 1)); ; j = (j + 1) & (size - 1))
+		{
+			err = B1_VAR_MAP_COPY_KEY(keys_desc, j, &key1, 0);
+			if(err != B1_RES_OK)
+			{
+				return err;
+			}
+
+			if(key1.state == B1_VAR_MAP_SLOT_FREE)
+			{
+				break;
+			}
+		}
+
+		err = B1_VAR_MAP_COPY_KEY(keys_desc, j, &key, 1);
 		if(err != B1_RES_OK)
 		{
 			return err;
 		}
 
-		access = 0;
-
-#ifdef B1_FEATURE_TYPE_SINGLE
-		if(type == B1_TYPE_SINGLE)
+		// move the value (strings are moved by their memory block descriptors)
+		err = b1_var_map_copy((*hdr).vals_desc, i * size1, size1, &val, 0);
+		if(err != B1_RES_OK)
 		{
-			*((float *)data) = (*src_var).value.sval;
+			return err;
 		}
-		else
+
+		err = b1_var_map_copy(vals_desc, j * size1, size1, &val, 1);
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
+	}
+
+	if((*hdr).size != 0)
+	{
+		b1_ex_mem_free((*hdr).keys_desc);
+		b1_ex_mem_free((*hdr).vals_desc);
+	}
+
+	(*hdr).keys_desc = keys_desc;
+	(*hdr).vals_desc = vals_desc;
+	(*hdr).size = size;
+	(*hdr).used = (*hdr).count;
+	(*hdr).iter_num = 0;
+
+	return B1_RES_OK;
+}
+
+// returns values memory block descriptor and the value offset (hash table slot) for the key, if the key is not found
+// and add is zero the values memory block descriptor is set to B1_T_MEM_BLOCK_DESC_INVALID, otherwise the key is added
+static B1_T_ERROR b1_var_map_get_slot(const B1_NAMED_VAR *var, B1_VAR *key, uint8_t add, B1_T_MEM_BLOCK_DESC *vals_desc, B1_T_MEMOFFSET *slot)
+{
+	B1_T_ERROR err;
+	B1_VAR_MAP_HDR hdr;
+	B1_VAR_MAP_KEY key1;
+	B1_T_MEMOFFSET size;
+	uint32_t hash;
+
+	*vals_desc = B1_T_MEM_BLOCK_DESC_INVALID;
+
+	err = b1_var_map_set_key(key, &hash);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	err = B1_VAR_MAP_COPY_HDR((*var).var.value.mem_desc, &hdr, 0);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	err = b1_var_map_find_slot(&hdr, hash, slot);
+	if(err == B1_RES_OK)
+	{
+		*vals_desc = hdr.vals_desc;
+		return B1_RES_OK;
+	}
+
+	if(err != B1_RES_EUNKIDENT || !add)
+	{
+		return (err == B1_RES_EUNKIDENT) ? B1_RES_OK : err;
+	}
+
+	// keep the hash table load factor (including deleted keys) not greater than 3/4
+	if((hdr.used + 1) * 4 > hdr.size * 3)
+	{
+		// the new table size is at least twice the number of keys
+		for(size = B1_MAP_INIT_SIZE; size < (hdr.count + 1) * 2; size *= 2);
+
+		err = b1_var_map_resize(&hdr, B1_TYPE_GET((*var).var.type), size);
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
+
+		err = b1_var_map_find_slot(&hdr, hash, slot);
+		if(err != B1_RES_EUNKIDENT)
+		{
+			return err;
+		}
+	}
+
+	err = B1_VAR_MAP_COPY_KEY(hdr.keys_desc, *slot, &key1, 0);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	if(key1.state == B1_VAR_MAP_SLOT_FREE)
+	{
+		hdr.used++;
+	}
+
+	err = b1_var_put_str_to_mem(b1_var_map_key, &key1.desc);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	key1.hash = hash;
+	key1.state = B1_VAR_MAP_SLOT_USED;
+
+	err = B1_VAR_MAP_COPY_KEY(hdr.keys_desc, *slot, &key1, 1);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	hdr.count++;
+	hdr.iter_num = 0;
+
+	err = B1_VAR_MAP_COPY_HDR((*var).var.value.mem_desc, &hdr, 1);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	*vals_desc = hdr.vals_desc;
+
+	return B1_RES_OK;
+}
+
+// creates map variable with values of the specified type
+B1_T_ERROR b1_var_map_create(B1_T_IDHASH name_hash, uint8_t type, B1_NAMED_VAR **var)
+{
+	B1_T_ERROR err;
+	B1_NAMED_VAR *newvar;
+	B1_VAR_MAP_HDR hdr;
+	B1_T_MEM_BLOCK_DESC desc;
+
+	// create scalar variable first (new map variable name is checked in the same way)
+	err = b1_var_create(name_hash, type, 0, NULL, &newvar);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	err = b1_ex_mem_alloc(sizeof(B1_VAR_MAP_HDR), &desc, NULL);
+	if(err != B1_RES_OK)
+	{
+		b1_ex_var_free(name_hash);
+		return err;
+	}
+
+	// empty map: no hash table
+	memset(&hdr, 0, sizeof(hdr));
+	hdr.vals_desc = B1_T_MEM_BLOCK_DESC_INVALID;
+	hdr.keys_desc = B1_T_MEM_BLOCK_DESC_INVALID;
+
+	err = B1_VAR_MAP_COPY_HDR(desc, &hdr, 1);
+	if(err != B1_RES_OK)
+	{
+		b1_ex_mem_free(desc);
+		b1_ex_var_free(name_hash);
+		return err;
+	}
+
+	(*newvar).id.flags = B1_IDENT_FLAGS_SET_VAR(1) | B1_IDENT_FLAGS_VAR_MAP;
+	(*newvar).var.type = B1_TYPE_SET(type, 0);
+	(*newvar).var.value.mem_desc = desc;
+
+	if(var != NULL)
+	{
+		*var = newvar;
+	}
+
+	return B1_RES_OK;
+}
+
+// looks for the key in the map, returns B1_RES_OK if the key is found (and deletes it if del is not zero)
+// or B1_RES_EUNKIDENT if it is not found
+B1_T_ERROR b1_var_map_find(const B1_NAMED_VAR *var, B1_VAR *key, uint8_t del)
+{
+	B1_T_ERROR err;
+	uint8_t type;
+	B1_VAR_MAP_HDR hdr;
+	B1_VAR_MAP_KEY key1;
+	B1_T_MEMOFFSET slot;
+	uint32_t hash;
+	void *data;
+
+	err = b1_var_map_set_key(key, &hash);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	err = B1_VAR_MAP_COPY_HDR((*var).var.value.mem_desc, &hdr, 0);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	err = b1_var_map_find_slot(&hdr, hash, &slot);
+	if(err != B1_RES_OK || !del)
+	{
+		return err;
+	}
+
+	// free the key string and mark the slot as deleted (it stays non-free not to break probe sequences)
+	err = B1_VAR_MAP_COPY_KEY(hdr.keys_desc, slot, &key1, 0);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	b1_ex_mem_free(key1.desc);
+	key1.state = B1_VAR_MAP_SLOT_DELETED;
+
+	err = B1_VAR_MAP_COPY_KEY(hdr.keys_desc, slot, &key1, 1);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	// reset the value (new keys get empty values)
+	type = B1_TYPE_GET((*var).var.type);
+
+	err = b1_var_array_get_data_ptr(hdr.vals_desc, type, slot, &data);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	if(type == B1_TYPE_STRING)
+	{
+		if(*((B1_T_MEM_BLOCK_DESC *)data) != B1_T_MEM_BLOCK_DESC_INVALID)
+		{
+			b1_ex_mem_free(*((B1_T_MEM_BLOCK_DESC *)data));
+		}
+
+		*((B1_T_MEM_BLOCK_DESC *)data) = B1_T_MEM_BLOCK_DESC_INVALID;
+	}
+	else
+	{
+		memset(data, 0, b1_var_get_type_size(type));
+	}
+
+	b1_ex_mem_release(hdr.vals_desc);
+
+	hdr.count--;
+	hdr.iter_num = 0;
+
+	return B1_VAR_MAP_COPY_HDR((*var).var.value.mem_desc, &hdr, 1);
+}
+
+B1_T_ERROR b1_var_map_get_count(const B1_NAMED_VAR *var, B1_T_MEMOFFSET *count)
+{
+	B1_T_ERROR err;
+	B1_VAR_MAP_HDR hdr;
+
+	err = B1_VAR_MAP_COPY_HDR((*var).var.value.mem_desc, &hdr, 0);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	*count = hdr.count;
+
+	return B1_RES_OK;
+}
+
+// copies the key with ordinal number num (starting from 1, keys are ordered by hash table slots) to sbuf,
+// the search starts from the previously returned key so sequential enumeration does not scan the table repeatedly
+B1_T_ERROR b1_var_map_get_key(const B1_NAMED_VAR *var, B1_T_MEMOFFSET num, B1_T_CHAR *sbuf)
+{
+	B1_T_ERROR err;
+	B1_VAR_MAP_HDR hdr;
+	B1_VAR_MAP_KEY key;
+	const B1_T_CHAR *data;
+
+	err = B1_VAR_MAP_COPY_HDR((*var).var.value.mem_desc, &hdr, 0);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	if(num < 1 || num > hdr.count)
+	{
+		return B1_RES_ESUBSRANGE;
+	}
+
+	if(hdr.iter_num == 0 || num < hdr.iter_num)
+	{
+		hdr.iter_num = 0;
+		hdr.iter_slot = -1;
+	}
+
+	while(hdr.iter_num != num)
+	{
+		hdr.iter_slot++;
+
+		err = B1_VAR_MAP_COPY_KEY(hdr.keys_desc, hdr.iter_slot, &key, 0);
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
+
+		if(key.state == B1_VAR_MAP_SLOT_USED)
+		{
+			hdr.iter_num++;
+		}
+	}
+
+	err = B1_VAR_MAP_COPY_KEY(hdr.keys_desc, hdr.iter_slot, &key, 0);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	err = b1_ex_mem_access(key.desc, 0, 0, B1_EX_MEM_READ, (void **)&data);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	memcpy(sbuf, data, (*data + 1) * B1_T_CHAR_SIZE);
+
+	b1_ex_mem_release(key.desc);
+
+	return B1_VAR_MAP_COPY_HDR((*var).var.value.mem_desc, &hdr, 1);
+}
+
+// frees memory used by map keys, values and the map descriptor
+B1_T_ERROR b1_var_map_free(const B1_NAMED_VAR *var)
+{
+	B1_T_ERROR err;
+	B1_VAR_MAP_HDR hdr;
+	B1_VAR_MAP_KEY key;
+	B1_T_MEMOFFSET i;
+	B1_T_MEM_BLOCK_DESC desc;
+
+	err = B1_VAR_MAP_COPY_HDR((*var).var.value.mem_desc, &hdr, 0);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	for(i = 0; i < hdr.size; i++)
+	{
+		err = B1_VAR_MAP_COPY_KEY(hdr.keys_desc, i, &key, 0);
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
+
+		if(key.state != B1_VAR_MAP_SLOT_USED)
+		{
+			continue;
+		}
+
+		b1_ex_mem_free(key.desc);
+
+		if(B1_TYPE_TEST_STRING((*var).var.type))
+		{
+			err = b1_var_map_copy(hdr.vals_desc, i * (B1_T_MEMOFFSET)sizeof(B1_T_MEM_BLOCK_DESC), sizeof(B1_T_MEM_BLOCK_DESC), &desc, 0);
+			if(err != B1_RES_OK)
+			{
+				return err;
+			}
+
+			if(desc != B1_T_MEM_BLOCK_DESC_INVALID)
+			{
+				b1_ex_mem_free(desc);
+			}
+		}
+	}
+
+	if(hdr.size != 0)
+	{
+		b1_ex_mem_free(hdr.keys_desc);
+		b1_ex_mem_free(hdr.vals_desc);
+	}
+
+	b1_ex_mem_free((*var).var.value.mem_desc);
+
+	return B1_RES_OK;
+}
+#endif
+
+// copies value from named variable to temp. stack variable (dst_var must point on a temp. stack variable that can consist of
+// the variable itself and its subscripts), fills B1_VAR_REF structure if src_var_ref parameter is not NULL
+// the function always returns references to string data if src_var is a string variable (B1_TYPE_SET(B1_TYPE_STRING, B1_TYPE_REF_FLAG))
+B1_T_ERROR b1_var_get(B1_NAMED_VAR *src_var, B1_VAR *dst_var, B1_VAR_REF *src_var_ref)
+{
+	B1_T_ERROR err;
+	uint8_t argnum, type;
+	B1_T_MEMOFFSET arrsize, offset;
+	B1_T_MEM_BLOCK_DESC arrdatadesc;
+	void *data;
+
+	if(src_var_ref)
+	{
+		(*src_var_ref).var = src_var;
+		(*src_var_ref).val_off = 0;
+	}
+
+	argnum = B1_IDENT_GET_FLAGS_ARGNUM((*src_var).id.flags);
+	type = B1_TYPE_GET((*src_var).var.type);
+
+	if(argnum == 0)
+	{
+		*dst_var = (*src_var).var;
+		if((*dst_var).type == B1_TYPE_SET(B1_TYPE_STRING, 0))
+		{
+			(*dst_var).type = B1_TYPE_SET(B1_TYPE_STRING, B1_TYPE_REF_FLAG);
+		}
+	}
+	else
+	{
+#ifdef B1_FEATURE_TYPE_MAP
+		// map values are stored like array values: the only difference is how the value offset is calculated
+		// (missing key is added only if the value reference is requested, otherwise empty value is returned)
+		// map value memory is never allocated here so array size is not used for maps
+		arrsize = 0;
+		err =	B1_IDENT_TEST_FLAGS_VAR_MAP((*src_var).id.flags) ?
+				b1_var_map_get_slot(src_var, dst_var, src_var_ref != NULL, &arrdatadesc, &offset) :
+				b1_var_array_get_offset(src_var, dst_var, &arrdatadesc, &arrsize, &offset);
+#else
+		err = b1_var_array_get_offset(src_var, dst_var, &arrdatadesc, &arrsize, &offset);
+#endif
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
+
+		// invalid memory block descriptor means non-allocated array
+		if(!src_var_ref && arrdatadesc == B1_T_MEM_BLOCK_DESC_INVALID)
+		{
+			// just return initial value even without memory allocation
+			err = b1_var_init_empty(type, 0, NULL, dst_var);
+			if(err != B1_RES_OK)
+			{
+				return err;
+			}
+		}
+		else
+		{
+			// allocated array
+			// return value according to subscripts
+			if(arrdatadesc == B1_T_MEM_BLOCK_DESC_INVALID)
+			{
+				// allocate memory for array values
+				err = b1_var_array_alloc((*src_var).var.value.mem_desc, type, argnum, arrsize, &arrdatadesc);
+				if(err != B1_RES_OK)
+				{
+					return err;
+				}
+			}
+
+			// return value
+			err = b1_var_array_get_data_ptr(arrdatadesc, type, offset, &data);
+			if(err != B1_RES_OK)
+			{
+				return err;
+			}
+
+			// copy array value to output variabe
+#ifdef B1_FEATURE_TYPE_SINGLE
+			if(type == B1_TYPE_SINGLE)
+			{
+				(*dst_var).type = B1_TYPE_SET(B1_TYPE_SINGLE, 0);
+				(*dst_var).value.sval = *((float *)data);
+			}
+			else
+#endif
+#ifdef B1_FEATURE_TYPE_DOUBLE
+			if(type == B1_TYPE_DOUBLE)
+			{
+				(*dst_var).type = B1_TYPE_SET(B1_TYPE_DOUBLE, 0);
+				(*dst_var).value.dval = *((double *)data);
+			}
+			else
+#endif
+			if(type == B1_TYPE_INT)
+			{
+				(*dst_var).type = B1_TYPE_SET(B1_TYPE_INT, 0);
+				(*dst_var).value.i32val = *((int32_t *)data);
+			}
+			else
+#ifdef B1_FEATURE_TYPE_SMALL
+			if(type == B1_TYPE_INT16)
+			{
+				(*dst_var).type = B1_TYPE_SET(B1_TYPE_INT16, 0);
+				(*dst_var).value.i16val = *((int16_t *)data);
+			}
+			else
+			if(type == B1_TYPE_WORD)
+			{
+				(*dst_var).type = B1_TYPE_SET(B1_TYPE_WORD, 0);
+				(*dst_var).value.ui16val = *((uint16_t *)data);
+			}
+			else
+			if(type == B1_TYPE_BYTE)
+			{
+				(*dst_var).type = B1_TYPE_SET(B1_TYPE_BYTE, 0);
+				(*dst_var).value.ui8val = *((uint8_t *)data);
+			}
+			else
+#endif
+			{
+				(*dst_var).type = B1_TYPE_SET(B1_TYPE_STRING, B1_TYPE_REF_FLAG);
+				(*dst_var).value.mem_desc = *((B1_T_MEM_BLOCK_DESC *)data);
+			}
+
+			b1_ex_mem_release(arrdatadesc);
+
+			// return var reference
+			if(src_var_ref)
+			{
+				(*src_var_ref).val_off = offset;
+				(*src_var_ref).arr_data_desc = arrdatadesc;
+			}
+		}
+	}
+
+	return B1_RES_OK;
+}
+
+// moves value from temp. stack to a named variable identified by dst_var_ref argument
+B1_T_ERROR b1_var_set(B1_VAR *src_var, const B1_VAR_REF *dst_var_ref)
+{
+	B1_T_ERROR err;
+	uint8_t type, argnum, access;
+	B1_T_MEM_BLOCK_DESC arrdesc, dstdesc;
+	void *data;
+
+	argnum = B1_IDENT_GET_FLAGS_ARGNUM((*(*dst_var_ref).var).id.flags);
+	type = B1_TYPE_GET((*(*dst_var_ref).var).var.type);
+	dstdesc = (*(*dst_var_ref).var).var.value.mem_desc;
+
+	err = b1_var_convert(src_var, type);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	if(argnum == 0)
+	{
+		if((*(*dst_var_ref).var).var.type == B1_TYPE_SET(B1_TYPE_STRING, 0))
+		{
+			// free memory occupied by string dst_var_ref points to
+			b1_ex_mem_free(dstdesc);
+		}
+
+		(*(*dst_var_ref).var).var = *src_var;
+	}
+	else
+	{
+		// array value (the reference already contains array data memory block descriptor)
+		arrdesc = (*dst_var_ref).arr_data_desc;
+
+		err = b1_var_array_get_data_ptr(arrdesc, type, (*dst_var_ref).val_off, &data);
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
+
+		access = 0;
+
+#ifdef B1_FEATURE_TYPE_SINGLE
+		if(type == B1_TYPE_SINGLE)
+		{
+			*((float *)data) = (*src_var).value.sval;
+		}
+		else
 #endif
 #ifdef B1_FEATURE_TYPE_DOUBLE
 		if(type == B1_TYPE_DOUBLE)
@@ -966,6 +1643,8 @@ B1_T_ERROR b1_var_set(B1_VAR *src_var, const B1_VAR_REF *dst_var_ref)
 
 			if(B1_TYPE_TEST_STRING_IMM((*src_var).type))
 			{
+				// the array data block can be moved while the string memory is allocated
+				b1_ex_mem_release(arrdesc);
 				access = 1;
 
 				data = (*src_var).value.istr;
@@ -998,3 +1677,326 @@ B1_T_ERROR b1_var_set(B1_VAR *src_var, const B1_VAR_REF *dst_var_ref)
 
 	return B1_RES_OK;
 }
+
+#ifdef B1_VAR_ARRAY_BULK_ACCESS
+// fills B1_VAR_ARRAY_INFO structure, allocates array data memory block if alloc is not zero
+// (otherwise data_desc member of non-allocated array is set to B1_T_MEM_BLOCK_DESC_INVALID value)
+B1_T_ERROR b1_var_array_get_info(const B1_NAMED_VAR *var, uint8_t alloc, B1_VAR_ARRAY_INFO *info)
+{
+	B1_T_ERROR err;
+	uint8_t i;
+	const B1_T_SUBSCRIPT *arrdata;
+
+	(*info).dimnum = B1_IDENT_GET_FLAGS_ARGNUM((*var).id.flags);
+	if((*info).dimnum == 0)
+	{
+		return B1_RES_EWSUBSCNT;
+	}
+
+#ifdef B1_FEATURE_TYPE_MAP
+	// maps cannot be processed as arrays
+	if(B1_IDENT_TEST_FLAGS_VAR_MAP((*var).id.flags))
+	{
+		return B1_RES_ETYPMISM;
+	}
+#endif
+
+	(*info).type = B1_TYPE_GET((*var).var.type);
+
+	err = b1_ex_mem_access((*var).var.value.mem_desc, 0, 0, B1_EX_MEM_READ, (void **)&arrdata);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	(*info).size = 1;
+
+	for(i = 0; i < (*info).dimnum; i++, arrdata += 2)
+	{
+		(*info).lbounds[i] = *arrdata;
+		(*info).dims[i] = ((B1_T_MEMOFFSET)*(arrdata + 1)) - *arrdata + 1;
+		(*info).size *= (*info).dims[i];
+	}
+
+	(*info).data_desc = *((const B1_T_MEM_BLOCK_DESC *)arrdata);
+
+	b1_ex_mem_release((*var).var.value.mem_desc);
+
+	if(alloc && (*info).data_desc == B1_T_MEM_BLOCK_DESC_INVALID)
+	{
+		return b1_var_array_alloc((*var).var.value.mem_desc, (*info).type, (*info).dimnum, (*info).size, &(*info).data_desc);
+	}
+
+	return B1_RES_OK;
+}
+
+static int32_t b1_var_array_val_to_i32(B1_T_ARRAY_VAL val)
+{
+	// convert floating point value to integer with rounding (the same way b1_var_convert function does)
+	return (int32_t)(val + ((val < (B1_T_ARRAY_VAL)0) ? (B1_T_ARRAY_VAL)-0.5 : (B1_T_ARRAY_VAL)0.5));
+}
+
+// copies count numeric array elements starting from offset element to buf (or from buf to array if write is not zero)
+// converting them to or from B1_T_ARRAY_VAL type, elements of non-allocated array are read as zeros.
+// the array data is accessed by parts not exceeding B1_MAX_STRING_LEN + 1 bytes
+B1_T_ERROR b1_var_array_copy(const B1_VAR_ARRAY_INFO *info, B1_T_MEMOFFSET offset, B1_T_MEMOFFSET count, B1_T_ARRAY_VAL *buf, uint8_t write)
+{
+	B1_T_ERROR err;
+	uint8_t type, size1;
+	B1_T_INDEX max1, n, i;
+	void *data;
+
+	type = (*info).type;
+
+	if(type == B1_TYPE_STRING)
+	{
+		return B1_RES_ETYPMISM;
+	}
+
+	if((*info).data_desc == B1_T_MEM_BLOCK_DESC_INVALID)
+	{
+		if(write)
+		{
+			return B1_RES_EINVMEMBLK;
+		}
+
+		for(; count != 0; count--)
+		{
+			*buf++ = (B1_T_ARRAY_VAL)0;
+		}
+
+		return B1_RES_OK;
+	}
+
+	size1 = b1_var_get_type_size(type);
+	max1 = ((B1_T_INDEX)(B1_MAX_STRING_LEN + 1)) / size1;
+
+	while(count != 0)
+	{
+		n = (count > (B1_T_MEMOFFSET)max1) ? max1 : (B1_T_INDEX)count;
+
+		err = b1_ex_mem_access((*info).data_desc, offset * size1, n * size1, write ? B1_EX_MEM_WRITE : B1_EX_MEM_READ, &data);
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
+
+#ifdef B1_FEATURE_TYPE_SINGLE
+		if(type == B1_TYPE_SINGLE)
+		{
+			if(write)
+			{
+				for(i = 0; i < n; i++) *(((float *)data) + i) = (float)*(buf + i);
+			}
+			else
+			{
+				for(i = 0; i < n; i++) *(buf + i) = (B1_T_ARRAY_VAL)*(((float *)data) + i);
+			}
+		}
+		else
+#endif
+#ifdef B1_FEATURE_TYPE_DOUBLE
+		if(type == B1_TYPE_DOUBLE)
+		{
+			if(write)
+			{
+				for(i = 0; i < n; i++) *(((double *)data) + i) = (double)*(buf + i);
+			}
+			else
+			{
+				for(i = 0; i < n; i++) *(buf + i) = (B1_T_ARRAY_VAL)*(((double *)data) + i);
+			}
+		}
+		else
+#endif
+#ifdef B1_FEATURE_TYPE_SMALL
+		if(type == B1_TYPE_INT16)
+		{
+			if(write)
+			{
+				for(i = 0; i < n; i++) *(((int16_t *)data) + i) = (int16_t)b1_var_array_val_to_i32(*(buf + i));
+			}
+			else
+			{
+				for(i = 0; i < n; i++) *(buf + i) = (B1_T_ARRAY_VAL)*(((int16_t *)data) + i);
+			}
+		}
+		else
+		if(type == B1_TYPE_WORD)
+		{
+			if(write)
+			{
+				for(i = 0; i < n; i++) *(((uint16_t *)data) + i) = (uint16_t)b1_var_array_val_to_i32(*(buf + i));
+			}
+			else
+			{
+				for(i = 0; i < n; i++) *(buf + i) = (B1_T_ARRAY_VAL)*(((uint16_t *)data) + i);
+			}
+		}
+		else
+		if(type == B1_TYPE_BYTE)
+		{
+			if(write)
+			{
+				for(i = 0; i < n; i++) *(((uint8_t *)data) + i) = (uint8_t)b1_var_array_val_to_i32(*(buf + i));
+			}
+			else
+			{
+				for(i = 0; i < n; i++) *(buf + i) = (B1_T_ARRAY_VAL)*(((uint8_t *)data) + i);
+			}
+		}
+		else
+#endif
+		{
+			if(write)
+			{
+				for(i = 0; i < n; i++) *(((int32_t *)data) + i) = b1_var_array_val_to_i32(*(buf + i));
+			}
+			else
+			{
+				for(i = 0; i < n; i++) *(buf + i) = (B1_T_ARRAY_VAL)*(((int32_t *)data) + i);
+			}
+		}
+
+		b1_ex_mem_release((*info).data_desc);
+
+		buf += n;
+		offset += n;
+		count -= n;
+	}
+
+	return B1_RES_OK;
+}
+
+#ifdef B1_FEATURE_STMT_SORT
+// swaps two elements of an array (string elements are swapped by their memory block descriptors),
+// elements of non-allocated array are all equal so there is nothing to swap
+B1_T_ERROR b1_var_array_swap(const B1_VAR_ARRAY_INFO *info, B1_T_MEMOFFSET i, B1_T_MEMOFFSET j)
+{
+	B1_T_ERROR err;
+	uint8_t size1;
+	B1_VAL val1, val2;
+	void *data;
+
+	if(i == j || (*info).data_desc == B1_T_MEM_BLOCK_DESC_INVALID)
+	{
+		return B1_RES_OK;
+	}
+
+	size1 = b1_var_get_type_size((*info).type);
+
+	err = b1_ex_mem_access((*info).data_desc, i * size1, size1, B1_EX_MEM_READ, &data);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+	memcpy(&val1, data, size1);
+	b1_ex_mem_release((*info).data_desc);
+
+	err = b1_ex_mem_access((*info).data_desc, j * size1, size1, B1_EX_MEM_READ | B1_EX_MEM_WRITE, &data);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+	memcpy(&val2, data, size1);
+	memcpy(data, &val1, size1);
+	b1_ex_mem_release((*info).data_desc);
+
+	err = b1_ex_mem_access((*info).data_desc, i * size1, size1, B1_EX_MEM_WRITE, &data);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+	memcpy(data, &val2, size1);
+	b1_ex_mem_release((*info).data_desc);
+
+	return B1_RES_OK;
+}
+
+// copies string array element to sbuf
+B1_T_ERROR b1_var_array_get_str(const B1_VAR_ARRAY_INFO *info, B1_T_MEMOFFSET i, B1_T_CHAR *sbuf)
+{
+	B1_T_ERROR err;
+	B1_VAR var;
+	void *data;
+
+	if((*info).data_desc == B1_T_MEM_BLOCK_DESC_INVALID)
+	{
+		sbuf[0] = 0;
+		return B1_RES_OK;
+	}
+
+	err = b1_ex_mem_access((*info).data_desc, i * (B1_T_MEMOFFSET)sizeof(B1_T_MEM_BLOCK_DESC), sizeof(B1_T_MEM_BLOCK_DESC), B1_EX_MEM_READ, &data);
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	var.type = B1_TYPE_SET(B1_TYPE_STRING, B1_TYPE_REF_FLAG);
+	var.value.mem_desc = *((B1_T_MEM_BLOCK_DESC *)data);
+
+	b1_ex_mem_release((*info).data_desc);
+
+	return b1_var_var2str(&var, sbuf);
+}
+#endif
+#endif
+
+#ifdef B1_FEATURE_VAR_SLOTS
+// identifiers collected by b1_int_prerun function (sorted by hash) and their slot numbers
+static B1_VAR_SLOT b1_var_slot_ids[B1_MAX_VAR_SLOTS_NUM];
+static uint8_t b1_var_slot_cnt = 0;
+
+// variables bound to slots (NULL if the variable is not created yet)
+B1_NAMED_VAR *b1_var_slots[B1_MAX_VAR_SLOTS_NUM];
+
+void b1_var_slot_init()
+{
+	b1_var_slot_cnt = 0;
+	memset(b1_var_slots, 0, sizeof(b1_var_slots));
+}
+
+// silently ignores identifiers not fitting the table: RPN records refer to them by hash then
+void b1_var_slot_add(B1_T_IDHASH name_hash)
+{
+	uint8_t i;
+
+	if(b1_var_slot_cnt == B1_MAX_VAR_SLOTS_NUM)
+	{
+		return;
+	}
+
+	for(i = b1_var_slot_cnt; i > 0 && b1_var_slot_ids[i - 1].hash >= name_hash; i--)
+	{
+		if(b1_var_slot_ids[i - 1].hash == name_hash)
+		{
+			return;
+		}
+	}
+
+	memmove(b1_var_slot_ids + i + 1, b1_var_slot_ids + i, (b1_var_slot_cnt - i) * sizeof(B1_VAR_SLOT));
+	b1_var_slot_ids[i].hash = name_hash;
+	b1_var_slot_ids[i].slot = b1_var_slot_cnt++;
+}
+
+uint8_t b1_var_slot_get(B1_T_IDHASH name_hash)
+{
+	B1_VAR_SLOT *slot;
+
+	slot = (B1_VAR_SLOT *)bsearch(&name_hash, b1_var_slot_ids, b1_var_slot_cnt, sizeof(B1_VAR_SLOT), b1_id_cmp_hashes);
+
+	return slot == NULL ? B1_VAR_SLOT_NONE : (*slot).slot;
+}
+
+// unbinds the variable from its slot, must be called before the variable is freed
+void b1_var_slot_free(B1_T_IDHASH name_hash)
+{
+	uint8_t slot;
+
+	slot = b1_var_slot_get(name_hash);
+	if(slot != B1_VAR_SLOT_NONE)
+	{
+		b1_var_slots[slot] = NULL;
+	}
+}
+#endif
@@ -42,6 +42,10 @@ typedef union
 	uint16_t ui16val;
 	uint8_t ui8val;
 #endif
+#ifdef B1_FEATURE_FUNCTIONS_ARRAY
+	// array name hash (B1_TYPE_ARRAY_REF value)
+	B1_T_IDHASH id_hash;
+#endif
 } B1_VAL;
 
 typedef struct
@@ -60,16 +64,115 @@ typedef struct
 {
 	B1_NAMED_VAR *var;
 	B1_T_MEMOFFSET val_off;
+	// array data memory block descriptor (set for array elements only)
+	B1_T_MEM_BLOCK_DESC arr_data_desc;
 } B1_VAR_REF;
 
+#if defined(B1_FEATURE_STMT_MAT) || defined(B1_FEATURE_FUNCTIONS_ARRAY)
+// whole-array element access functions (b1_var_array_get_info, b1_var_array_copy)
+#define B1_VAR_ARRAY_BULK_ACCESS
+#endif
+
+#ifdef B1_VAR_ARRAY_BULK_ACCESS
+// numeric array elements are converted to the type by whole-array operations
+#ifdef B1_FEATURE_TYPE_DOUBLE
+typedef double B1_T_ARRAY_VAL;
+#else
+typedef float B1_T_ARRAY_VAL;
+#endif
+
+// array shape and data memory block descriptor
+typedef struct
+{
+	uint8_t type;
+	uint8_t dimnum;
+	B1_T_SUBSCRIPT lbounds[B1_MAX_VAR_DIM_NUM];
+	// dimension sizes (in elements)
+	B1_T_MEMOFFSET dims[B1_MAX_VAR_DIM_NUM];
+	// total element count
+	B1_T_MEMOFFSET size;
+	B1_T_MEM_BLOCK_DESC data_desc;
+} B1_VAR_ARRAY_INFO;
+#endif
+
+#ifdef B1_FEATURE_TYPE_MAP
+// map hash table slot states
+#define B1_VAR_MAP_SLOT_FREE ((uint8_t)0x0)
+#define B1_VAR_MAP_SLOT_USED ((uint8_t)0x1)
+#define B1_VAR_MAP_SLOT_DELETED ((uint8_t)0x2)
+
+// map descriptor (map variable value is the descriptor memory block)
+typedef struct
+{
+	// values (organized the same way as array data) and keys memory blocks
+	B1_T_MEM_BLOCK_DESC vals_desc;
+	B1_T_MEM_BLOCK_DESC keys_desc;
+	// hash table size (power of two or zero), number of keys, number of non-free slots (keys and deleted keys)
+	B1_T_MEMOFFSET size;
+	B1_T_MEMOFFSET count;
+	B1_T_MEMOFFSET used;
+	// ordinal number and slot of the key returned by the last b1_var_map_get_key call (0 if not set)
+	B1_T_MEMOFFSET iter_num;
+	B1_T_MEMOFFSET iter_slot;
+} B1_VAR_MAP_HDR;
+
+// map hash table slot
+typedef struct
+{
+	uint32_t hash;
+	// key string memory block
+	B1_T_MEM_BLOCK_DESC desc;
+	uint8_t state;
+} B1_VAR_MAP_KEY;
+#endif
+
+#ifdef B1_FEATURE_VAR_SLOTS
+// slot number meaning that no slot is assigned to an identifier
+#define B1_VAR_SLOT_NONE ((uint8_t)0xFF)
+
+typedef struct
+{
+	B1_T_IDHASH hash;
+	uint8_t slot;
+} B1_VAR_SLOT;
+#endif
+
 
 extern B1_T_ERROR b1_var_str2var(const B1_T_CHAR *s, B1_VAR *var);
 extern B1_T_ERROR b1_var_var2str(const B1_VAR *var, B1_T_CHAR *sbuf);
 extern B1_T_ERROR b1_var_convert(B1_VAR *var, uint8_t otype);
+extern uint8_t b1_var_get_type_size(uint8_t type);
 extern B1_T_ERROR b1_var_init_empty(uint8_t type, uint8_t argnum, const B1_T_SUBSCRIPT *subs_bounds, B1_VAR *pvar);
 extern B1_T_ERROR b1_var_array_get_data_ptr(B1_T_MEM_BLOCK_DESC arr_data_desc, uint8_t type, B1_T_MEMOFFSET offset, void **data);
 extern B1_T_ERROR b1_var_create(B1_T_IDHASH name_hash, uint8_t type, uint8_t argnum, const B1_T_SUBSCRIPT *subs_bounds, B1_NAMED_VAR **var);
 extern B1_T_ERROR b1_var_get(B1_NAMED_VAR *src_var, B1_VAR *dst_var, B1_VAR_REF *src_var_ref);
 extern B1_T_ERROR b1_var_set(B1_VAR *src_var, const B1_VAR_REF *dst_var_ref);
 
+#ifdef B1_VAR_ARRAY_BULK_ACCESS
+extern B1_T_ERROR b1_var_array_get_info(const B1_NAMED_VAR *var, uint8_t alloc, B1_VAR_ARRAY_INFO *info);
+extern B1_T_ERROR b1_var_array_copy(const B1_VAR_ARRAY_INFO *info, B1_T_MEMOFFSET offset, B1_T_MEMOFFSET count, B1_T_ARRAY_VAL *buf, uint8_t write);
+#endif
+
+#ifdef B1_FEATURE_STMT_SORT
+extern B1_T_ERROR b1_var_array_swap(const B1_VAR_ARRAY_INFO *info, B1_T_MEMOFFSET i, B1_T_MEMOFFSET j);
+extern B1_T_ERROR b1_var_array_get_str(const B1_VAR_ARRAY_INFO *info, B1_T_MEMOFFSET i, B1_T_CHAR *sbuf);
+#endif
+
+#ifdef B1_FEATURE_TYPE_MAP
+extern B1_T_ERROR b1_var_map_create(B1_T_IDHASH name_hash, uint8_t type, B1_NAMED_VAR **var);
+extern B1_T_ERROR b1_var_map_find(const B1_NAMED_VAR *var, B1_VAR *key, uint8_t del);
+extern B1_T_ERROR b1_var_map_get_count(const B1_NAMED_VAR *var, B1_T_MEMOFFSET *count);
+extern B1_T_ERROR b1_var_map_get_key(const B1_NAMED_VAR *var, B1_T_MEMOFFSET num, B1_T_CHAR *sbuf);
+extern B1_T_ERROR b1_var_map_free(const B1_NAMED_VAR *var);
+#endif
+
+#ifdef B1_FEATURE_VAR_SLOTS
+extern B1_NAMED_VAR *b1_var_slots[B1_MAX_VAR_SLOTS_NUM];
+
+extern void b1_var_slot_init();
+extern void b1_var_slot_add(B1_T_IDHASH name_hash);
+extern uint8_t b1_var_slot_get(B1_T_IDHASH name_hash);
+extern void b1_var_slot_free(B1_T_IDHASH name_hash);
+#endif
+
 #endif
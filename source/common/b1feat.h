@@ -32,12 +32,35 @@
 // DEF statement and user defined functions
 #define B1_FEATURE_FUNCTIONS_USER
 
+// FUNCTION ... END FUNCTION multi-line user defined functions with local variables,
+// requires B1_FEATURE_FUNCTIONS_USER feature
+//#define B1_FEATURE_STMT_FUNCTION
+
+// results cache for pure DEF functions (using only arguments, constants and deterministic built-in
+// functions), requires B1_FEATURE_FUNCTIONS_USER feature
+//#define B1_FEATURE_FUNCTIONS_USER_MEMO
+
+// inline expansion of short DEF functions into cached expressions RPN, requires B1_FEATURE_FUNCTIONS_USER
+// and B1_FEATURE_RPN_CACHING features
+//#define B1_FEATURE_FUNCTIONS_USER_INLINE
+
+// SUM, MIN, MAX, MEAN, DOT functions taking whole arrays as arguments, require SINGLE or DOUBLE type
+//#define B1_FEATURE_FUNCTIONS_ARRAY
+
+// map variables (DIM <var_name> AS MAP statement), DELETE statement, EXISTS, COUNT, KEY$ functions,
+// requires B1_FEATURE_FUNCTIONS_ARRAY feature
+//#define B1_FEATURE_TYPE_MAP
+
 // enable SINGLE type
 #define B1_FEATURE_TYPE_SINGLE
 
 // enable DOUBLE type
 #define B1_FEATURE_TYPE_DOUBLE
 
+// shortest decimal representation of SINGLE and DOUBLE values converted to strings (PRINT statement, STR$
+// function) with Grisu2 algorithm instead of sprintf function, requires SINGLE or DOUBLE type and 64-bit integers
+//#define B1_FEATURE_FP_SHORTEST_DIGITS
+
 // enable RPN caching
 #define B1_FEATURE_RPN_CACHING
 
@@ -78,6 +101,11 @@
 // (depends on the logical expression evaluation result)
 #define B1_FEATURE_MINIMAL_EVALUATION
 
+// logical AND, OR and NOT operators for boolean operands (comparison results), AND and OR operators do not
+// evaluate the right operand if the left one determines the result (bitwise operators are used with numeric
+// operands), requires B1_FEATURE_MINIMAL_EVALUATION feature
+//#define B1_FEATURE_MINIMAL_EVALUATION_AND_OR
+
 // BREAK and CONTINUE statements
 #define B1_FEATURE_STMT_BREAK_CONTINUE
 
@@ -100,12 +128,57 @@
 // enables PUT and GET statements
 //#define B1_FEATURE_STMT_PUT_GET
 
+// enables MAT statement (whole-array assignment, addition, subtraction, multiplication, scalar multiplication,
+// ZER, CON, IDN and TRN functions, MAT READ and MAT PRINT forms), requires SINGLE or DOUBLE type
+//#define B1_FEATURE_STMT_MAT
+
+// enables SORT statement and SEARCH function, requires B1_FEATURE_FUNCTIONS_ARRAY feature
+//#define B1_FEATURE_STMT_SORT
+
 // enables B1_TOKEN_TYPE_DEVNAME token subtype
 //#define B1_FEATURE_TOKEN_TYPE_DEVNAME
 
 // enables using 32-bit hash function for keywords and identifiers
 //#define B1_FEATURE_HASH_32BIT
 
+// makes random generator seed (B1_T_RAND_SEED type) 32-bit wide instead of 16-bit one
+//#define B1_FEATURE_RAND_SEED_32BIT
+
+// enables RANDOMIZE <num_expr> statement starting the same random values sequence for the same expression value,
+// requires b1_ex_rnd_seed function
+//#define B1_FEATURE_RANDOMIZE_SEED
+
+// memory manager can allocate zero-filled memory blocks (b1_ex_mem_alloc_zeroed function),
+// newly allocated arrays are not initialized element by element then
+//#define B1_FEATURE_MEM_ZEROED_ALLOC
+
+// memory manager keeps all memory blocks allocated during program execution in one region and
+// can free them at once (b1_ex_mem_free_all function), b1_int_reset function uses it instead of
+// freeing memory of every variable separately (makes sense with B1_FEATURE_INIT_FREE_MEMORY only)
+//#define B1_FEATURE_MEM_FREE_ALL
+
+// b1_int_prerun function assigns slot numbers to identifiers used in program lines, RPN records refer
+// to variables by slot numbers so already created variables are not looked up by hash on every access
+// (requires variable pointers returned by b1_ex_var_alloc function to stay valid until the variable is freed)
+//#define B1_FEATURE_VAR_SLOTS
+
+// b1_rpn_build function binds built-in function names to b1_fn_bltin table indices, so the functions are not
+// looked up by hash on every call (requires at least one built-in functions feature)
+//#define B1_FEATURE_BLTIN_FN_BINDING
+
+// PRINT statement passes whole runs of characters (up to the print margin) to b1_ex_io_print_str function instead
+// of calling b1_ex_io_print_char function for every character, b1_int_run function calls b1_ex_io_print_flush
+// function before returning (so the output can be buffered)
+//#define B1_FEATURE_IO_PRINT_STR
+
+// INPUT statement reads whole lines with b1_ex_io_input_line function instead of calling b1_ex_io_input_char
+// function for every character (the line is echoed at once too)
+//#define B1_FEATURE_IO_INPUT_LINE
+
+// OPEN, CLOSE, LINE INPUT statements, PRINT # and INPUT # forms and EOF function for sequential text files
+// (b1_ex_file_* functions), requires B1_FEATURE_TOKEN_TYPE_DEVNAME and B1_FEATURE_FUNCTIONS_STANDARD features
+//#define B1_FEATURE_STMT_FILE
+
 
 // constraints and memory usage
 #define B1_MAX_PROGLINE_LEN 255
@@ -125,11 +198,47 @@
 
 #ifdef B1_FEATURE_FUNCTIONS_USER
 #define B1_MAX_UDEF_FN_RPN_LEN (768 / sizeof(B1_RPNREC))
-#define B1_MAX_UDEF_CALL_NEST_DEPTH 3
+// DEF expression constants text (and identifier names in debug builds), must not exceed B1_T_INDEX range
+#define B1_MAX_UDEF_FN_TEXT_LEN 255
+// call frames are kept in a memory block growing on demand, the value limits recursion depth
+#define B1_MAX_UDEF_CALL_NEST_DEPTH 16
+#ifdef B1_FEATURE_FUNCTIONS_USER_MEMO
+// pure functions results cache size (records)
+#define B1_MAX_UDEF_MEMO_NUM 16
+#endif
+#ifdef B1_FEATURE_FUNCTIONS_USER_INLINE
+// max. RPN length of DEF function to be inlined (records)
+#define B1_MAX_UDEF_INLINE_LEN 8
+#endif
 #endif
 
 #ifdef B1_FEATURE_DEBUG
 #define B1_MAX_BREAKPOINT_NUM 32
 #endif
 
+#ifdef B1_FEATURE_VAR_SLOTS
+// must not exceed 255
+#define B1_MAX_VAR_SLOTS_NUM 64
+#endif
+
+#ifdef B1_FEATURE_STMT_MAT
+// matrix multiplication and transposition process arrays by square tiles of the size
+#define B1_MAT_TILE_SIZE 8
+#endif
+
+#ifdef B1_FEATURE_STMT_SORT
+// max. number of arrays in SORT statement (the array to sort and arrays rearranged together with it)
+#define B1_MAX_SORT_ARR_NUM 4
+#endif
+
+#ifdef B1_FEATURE_TYPE_MAP
+// initial map hash table size (must be a power of two)
+#define B1_MAP_INIT_SIZE 8
+#endif
+
+#ifdef B1_FEATURE_STMT_FILE
+// max. file channel number (channels are numbered from 1, must not exceed 255)
+#define B1_MAX_FILE_CHAN_NUM 4
+#endif
+
 #endif
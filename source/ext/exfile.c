@@ -0,0 +1,362 @@
+/*
+ BASIC1 interpreter
+ Copyright (c) 2020 Nikolay Pletnev
+ MIT license
+
+ exfile.c: sequential text files (POSIX file descriptors with per-channel buffers)
+*/
+
+
+#include "b1ex.h"
+#include "b1err.h"
+
+
+#ifdef B1_FEATURE_STMT_FILE
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+
+#define B1_EX_FILE_BUF_LEN 32768
+
+typedef struct
+{
+	// file descriptor (-1 if the channel is not open)
+	int fd;
+	uint8_t mode;
+	// input files: the end of file is reached (no more data to read into the buffer)
+	uint8_t eof;
+	// unread data (input files) is buf[pos]...buf[len - 1], output files write data out when the buffer is full
+	size_t pos;
+	size_t len;
+	char buf[B1_EX_FILE_BUF_LEN];
+} B1_EX_FILE_CHAN;
+
+static B1_EX_FILE_CHAN b1_ex_file_chans[B1_MAX_FILE_CHAN_NUM];
+static uint8_t b1_ex_file_init = 0;
+
+
+// returns the channel opened in the mode specified (input or any output mode) or NULL
+static B1_EX_FILE_CHAN *b1_ex_file_get_chan(uint8_t chan, uint8_t input)
+{
+	B1_EX_FILE_CHAN *fc;
+
+	if(!b1_ex_file_init || chan < 1 || chan > B1_MAX_FILE_CHAN_NUM)
+	{
+		return NULL;
+	}
+
+	fc = b1_ex_file_chans + chan - 1;
+
+	if((*fc).fd < 0 || ((*fc).mode == B1_EX_FILE_INPUT) != (input != 0))
+	{
+		return NULL;
+	}
+
+	return fc;
+}
+
+static B1_T_ERROR b1_ex_file_flush(B1_EX_FILE_CHAN *fc)
+{
+	size_t off;
+	ssize_t n;
+
+	for(off = 0; off < (*fc).len; off += (size_t)n)
+	{
+		n = write((*fc).fd, (*fc).buf + off, (*fc).len - off);
+		if(n <= 0)
+		{
+			(*fc).len = 0;
+			return B1_RES_EENVFAT;
+		}
+	}
+
+	(*fc).len = 0;
+
+	return B1_RES_OK;
+}
+
+// moves unread data to the beginning of the buffer and reads as much data as the rest of the buffer can hold
+static B1_T_ERROR b1_ex_file_fill(B1_EX_FILE_CHAN *fc)
+{
+	ssize_t n;
+
+	if((*fc).pos != 0)
+	{
+		memmove((*fc).buf, (*fc).buf + (*fc).pos, (*fc).len - (*fc).pos);
+		(*fc).len -= (*fc).pos;
+		(*fc).pos = 0;
+	}
+
+	n = read((*fc).fd, (*fc).buf + (*fc).len, B1_EX_FILE_BUF_LEN - (*fc).len);
+	if(n < 0)
+	{
+		return B1_RES_EENVFAT;
+	}
+
+	if(n == 0)
+	{
+		(*fc).eof = 1;
+	}
+
+	(*fc).len += (size_t)n;
+
+	return B1_RES_OK;
+}
+
+B1_T_ERROR b1_ex_file_open(uint8_t chan, const B1_T_CHAR *name, uint8_t mode)
+{
+	B1_EX_FILE_CHAN *fc;
+	char path[B1_MAX_STRING_LEN + 1];
+	B1_T_INDEX i;
+	int flags;
+
+	if(!b1_ex_file_init)
+	{
+		for(i = 0; i < B1_MAX_FILE_CHAN_NUM; i++)
+		{
+			b1_ex_file_chans[i].fd = -1;
+		}
+
+		b1_ex_file_init = 1;
+	}
+
+	if(chan < 1 || chan > B1_MAX_FILE_CHAN_NUM)
+	{
+		return B1_RES_EINVARG;
+	}
+
+	fc = b1_ex_file_chans + chan - 1;
+
+	if((*fc).fd >= 0)
+	{
+		return B1_RES_EINVARG;
+	}
+
+	if(*name == 0)
+	{
+		return B1_RES_EINVARG;
+	}
+
+	// file names are converted to 8-bit characters
+	for(i = 0; i < (B1_T_INDEX)*name; i++)
+	{
+		path[i] = (char)*(name + i + 1);
+	}
+	path[i] = 0;
+
+	flags = (mode == B1_EX_FILE_INPUT) ? O_RDONLY : (mode == B1_EX_FILE_OUTPUT) ? (O_WRONLY | O_CREAT | O_TRUNC) : (O_WRONLY | O_CREAT | O_APPEND);
+
+	(*fc).fd = open(path, flags, 0666);
+	if((*fc).fd < 0)
+	{
+		return B1_RES_EENVFAT;
+	}
+
+	(*fc).mode = mode;
+	(*fc).eof = 0;
+	(*fc).pos = 0;
+	(*fc).len = 0;
+
+	return B1_RES_OK;
+}
+
+B1_T_ERROR b1_ex_file_close(uint8_t chan)
+{
+	B1_T_ERROR err, err1;
+	B1_EX_FILE_CHAN *fc;
+	uint8_t i;
+
+	err = B1_RES_OK;
+
+	if(!b1_ex_file_init)
+	{
+		return err;
+	}
+
+	for(i = 1; i <= B1_MAX_FILE_CHAN_NUM; i++)
+	{
+		if(chan != 0 && chan != i)
+		{
+			continue;
+		}
+
+		fc = b1_ex_file_chans + i - 1;
+
+		if((*fc).fd < 0)
+		{
+			continue;
+		}
+
+		if((*fc).mode != B1_EX_FILE_INPUT)
+		{
+			err1 = b1_ex_file_flush(fc);
+			if(err == B1_RES_OK)
+			{
+				err = err1;
+			}
+		}
+
+		if(close((*fc).fd) != 0 && err == B1_RES_OK)
+		{
+			err = B1_RES_EENVFAT;
+		}
+
+		(*fc).fd = -1;
+	}
+
+	return err;
+}
+
+B1_T_ERROR b1_ex_file_write(uint8_t chan, const B1_T_CHAR *sdata, B1_T_INDEX slen)
+{
+	B1_T_ERROR err;
+	B1_EX_FILE_CHAN *fc;
+	size_t n;
+	char *p;
+
+	fc = b1_ex_file_get_chan(chan, 0);
+	if(fc == NULL)
+	{
+		return B1_RES_EINVARG;
+	}
+
+	while(slen)
+	{
+		if((*fc).len == B1_EX_FILE_BUF_LEN)
+		{
+			err = b1_ex_file_flush(fc);
+			if(err != B1_RES_OK)
+			{
+				return err;
+			}
+		}
+
+		n = B1_EX_FILE_BUF_LEN - (*fc).len;
+		if(n > slen)
+		{
+			n = slen;
+		}
+		slen -= (B1_T_INDEX)n;
+
+		p = (*fc).buf + (*fc).len;
+		(*fc).len += n;
+
+		if(sdata == NULL)
+		{
+			memset(p, ' ', n);
+		}
+		else
+		{
+			// characters are written as 8-bit ones
+			for(; n; n--)
+			{
+				*p++ = (char)*sdata++;
+			}
+		}
+	}
+
+	return B1_RES_OK;
+}
+
+B1_T_ERROR b1_ex_file_read_line(uint8_t chan, B1_T_CHAR *sbuf, B1_T_INDEX buflen, B1_T_INDEX *len)
+{
+	B1_T_ERROR err;
+	B1_EX_FILE_CHAN *fc;
+	const char *s, *e;
+	size_t n, i;
+
+	fc = b1_ex_file_get_chan(chan, 1);
+	if(fc == NULL)
+	{
+		return B1_RES_EINVARG;
+	}
+
+	// look for new line character in the buffered data, read more data if there is no one
+	for(i = 0; ; )
+	{
+		s = (*fc).buf + (*fc).pos;
+		n = (*fc).len - (*fc).pos;
+
+		e = (const char *)memchr(s + i, '\n', n - i);
+		if(e != NULL)
+		{
+			n = (size_t)(e - s);
+			(*fc).pos += n + 1;
+			break;
+		}
+
+		if((*fc).eof)
+		{
+			if(n == 0)
+			{
+				return B1_RES_EEOF;
+			}
+
+			// the last line without new line character
+			(*fc).pos += n;
+			break;
+		}
+
+		if(n == B1_EX_FILE_BUF_LEN)
+		{
+			// the line does not fit the buffer
+			return B1_RES_EBUFSMALL;
+		}
+
+		// already checked data is not searched again
+		i = n;
+
+		err = b1_ex_file_fill(fc);
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
+	}
+
+	// CR LF new line sequence
+	if(n != 0 && s[n - 1] == '\r')
+	{
+		n--;
+	}
+
+	if(n > buflen)
+	{
+		return B1_RES_EBUFSMALL;
+	}
+
+	for(i = 0; i < n; i++)
+	{
+		*(sbuf + i) = (B1_T_CHAR)(unsigned char)s[i];
+	}
+
+	*len = (B1_T_INDEX)n;
+
+	return B1_RES_OK;
+}
+
+B1_T_ERROR b1_ex_file_eof(uint8_t chan, uint8_t *eof)
+{
+	B1_T_ERROR err;
+	B1_EX_FILE_CHAN *fc;
+
+	fc = b1_ex_file_get_chan(chan, 1);
+	if(fc == NULL)
+	{
+		return B1_RES_EINVARG;
+	}
+
+	if((*fc).pos == (*fc).len && !(*fc).eof)
+	{
+		err = b1_ex_file_fill(fc);
+		if(err != B1_RES_OK)
+		{
+			return err;
+		}
+	}
+
+	*eof = ((*fc).pos == (*fc).len);
+
+	return B1_RES_OK;
+}
+#endif
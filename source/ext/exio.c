@@ -8,6 +8,7 @@
 
 
 #include <stdio.h>
+#include <string.h>
 
 #include "b1err.h"
 
@@ -16,6 +17,106 @@
 #endif
 
 
+#ifdef B1_FEATURE_IO_PRINT_STR
+#define B1_EX_IO_PRINT_BUF_LEN 256
+
+// output buffer, it is written on new line, when full and before reading input
+#ifdef B1_FEATURE_UNICODE_UCS2
+static wchar_t b1_ex_io_print_buf[B1_EX_IO_PRINT_BUF_LEN];
+#else
+static char b1_ex_io_print_buf[B1_EX_IO_PRINT_BUF_LEN];
+#endif
+static unsigned int b1_ex_io_print_buf_len = 0;
+
+
+B1_T_ERROR b1_ex_io_print_flush()
+{
+	unsigned int len;
+#ifdef B1_FEATURE_UNICODE_UCS2
+	unsigned int i;
+#endif
+
+	len = b1_ex_io_print_buf_len;
+	b1_ex_io_print_buf_len = 0;
+
+#ifdef B1_FEATURE_UNICODE_UCS2
+	for(i = 0; i < len; i++)
+	{
+		if(putwchar(b1_ex_io_print_buf[i]) == WEOF)
+		{
+			return B1_RES_EENVFAT;
+		}
+	}
+#else
+	if(len != 0 && fwrite(b1_ex_io_print_buf, 1, len, stdout) != len)
+	{
+		return B1_RES_EENVFAT;
+	}
+#endif
+
+	return B1_RES_OK;
+}
+
+B1_T_ERROR b1_ex_io_print_str(const B1_T_CHAR *sdata, B1_T_INDEX slen)
+{
+	B1_T_ERROR err;
+	unsigned int n;
+
+	while(slen)
+	{
+		if(b1_ex_io_print_buf_len == B1_EX_IO_PRINT_BUF_LEN)
+		{
+			err = b1_ex_io_print_flush();
+			if(err != B1_RES_OK)
+			{
+				return err;
+			}
+		}
+
+		n = B1_EX_IO_PRINT_BUF_LEN - b1_ex_io_print_buf_len;
+		if(n > slen)
+		{
+			n = slen;
+		}
+		slen -= n;
+
+		for(; n; n--)
+		{
+#ifdef B1_FEATURE_UNICODE_UCS2
+			b1_ex_io_print_buf[b1_ex_io_print_buf_len++] = (sdata == NULL) ? (wchar_t)' ' : (wchar_t)*sdata++;
+#else
+			b1_ex_io_print_buf[b1_ex_io_print_buf_len++] = (sdata == NULL) ? ' ' : (char)*sdata++;
+#endif
+		}
+	}
+
+	return B1_RES_OK;
+}
+
+B1_T_ERROR b1_ex_io_print_char(B1_T_CHAR c)
+{
+	return b1_ex_io_print_str(&c, 1);
+}
+
+B1_T_ERROR b1_ex_io_print_newline()
+{
+	B1_T_ERROR err;
+
+	// fwrite translates '\n' to "\r\n" by itself for text output
+	err = b1_ex_io_print_char((B1_T_CHAR)'\n');
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+
+	return b1_ex_io_print_flush();
+}
+
+B1_T_ERROR b1_ex_io_print_margin_newline()
+{
+	return b1_ex_io_print_newline();
+}
+#else
 B1_T_ERROR b1_ex_io_print_char(B1_T_CHAR c)
 {
 #ifdef B1_FEATURE_UNICODE_UCS2
@@ -47,12 +148,29 @@ B1_T_ERROR b1_ex_io_print_margin_newline()
 #endif
 	return B1_RES_OK;
 }
+#endif
 
 B1_T_ERROR b1_ex_io_input_char(B1_T_CHAR *c)
 {
+#ifdef B1_FEATURE_IO_PRINT_STR
+	B1_T_ERROR err;
+#endif
 #ifdef B1_FEATURE_UNICODE_UCS2
 	wint_t ic;
+#else
+	int ic;
+#endif
 
+#ifdef B1_FEATURE_IO_PRINT_STR
+	// prompt has to be visible before reading input
+	err = b1_ex_io_print_flush();
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+#endif
+
+#ifdef B1_FEATURE_UNICODE_UCS2
 	ic = getwchar();
 
 	if(ic == WEOF)
@@ -67,8 +185,6 @@ B1_T_ERROR b1_ex_io_input_char(B1_T_CHAR *c)
 
 	*c = (B1_T_CHAR)ic;
 #else
-	int ic;
-
 	ic = getchar();
 
 	if(ic == EOF)
@@ -85,3 +201,83 @@ B1_T_ERROR b1_ex_io_input_char(B1_T_CHAR *c)
 #endif
 	return B1_RES_OK;
 }
+
+#ifdef B1_FEATURE_IO_INPUT_LINE
+#define B1_EX_IO_INPUT_BUF_LEN 1024
+
+// the line is taken from block-buffered standard input stream at once
+#ifdef B1_FEATURE_UNICODE_UCS2
+static wchar_t b1_ex_io_input_buf[B1_EX_IO_INPUT_BUF_LEN];
+#else
+static char b1_ex_io_input_buf[B1_EX_IO_INPUT_BUF_LEN];
+#endif
+
+
+B1_T_ERROR b1_ex_io_input_line(B1_T_CHAR *sbuf, B1_T_INDEX buflen, B1_T_INDEX *len)
+{
+#ifdef B1_FEATURE_IO_PRINT_STR
+	B1_T_ERROR err;
+#endif
+	size_t n, i;
+#ifdef B1_FEATURE_UNICODE_UCS2
+	const wchar_t *e;
+#else
+	const char *e;
+#endif
+
+#ifdef B1_FEATURE_IO_PRINT_STR
+	// prompt has to be visible before reading input
+	err = b1_ex_io_print_flush();
+	if(err != B1_RES_OK)
+	{
+		return err;
+	}
+#endif
+
+#ifdef B1_FEATURE_UNICODE_UCS2
+	if(fgetws(b1_ex_io_input_buf, B1_EX_IO_INPUT_BUF_LEN, stdin) == NULL)
+#else
+	if(fgets(b1_ex_io_input_buf, B1_EX_IO_INPUT_BUF_LEN, stdin) == NULL)
+#endif
+	{
+		return feof(stdin) ? B1_RES_EEOF : B1_RES_EENVFAT;
+	}
+
+#ifdef B1_FEATURE_UNICODE_UCS2
+	n = wcslen(b1_ex_io_input_buf);
+	e = wmemchr(b1_ex_io_input_buf, L'\n', n);
+#else
+	n = strlen(b1_ex_io_input_buf);
+	e = (const char *)memchr(b1_ex_io_input_buf, '\n', n);
+#endif
+
+	if(e != NULL)
+	{
+		n = (size_t)(e - b1_ex_io_input_buf);
+	}
+	else
+	if(n == B1_EX_IO_INPUT_BUF_LEN - 1)
+	{
+		// the line does not fit the buffer
+		return B1_RES_EBUFSMALL;
+	}
+
+	if(n > buflen)
+	{
+		return B1_RES_EBUFSMALL;
+	}
+
+	for(i = 0; i < n; i++)
+	{
+#ifdef B1_FEATURE_UNICODE_UCS2
+		*(sbuf + i) = (B1_T_CHAR)b1_ex_io_input_buf[i];
+#else
+		*(sbuf + i) = (B1_T_CHAR)(unsigned char)b1_ex_io_input_buf[i];
+#endif
+	}
+
+	*len = (B1_T_INDEX)n;
+
+	return B1_RES_OK;
+}
+#endif
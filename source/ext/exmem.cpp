@@ -3,12 +3,13 @@
  Copyright (c) 2020 Nikolay Pletnev
  MIT license
 
- exmem.cpp: memory management functions for interpreter (using C++ new and
- delete operators)
+ exmem.cpp: memory management functions for interpreter (using C standard
+ library malloc, calloc and free functions)
 */
 
 
 #include <cstdint>
+#include <cstddef>
 #include <cstdlib>
 
 extern "C"
@@ -18,6 +19,38 @@ extern "C"
 }
 
 
+#ifdef B1_FEATURE_MEM_FREE_ALL
+// every memory block is preceded with the header linking it into the list of all blocks allocated
+// during program execution (the list is used for freeing entire region at once)
+struct alignas(std::max_align_t) b1_ex_mem_hdr
+{
+	b1_ex_mem_hdr *prev;
+	b1_ex_mem_hdr *next;
+};
+
+// the list head
+static b1_ex_mem_hdr b1_ex_mem_region = { &b1_ex_mem_region, &b1_ex_mem_region };
+
+
+static B1_T_MEM_BLOCK_DESC b1_ex_mem_link(void *block)
+{
+	b1_ex_mem_hdr *hdr;
+
+	if(block == NULL)
+	{
+		return B1_T_MEM_BLOCK_DESC_INVALID;
+	}
+
+	hdr = (b1_ex_mem_hdr *)block;
+	hdr->prev = &b1_ex_mem_region;
+	hdr->next = b1_ex_mem_region.next;
+	b1_ex_mem_region.next->prev = hdr;
+	b1_ex_mem_region.next = hdr;
+
+	return (B1_T_MEM_BLOCK_DESC)(hdr + 1);
+}
+#endif
+
 extern "C" B1_T_ERROR b1_ex_mem_init()
 {
 	return B1_RES_OK;
@@ -25,7 +58,11 @@ extern "C" B1_T_ERROR b1_ex_mem_init()
 
 extern "C" B1_T_ERROR b1_ex_mem_alloc(B1_T_MEMOFFSET size, B1_T_MEM_BLOCK_DESC *mem_desc, void **data)
 {
-	*mem_desc = new uint8_t[size];
+#ifdef B1_FEATURE_MEM_FREE_ALL
+	*mem_desc = b1_ex_mem_link(std::malloc(sizeof(b1_ex_mem_hdr) + size));
+#else
+	*mem_desc = std::malloc(size);
+#endif
 
 	if(*mem_desc == NULL)
 	{
@@ -40,6 +77,26 @@ extern "C" B1_T_ERROR b1_ex_mem_alloc(B1_T_MEMOFFSET size, B1_T_MEM_BLOCK_DESC *
 	return B1_RES_OK;
 }
 
+#ifdef B1_FEATURE_MEM_ZEROED_ALLOC
+// calloc does not touch large blocks obtained from OS (fresh anonymous memory pages are already
+// zero-filled and committed lazily on the first write)
+extern "C" B1_T_ERROR b1_ex_mem_alloc_zeroed(B1_T_MEMOFFSET size, B1_T_MEM_BLOCK_DESC *mem_desc)
+{
+#ifdef B1_FEATURE_MEM_FREE_ALL
+	*mem_desc = b1_ex_mem_link(std::calloc(sizeof(b1_ex_mem_hdr) + size, 1));
+#else
+	*mem_desc = std::calloc(size, 1);
+#endif
+
+	if(*mem_desc == NULL)
+	{
+		return B1_RES_ENOMEM;
+	}
+
+	return B1_RES_OK;
+}
+#endif
+
 extern "C" B1_T_ERROR b1_ex_mem_access(const B1_T_MEM_BLOCK_DESC mem_desc, B1_T_MEMOFFSET offset, B1_T_INDEX size, uint8_t options, void **data)
 {
 	size;
@@ -56,6 +113,33 @@ extern "C" B1_T_ERROR b1_ex_mem_release(const B1_T_MEM_BLOCK_DESC mem_desc)
 
 extern "C" B1_T_ERROR b1_ex_mem_free(const B1_T_MEM_BLOCK_DESC mem_desc)
 {
-	delete[] (const uint8_t *)mem_desc;
+#ifdef B1_FEATURE_MEM_FREE_ALL
+	b1_ex_mem_hdr *hdr;
+
+	hdr = ((b1_ex_mem_hdr *)mem_desc) - 1;
+	hdr->prev->next = hdr->next;
+	hdr->next->prev = hdr->prev;
+	std::free(hdr);
+#else
+	std::free((void *)mem_desc);
+#endif
+	return B1_RES_OK;
+}
+
+#ifdef B1_FEATURE_MEM_FREE_ALL
+extern "C" B1_T_ERROR b1_ex_mem_free_all()
+{
+	b1_ex_mem_hdr *hdr, *next;
+
+	for(hdr = b1_ex_mem_region.next; hdr != &b1_ex_mem_region; hdr = next)
+	{
+		next = hdr->next;
+		std::free(hdr);
+	}
+
+	b1_ex_mem_region.prev = &b1_ex_mem_region;
+	b1_ex_mem_region.next = &b1_ex_mem_region;
+
 	return B1_RES_OK;
 }
+#endif
@@ -0,0 +1,272 @@
+/*
+ BASIC1 interpreter
+ Copyright (c) 2024 Nikolay Pletnev
+ MIT license
+
+ exmempool.c: memory management functions for interpreter working with a
+ fixed-size memory pool (an alternative to exmem.cpp for systems without
+ heap). Memory block descriptors are handles (pointers to handle table
+ entries) so the blocks can be moved by compactor when an allocation fails
+ because of fragmentation. Blocks accessed and not released yet are pinned
+ (never moved).
+*/
+
+
+#include <stdint.h>
+#include <string.h>
+
+#include "b1itypes.h"
+#include "b1err.h"
+
+
+// pool size in bytes
+#ifndef B1_EX_MEM_POOL_SIZE
+#define B1_EX_MEM_POOL_SIZE 32768
+#endif
+
+// max. number of memory blocks allocated at the same time
+#ifndef B1_EX_MEM_HANDLE_NUM
+#define B1_EX_MEM_HANDLE_NUM 1024
+#endif
+
+#if B1_EX_MEM_POOL_SIZE > B1_T_MEMOFFSET_MAX_VALUE
+#error B1_EX_MEM_POOL_SIZE value exceeds B1_T_MEMOFFSET type range
+#endif
+
+// memory blocks alignment (enough for any interpreter data type)
+#define B1_EX_MEM_ALIGN ((B1_T_MEMOFFSET)sizeof(double))
+#define B1_EX_MEM_ALIGN_SIZE(SIZE) ((((SIZE) + B1_EX_MEM_ALIGN - 1) / B1_EX_MEM_ALIGN) * B1_EX_MEM_ALIGN)
+
+
+// memory block header
+typedef struct
+{
+	// handle table entry the block belongs to (NULL for free blocks)
+	void **handle;
+	// block size (including the header)
+	B1_T_MEMOFFSET size;
+	// number of b1_ex_mem_alloc and b1_ex_mem_access calls not followed by b1_ex_mem_release calls yet
+	// (a block with non-zero counter is pinned: data pointers to it can be in use)
+	uint8_t access_cnt;
+} B1_EX_MEM_HDR;
+
+#define B1_EX_MEM_HDR_SIZE B1_EX_MEM_ALIGN_SIZE((B1_T_MEMOFFSET)sizeof(B1_EX_MEM_HDR))
+
+
+// the pool (double type is used for proper alignment)
+static double b1_ex_mem_pool[B1_EX_MEM_POOL_SIZE / sizeof(double)];
+// offset of the first byte after the last allocated block
+static B1_T_MEMOFFSET b1_ex_mem_top;
+// total size of freed blocks below b1_ex_mem_top (the space compactor can return)
+static B1_T_MEMOFFSET b1_ex_mem_holes;
+
+// handle table: an entry of allocated block points to the block header, an entry of free handle
+// points to the next free entry
+static void *b1_ex_mem_handles[B1_EX_MEM_HANDLE_NUM];
+// the first free handle table entry
+static void **b1_ex_mem_free_handle;
+
+
+#define B1_EX_MEM_POOL_PTR(OFFSET) (((uint8_t *)b1_ex_mem_pool) + (OFFSET))
+
+
+// moves all allocated blocks except for pinned ones towards the beginning of the pool making one contiguous
+// free area at its end. the space between a pinned block and the blocks moved down to it becomes a free block
+static void b1_ex_mem_compact()
+{
+	B1_T_MEMOFFSET src, dst, size;
+	B1_EX_MEM_HDR *hdr;
+
+	b1_ex_mem_holes = 0;
+
+	for(src = 0, dst = 0; src != b1_ex_mem_top; src += size)
+	{
+		hdr = (B1_EX_MEM_HDR *)B1_EX_MEM_POOL_PTR(src);
+		size = (*hdr).size;
+
+		if((*hdr).handle == NULL)
+		{
+			continue;
+		}
+
+		if(src != dst)
+		{
+			if((*hdr).access_cnt != 0)
+			{
+				// pinned block: leave it in place, the gap consists of free blocks so it is never
+				// smaller than a block header
+				hdr = (B1_EX_MEM_HDR *)B1_EX_MEM_POOL_PTR(dst);
+				(*hdr).handle = NULL;
+				(*hdr).size = src - dst;
+				(*hdr).access_cnt = 0;
+				b1_ex_mem_holes += src - dst;
+				dst = src;
+			}
+			else
+			{
+				memmove(B1_EX_MEM_POOL_PTR(dst), hdr, size);
+				*((*((B1_EX_MEM_HDR *)B1_EX_MEM_POOL_PTR(dst))).handle) = B1_EX_MEM_POOL_PTR(dst);
+			}
+		}
+
+		dst += size;
+	}
+
+	b1_ex_mem_top = dst;
+}
+
+B1_T_ERROR b1_ex_mem_init()
+{
+	uint16_t i;
+
+	b1_ex_mem_top = 0;
+	b1_ex_mem_holes = 0;
+
+	// link all handle table entries into the free list
+	for(i = 0; i < B1_EX_MEM_HANDLE_NUM - 1; i++)
+	{
+		b1_ex_mem_handles[i] = b1_ex_mem_handles + i + 1;
+	}
+	b1_ex_mem_handles[B1_EX_MEM_HANDLE_NUM - 1] = NULL;
+	b1_ex_mem_free_handle = b1_ex_mem_handles;
+
+	return B1_RES_OK;
+}
+
+B1_T_ERROR b1_ex_mem_alloc(B1_T_MEMOFFSET size, B1_T_MEM_BLOCK_DESC *mem_desc, void **data)
+{
+	B1_EX_MEM_HDR *hdr;
+	void **handle;
+
+	if(b1_ex_mem_free_handle == NULL)
+	{
+		return B1_RES_ENOMEM;
+	}
+
+	if(size > (B1_T_MEMOFFSET)(B1_EX_MEM_POOL_SIZE - B1_EX_MEM_HDR_SIZE))
+	{
+		return B1_RES_ENOMEM;
+	}
+
+	size = B1_EX_MEM_ALIGN_SIZE(size) + B1_EX_MEM_HDR_SIZE;
+
+	if(size > (B1_T_MEMOFFSET)B1_EX_MEM_POOL_SIZE - b1_ex_mem_top)
+	{
+		// not enough space even after compaction
+		if(size > (B1_T_MEMOFFSET)B1_EX_MEM_POOL_SIZE - b1_ex_mem_top + b1_ex_mem_holes)
+		{
+			return B1_RES_ENOMEM;
+		}
+
+		b1_ex_mem_compact();
+
+		// pinned blocks can prevent compactor from freeing enough space
+		if(size > (B1_T_MEMOFFSET)B1_EX_MEM_POOL_SIZE - b1_ex_mem_top)
+		{
+			return B1_RES_ENOMEM;
+		}
+	}
+
+	handle = b1_ex_mem_free_handle;
+	b1_ex_mem_free_handle = (void **)*handle;
+
+	hdr = (B1_EX_MEM_HDR *)B1_EX_MEM_POOL_PTR(b1_ex_mem_top);
+	(*hdr).handle = handle;
+	(*hdr).size = size;
+	// the block is accessible right after allocation
+	(*hdr).access_cnt = (data == NULL) ? 0 : 1;
+	*handle = hdr;
+
+	b1_ex_mem_top += size;
+
+	*mem_desc = (B1_T_MEM_BLOCK_DESC)handle;
+
+	if(data != NULL)
+	{
+		*data = ((uint8_t *)hdr) + B1_EX_MEM_HDR_SIZE;
+	}
+
+	return B1_RES_OK;
+}
+
+#ifdef B1_FEATURE_MEM_ZEROED_ALLOC
+B1_T_ERROR b1_ex_mem_alloc_zeroed(B1_T_MEMOFFSET size, B1_T_MEM_BLOCK_DESC *mem_desc)
+{
+	B1_T_ERROR err;
+	void *data;
+
+	err = b1_ex_mem_alloc(size, mem_desc, &data);
+	if(err == B1_RES_OK)
+	{
+		memset(data, 0, size);
+	}
+
+	return err;
+}
+#endif
+
+B1_T_ERROR b1_ex_mem_access(const B1_T_MEM_BLOCK_DESC mem_desc, B1_T_MEMOFFSET offset, B1_T_INDEX size, uint8_t options, void **data)
+{
+	B1_EX_MEM_HDR *hdr;
+
+	size;
+	options;
+
+	hdr = (B1_EX_MEM_HDR *)*((void **)mem_desc);
+
+	// a block accessed too many times without releasing stays pinned until it is freed
+	if((*hdr).access_cnt != UINT8_MAX)
+	{
+		(*hdr).access_cnt++;
+	}
+
+	*data = ((uint8_t *)hdr) + B1_EX_MEM_HDR_SIZE + offset;
+	return B1_RES_OK;
+}
+
+B1_T_ERROR b1_ex_mem_release(const B1_T_MEM_BLOCK_DESC mem_desc)
+{
+	B1_EX_MEM_HDR *hdr;
+
+	hdr = (B1_EX_MEM_HDR *)*((void **)mem_desc);
+
+	if((*hdr).access_cnt != 0)
+	{
+		(*hdr).access_cnt--;
+	}
+
+	return B1_RES_OK;
+}
+
+B1_T_ERROR b1_ex_mem_free(const B1_T_MEM_BLOCK_DESC mem_desc)
+{
+	void **handle;
+	B1_EX_MEM_HDR *hdr;
+
+	handle = (void **)mem_desc;
+	hdr = (B1_EX_MEM_HDR *)*handle;
+
+	if(((uint8_t *)hdr) + (*hdr).size == B1_EX_MEM_POOL_PTR(b1_ex_mem_top))
+	{
+		// the last block: just move the top down
+		b1_ex_mem_top -= (*hdr).size;
+	}
+	else
+	{
+		(*hdr).handle = NULL;
+		b1_ex_mem_holes += (*hdr).size;
+	}
+
+	// return the handle to the free list
+	*handle = b1_ex_mem_free_handle;
+	b1_ex_mem_free_handle = handle;
+
+	return B1_RES_OK;
+}
+
+#ifdef B1_FEATURE_MEM_FREE_ALL
+B1_T_ERROR b1_ex_mem_free_all()
+{
+	return b1_ex_mem_init();
+}
+#endif
@@ -13,23 +13,62 @@
 
 #ifdef B1_FEATURE_FUNCTIONS_MATH_BASIC
 #ifdef B1_FRACTIONAL_TYPE_EXISTS
-#include <stdlib.h>
 #include <time.h>
 
 
+// xoshiro128** generator state (all-zero state is not allowed)
+static uint32_t b1_ex_rnd_state[4];
+
+
+static uint32_t b1_ex_rnd_rotl(uint32_t x, uint8_t n)
+{
+	return (x << n) | (x >> (32 - n));
+}
+
+static uint32_t b1_ex_rnd_next()
+{
+	uint32_t res, t;
+
+	res = b1_ex_rnd_rotl(b1_ex_rnd_state[1] * 5, 7) * 9;
+	t = b1_ex_rnd_state[1] << 9;
+
+	b1_ex_rnd_state[2] ^= b1_ex_rnd_state[0];
+	b1_ex_rnd_state[3] ^= b1_ex_rnd_state[1];
+	b1_ex_rnd_state[1] ^= b1_ex_rnd_state[2];
+	b1_ex_rnd_state[0] ^= b1_ex_rnd_state[3];
+	b1_ex_rnd_state[2] ^= t;
+	b1_ex_rnd_state[3] = b1_ex_rnd_rotl(b1_ex_rnd_state[3], 11);
+
+	return res;
+}
+
 B1_T_RAND_SEED b1_ex_rnd_get_next_seed()
 {
-	int seed;
+	// the upper bits are the best ones
+	return (B1_T_RAND_SEED)(b1_ex_rnd_next() >> (32 - sizeof(B1_T_RAND_SEED) * 8));
+}
+
+void b1_ex_rnd_seed(uint32_t seed)
+{
+	uint8_t i;
+	uint32_t z;
 
-	seed = rand();
-	return (B1_T_RAND_SEED)((((float)seed) / (float)RAND_MAX) * ((float)B1_T_RAND_SEED_MAX_VALUE));
+	// state words are produced by bijective mixing of different values so they cannot be all zeroes
+	for(i = 0; i < 4; i++)
+	{
+		seed += 0x9E3779B9UL;
+		z = seed;
+		z = (z ^ (z >> 16)) * 0x85EBCA6BUL;
+		z = (z ^ (z >> 13)) * 0xC2B2AE35UL;
+		b1_ex_rnd_state[i] = z ^ (z >> 16);
+	}
 }
 
 void b1_ex_rnd_randomize(uint8_t init)
 {
-	srand(init ?
-		(unsigned int)0 :
-		((unsigned int)time(NULL) * rand())
+	b1_ex_rnd_seed(init ?
+		(uint32_t)0 :
+		((uint32_t)time(NULL) ^ b1_ex_rnd_next())
 		);
 }
 #endif
@@ -18,15 +18,48 @@ extern "C"
 }
 
 #ifdef B1_FEATURE_LOCALES
+#include <clocale>
+#include <cstring>
 #ifdef B1_FEATURE_UNICODE_UCS2
 #include <cwchar>
-#else
-#include <cstring>
 #endif
 #endif
 
 
 #ifdef B1_FEATURE_LOCALES
+// "C" collation flag: 1 - the current collation is the one of "C" (or "POSIX") locale, 0 - another collation,
+// -1 - not checked yet (the locale is checked once, not on every string comparison)
+static int8_t b1_t_coll_c = -1;
+
+
+// returns true if the current collation is the one of "C" (or "POSIX") locale: strcoll and wcscoll functions
+// are equivalent to strcmp and wcscmp then
+static bool b1_t_coll_is_c()
+{
+	const char *name;
+
+	if(b1_t_coll_c < 0)
+	{
+		name = std::setlocale(LC_COLLATE, NULL);
+		b1_t_coll_c = (name == NULL || (name[0] == 'C' && name[1] == 0) || std::strcmp(name, "POSIX") == 0) ? 1 : 0;
+	}
+
+	return b1_t_coll_c != 0;
+}
+
+// sets locale the same way setlocale function does, has to be used instead of setlocale function to change
+// collation after the first string comparison (makes b1_t_strcmp_l function check the new collation)
+extern "C" char *b1_t_setlocale(int category, const char *locale)
+{
+	b1_t_coll_c = -1;
+	return std::setlocale(category, locale);
+}
+
+static int8_t b1_t_coll_res(int res)
+{
+	return (int8_t)(res < 0 ? -1 : res > 0 ? 1 : 0);
+}
+
 #ifdef B1_FEATURE_UNICODE_UCS2
 extern "C" B1_T_CHAR b1_t_toupper_l(B1_T_CHAR c)
 {
@@ -40,16 +73,29 @@ extern "C" B1_T_CHAR b1_t_tolower_l(B1_T_CHAR c)
 
 extern "C" int8_t b1_t_strcmp_l(const B1_T_CHAR *s1, const B1_T_CHAR *s2data, B1_T_INDEX s2len)
 {
-	wchar_t *str1, *str2;
+	// string length is limited so the strings can be placed in stack buffers
+	wchar_t str1[B1_MAX_STRING_LEN + 1], str2[B1_MAX_STRING_LEN + 1];
 	B1_T_INDEX i, len;
-	int8_t res;
+	wchar_t c1, c2;
 
 	len = *s1;
-	str1 = new wchar_t[len + 1];
-	if(str1 == NULL)
+
+	if(b1_t_coll_is_c())
 	{
-		return B1_RES_ENOMEM;
+		// "C" collation: compare lower case characters one by one
+		for(i = 0; i < len && i < s2len; i++)
+		{
+			c1 = (wchar_t)B1_T_TOLOWER_L(*(s1 + i + 1));
+			c2 = (wchar_t)B1_T_TOLOWER_L(*(s2data + i));
+			if(c1 != c2)
+			{
+				return c1 < c2 ? -1 : 1;
+			}
+		}
+
+		return len < s2len ? -1 : len > s2len ? 1 : 0;
 	}
+
 	for(i = 0; i < len; i++)
 	{
 		s1++;
@@ -58,12 +104,6 @@ extern "C" int8_t b1_t_strcmp_l(const B1_T_CHAR *s1, const B1_T_CHAR *s2data, B1
 	*(str1 + i) = 0;
 
 	len = s2len;
-	str2 = new wchar_t[len + 1];
-	if(str2 == NULL)
-	{
-		delete[] str1;
-		return B1_RES_ENOMEM;
-	}
 	for(i = 0; i < len; i++)
 	{
 		*(str2 + i) = B1_T_TOLOWER_L(*s2data);
@@ -71,36 +111,44 @@ extern "C" int8_t b1_t_strcmp_l(const B1_T_CHAR *s1, const B1_T_CHAR *s2data, B1
 	}
 	*(str2 + i) = 0;
 
-	res = (int8_t)wcscoll(str1, str2);
-
-	delete[] str2;
-	delete[] str1;
-
-	return res;
+	return b1_t_coll_res(wcscoll(str1, str2));
 }
 #else
 extern "C" B1_T_CHAR b1_t_toupper_l(B1_T_CHAR c)
 {
-	return (B1_T_CHAR)toupper((char)c);
+	return (B1_T_CHAR)(unsigned char)toupper((unsigned char)c);
 }
 
 extern "C" B1_T_CHAR b1_t_tolower_l(B1_T_CHAR c)
 {
-	return (B1_T_CHAR)tolower((char)c);
+	return (B1_T_CHAR)(unsigned char)tolower((unsigned char)c);
 }
 
 extern "C" int8_t b1_t_strcmp_l(const B1_T_CHAR *s1, const B1_T_CHAR *s2data, B1_T_INDEX s2len)
 {
-	char *str1, *str2;
+	// string length is limited so the strings can be placed in stack buffers
+	char str1[B1_MAX_STRING_LEN + 1], str2[B1_MAX_STRING_LEN + 1];
 	B1_T_INDEX i, len;
-	int8_t res;
+	unsigned char c1, c2;
 
 	len = *s1;
-	str1 = new char[len + 1];
-	if(str1 == NULL)
+
+	if(b1_t_coll_is_c())
 	{
-		return B1_RES_ENOMEM;
+		// "C" collation: compare lower case characters one by one (as strcmp does)
+		for(i = 0; i < len && i < s2len; i++)
+		{
+			c1 = (unsigned char)B1_T_TOLOWER_L(*(s1 + i + 1));
+			c2 = (unsigned char)B1_T_TOLOWER_L(*(s2data + i));
+			if(c1 != c2)
+			{
+				return c1 < c2 ? -1 : 1;
+			}
+		}
+
+		return len < s2len ? -1 : len > s2len ? 1 : 0;
 	}
+
 	for(i = 0; i < len; i++)
 	{
 		s1++;
@@ -109,12 +157,6 @@ extern "C" int8_t b1_t_strcmp_l(const B1_T_CHAR *s1, const B1_T_CHAR *s2data, B1
 	*(str1 + i) = 0;
 
 	len = s2len;
-	str2 = new char[len + 1];
-	if(str2 == NULL)
-	{
-		delete[] str1;
-		return B1_RES_ENOMEM;
-	}
 	for(i = 0; i < len; i++)
 	{
 		*(str2 + i) = B1_T_TOLOWER_L(*s2data);
@@ -122,12 +164,7 @@ extern "C" int8_t b1_t_strcmp_l(const B1_T_CHAR *s1, const B1_T_CHAR *s2data, B1
 	}
 	*(str2 + i) = 0;
 
-	res = (int8_t)strcoll(str1, str2);
-
-	delete[] str2;
-	delete[] str1;
-
-	return res;
+	return b1_t_coll_res(strcoll(str1, str2));
 }
 #endif
 #endif
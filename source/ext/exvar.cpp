@@ -7,8 +7,10 @@
 */
 
 
-#include <cstdlib>
-#include <map>
+#include <cstdint>
+#include <cstddef>
+#include <deque>
+#include <vector>
 
 extern "C"
 {
@@ -17,12 +19,85 @@ extern "C"
 }
 
 
-static std::map<B1_T_IDHASH, B1_NAMED_VAR> b1_ex_vars;
+// initial size of the variables index (must be a power of two)
+#define B1_EX_VAR_INDEX_INIT_SIZE 64
 
 
+// variables cache node
+struct b1_ex_var_node
+{
+	// must be the first member (b1_ex_var_enum casts B1_NAMED_VAR pointers to node pointers)
+	B1_NAMED_VAR var;
+	B1_T_IDHASH name_hash;
+	// zero-based node index in the pool
+	uint32_t index;
+	bool used;
+};
+
+// node pool: std::deque does not move existing elements when growing so B1_NAMED_VAR pointers stay valid
+static std::deque<b1_ex_var_node> b1_ex_var_nodes;
+// indices of freed nodes
+static std::vector<uint32_t> b1_ex_var_free_nodes;
+// open-addressing (linear probing) index: one-based node indices, zero stands for empty slot
+static std::vector<uint32_t> b1_ex_var_index;
+// log2 of the index size
+static uint8_t b1_ex_var_index_bits;
+// number of variables in the cache
+static uint32_t b1_ex_var_count;
+
+
+// home slot of a hash value (multiplicative hashing, takes the upper bits of the product)
+static uint32_t b1_ex_var_home_slot(B1_T_IDHASH name_hash)
+{
+	return (uint32_t)(((uint32_t)name_hash * UINT32_C(2654435769)) >> (32 - b1_ex_var_index_bits));
+}
+
+// returns index slot containing the variable or the empty slot the variable should be put in
+static uint32_t b1_ex_var_find_slot(B1_T_IDHASH name_hash)
+{
+	uint32_t slot, mask, node;
+
+	mask = (uint32_t)b1_ex_var_index.size() - 1;
+
+	for(slot = b1_ex_var_home_slot(name_hash); ; slot = (slot + 1) & mask)
+	{
+		node = b1_ex_var_index[slot];
+
+		if(node == 0 || b1_ex_var_nodes[node - 1].name_hash == name_hash)
+		{
+			return slot;
+		}
+	}
+}
+
+static void b1_ex_var_rehash(uint8_t bits)
+{
+	uint32_t i;
+
+	b1_ex_var_index_bits = bits;
+	b1_ex_var_index.assign((size_t)1 << bits, 0);
+
+	for(i = 0; i < b1_ex_var_nodes.size(); i++)
+	{
+		if(b1_ex_var_nodes[i].used)
+		{
+			b1_ex_var_index[b1_ex_var_find_slot(b1_ex_var_nodes[i].name_hash)] = i + 1;
+		}
+	}
+}
+
 extern "C" B1_T_ERROR b1_ex_var_init()
 {
-	b1_ex_vars.clear();
+	b1_ex_var_nodes.clear();
+	b1_ex_var_free_nodes.clear();
+	b1_ex_var_count = 0;
+
+	b1_ex_var_index_bits = 0;
+	while(((uint32_t)1 << b1_ex_var_index_bits) < B1_EX_VAR_INDEX_INIT_SIZE)
+	{
+		b1_ex_var_index_bits++;
+	}
+	b1_ex_var_index.assign(B1_EX_VAR_INDEX_INIT_SIZE, 0);
 
 	return B1_RES_OK;
 }
@@ -30,53 +105,113 @@ extern "C" B1_T_ERROR b1_ex_var_init()
 // allocates memory for B1_NAMED_VAR structure or returns pointer to existing one (indicating this with B1_RES_EIDINUSE return code)
 extern "C" B1_T_ERROR b1_ex_var_alloc(B1_T_IDHASH name_hash, B1_NAMED_VAR **var)
 {
-	auto var_it = b1_ex_vars.find(name_hash);
-	
-	if(var_it == b1_ex_vars.end())
+	uint32_t slot, node;
+
+	if(b1_ex_var_index.empty())
 	{
-		*var = &b1_ex_vars[name_hash];
-		return B1_RES_OK;
+		b1_ex_var_init();
+	}
+
+	slot = b1_ex_var_find_slot(name_hash);
+	node = b1_ex_var_index[slot];
+
+	if(node != 0)
+	{
+		*var = &b1_ex_var_nodes[node - 1].var;
+		return B1_RES_EIDINUSE;
 	}
 
-	*var = &var_it->second;
-	return B1_RES_EIDINUSE;
+	// keep load factor below 1/2
+	if((b1_ex_var_count + 1) * 2 > b1_ex_var_index.size())
+	{
+		b1_ex_var_rehash(b1_ex_var_index_bits + 1);
+		slot = b1_ex_var_find_slot(name_hash);
+	}
+
+	if(b1_ex_var_free_nodes.empty())
+	{
+		b1_ex_var_nodes.emplace_back();
+		node = (uint32_t)b1_ex_var_nodes.size();
+	}
+	else
+	{
+		node = b1_ex_var_free_nodes.back() + 1;
+		b1_ex_var_free_nodes.pop_back();
+	}
+
+	b1_ex_var_node &n = b1_ex_var_nodes[node - 1];
+	n.var = B1_NAMED_VAR();
+	n.name_hash = name_hash;
+	n.index = node - 1;
+	n.used = true;
+
+	b1_ex_var_index[slot] = node;
+	b1_ex_var_count++;
+
+	*var = &n.var;
+	return B1_RES_OK;
 }
 
 // frees memory occupied by B1_NAMED_VAR structure
 extern "C" B1_T_ERROR b1_ex_var_free(B1_T_IDHASH name_hash)
 {
-	auto var_it = b1_ex_vars.find(name_hash);
+	uint32_t slot, next, home, mask, node;
+
+	if(b1_ex_var_index.empty())
+	{
+		return B1_RES_OK;
+	}
+
+	slot = b1_ex_var_find_slot(name_hash);
+	node = b1_ex_var_index[slot];
 
-	if(var_it != b1_ex_vars.end())
+	if(node == 0)
 	{
-		b1_ex_vars.erase(var_it);
+		return B1_RES_OK;
+	}
+
+	b1_ex_var_nodes[node - 1].used = false;
+	b1_ex_var_free_nodes.push_back(node - 1);
+	b1_ex_var_count--;
+
+	// backward shift deletion: move the following entries of the probe sequence to fill the gap
+	mask = (uint32_t)b1_ex_var_index.size() - 1;
+
+	for(next = (slot + 1) & mask; b1_ex_var_index[next] != 0; next = (next + 1) & mask)
+	{
+		home = b1_ex_var_home_slot(b1_ex_var_nodes[b1_ex_var_index[next] - 1].name_hash);
+
+		// the entry can be moved if its home slot is not in the cyclic range (slot, next]
+		if(((next - home) & mask) >= ((next - slot) & mask))
+		{
+			b1_ex_var_index[slot] = b1_ex_var_index[next];
+			slot = next;
+		}
 	}
 
+	b1_ex_var_index[slot] = 0;
+
 	return B1_RES_OK;
 }
 
 #ifdef B1_FEATURE_INIT_FREE_MEMORY
 extern "C" B1_T_ERROR b1_ex_var_enum(B1_NAMED_VAR **var)
 {
-	auto var_it = b1_ex_vars.begin();
+	size_t i;
 
-	if(*var != NULL)
+	// walk the node pool skipping freed nodes
+	i = (*var == NULL) ? 0 : (size_t)((b1_ex_var_node *)*var)->index + 1;
+
+	for(; i < b1_ex_var_nodes.size(); i++)
 	{
-		var_it = b1_ex_vars.find((*var)->id.name_hash);
-		if(var_it != b1_ex_vars.end())
+		if(b1_ex_var_nodes[i].used)
 		{
-			var_it++;
+			*var = &b1_ex_var_nodes[i].var;
+			return B1_RES_OK;
 		}
 	}
 
-	if(var_it == b1_ex_vars.end())
-	{
-		*var = NULL;
-	}
-	else
-	{
-		*var = &var_it->second;
-	}
+	*var = NULL;
 
 	return B1_RES_OK;
 }
@@ -0,0 +1,14 @@
+/*
+ BASIC1 interpreter
+ Copyright (c) 2024 Nikolay Pletnev
+ MIT license
+
+ b1extra.h: embedder-specific declarations included by b1ex.h (nothing is
+ needed for tests)
+*/
+
+
+#ifndef _B1_EXTRA_
+#define _B1_EXTRA_
+
+#endif
@@ -0,0 +1,63 @@
+/*
+ BASIC1 interpreter
+ Copyright (c) 2024 Nikolay Pletnev
+ MIT license
+
+ b1test.c: runs BASIC program from file (the first command line argument),
+ prints interpreter error code and line number on failure. Output of the
+ program is compared with the expected one by tests/Makefile
+*/
+
+
+#include <stdio.h>
+#include <locale.h>
+
+#include "b1int.h"
+#include "b1err.h"
+
+
+extern B1_T_ERROR b1_ex_prg_set_prog_file(const char *prog_file);
+
+
+int main(int argc, char **argv)
+{
+	B1_T_ERROR err;
+
+	if(argc != 2)
+	{
+		printf("usage: %s <program file>\n", argv[0]);
+		return 1;
+	}
+
+	setlocale(LC_ALL, "");
+
+	err = b1_ex_prg_set_prog_file(argv[1]);
+	if(err == B1_RES_OK)
+	{
+		err = b1_int_reset();
+	}
+
+	if(err == B1_RES_OK)
+	{
+		err = b1_int_prerun();
+		if(err != B1_RES_OK)
+		{
+			printf("\nprerun error %d at line %d\n", (int)err, (int)b1_curr_prog_line_cnt);
+			return 1;
+		}
+
+		err = b1_int_run();
+		if(err != B1_RES_OK && err != B1_RES_END)
+		{
+			printf("\nrun error %d at line %d\n", (int)err, (int)b1_curr_prog_line_cnt);
+		}
+
+		b1_int_reset();
+
+		return 0;
+	}
+
+	printf("\nerror %d\n", (int)err);
+
+	return 1;
+}
@@ -0,0 +1,146 @@
+/*
+ BASIC1 interpreter
+ Copyright (c) 2024 Nikolay Pletnev
+ MIT license
+
+ bench_fp.c: SINGLE and DOUBLE to string conversion throughput benchmark.
+ The file is built twice: with B1_FEATURE_FP_SHORTEST_DIGITS feature
+ (bench_fp) and without it (bench_fp_sprintf, sprintf based conversion),
+ values are converted with PRINT statement default field width
+*/
+
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+
+#include "b1types.h"
+#include "b1err.h"
+#include "b1int.h"
+
+
+#define BENCH_VALUE_NUM 4096
+#define BENCH_ITER_NUM 500
+#define BENCH_BUF_LEN 64
+
+
+static float svalues[BENCH_VALUE_NUM];
+static double dvalues[BENCH_VALUE_NUM];
+static uint64_t rnd_state = 1;
+
+
+static uint64_t rnd_next()
+{
+	// xorshift64
+	rnd_state ^= rnd_state << 13;
+	rnd_state ^= rnd_state >> 7;
+	rnd_state ^= rnd_state << 17;
+	return rnd_state;
+}
+
+// kind 0: random values (all SINGLE exponents, DOUBLE binary exponents from -100 to 66 as sprintf based conversion
+// cannot write larger values), kind 1: amounts with two fractional digits
+static void fill(int kind)
+{
+	int i;
+	uint32_t sbits;
+
+	for(i = 0; i < BENCH_VALUE_NUM; i++)
+	{
+		if(kind == 0)
+		{
+			do
+			{
+				sbits = (uint32_t)rnd_next();
+				memcpy(svalues + i, &sbits, sizeof(sbits));
+			}
+			while(!(svalues[i] == svalues[i]) || svalues[i] - svalues[i] != 0.0f);
+
+			dvalues[i] = ldexp((double)(rnd_next() >> 11) / 9007199254740992.0, (int)(rnd_next() % 167) - 100);
+			if(rnd_next() & 1)
+			{
+				dvalues[i] = -dvalues[i];
+			}
+		}
+		else
+		{
+			dvalues[i] = (double)(int32_t)(rnd_next() % 2000000) / 100.0 - 10000.0;
+			svalues[i] = (float)dvalues[i];
+		}
+	}
+}
+
+static double run_single()
+{
+	B1_T_CHAR sbuf[BENCH_BUF_LEN];
+	clock_t t;
+	int i, j;
+
+	t = clock();
+	for(j = 0; j < BENCH_ITER_NUM; j++)
+	{
+		for(i = 0; i < BENCH_VALUE_NUM; i++)
+		{
+			if(b1_t_singletostr(svalues[i], sbuf, BENCH_BUF_LEN, B1_DEF_PRINT_ZONE_WIDTH - 2) != B1_RES_OK)
+			{
+				return -1.0;
+			}
+		}
+	}
+
+	return (double)(clock() - t) / CLOCKS_PER_SEC;
+}
+
+static double run_double()
+{
+	B1_T_CHAR sbuf[BENCH_BUF_LEN];
+	clock_t t;
+	int i, j;
+
+	t = clock();
+	for(j = 0; j < BENCH_ITER_NUM; j++)
+	{
+		for(i = 0; i < BENCH_VALUE_NUM; i++)
+		{
+			if(b1_t_doubletostr(dvalues[i], sbuf, BENCH_BUF_LEN, B1_DEF_PRINT_ZONE_WIDTH - 2) != B1_RES_OK)
+			{
+				return -1.0;
+			}
+		}
+	}
+
+	return (double)(clock() - t) / CLOCKS_PER_SEC;
+}
+
+int main()
+{
+	int kind;
+	double ts, td;
+
+#ifdef B1_FEATURE_FP_SHORTEST_DIGITS
+	printf("shortest digits conversion, ns/value\n");
+#else
+	printf("sprintf based conversion, ns/value\n");
+#endif
+	printf("%-8s %10s %10s\n", "values", "SINGLE", "DOUBLE");
+
+	for(kind = 0; kind < 2; kind++)
+	{
+		fill(kind);
+
+		ts = run_single();
+		td = run_double();
+		if(ts < 0.0 || td < 0.0)
+		{
+			printf("conversion error\n");
+			return 1;
+		}
+
+		printf("%-8s %10.1f %10.1f\n", kind == 0 ? "random" : "amounts",
+			ts * 1e9 / ((double)BENCH_VALUE_NUM * BENCH_ITER_NUM), td * 1e9 / ((double)BENCH_VALUE_NUM * BENCH_ITER_NUM));
+	}
+
+	return 0;
+}
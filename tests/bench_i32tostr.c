@@ -0,0 +1,107 @@
+/*
+ BASIC1 interpreter
+ Copyright (c) 2024 Nikolay Pletnev
+ MIT license
+
+ bench_i32tostr.c: b1_t_i32tostr function benchmark, sprintf function
+ (used by the function in builds with fractional types before) is timed
+ for comparison
+*/
+
+
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "b1types.h"
+#include "b1err.h"
+
+
+#define BENCH_VALUE_NUM 4096
+#define BENCH_ITER_NUM 2000
+
+
+static int32_t values[BENCH_VALUE_NUM];
+static uint32_t rnd_state = 1;
+
+
+static uint32_t rnd_next()
+{
+	// xorshift32
+	rnd_state ^= rnd_state << 13;
+	rnd_state ^= rnd_state >> 17;
+	rnd_state ^= rnd_state << 5;
+	return rnd_state;
+}
+
+// kind 0: small values (loop counters, array subscripts), kind 1: values of random magnitude,
+// kind 2: random 32-bit values (mostly 10 digits long)
+static void fill(int kind)
+{
+	int i;
+	uint32_t m;
+
+	for(i = 0; i < BENCH_VALUE_NUM; i++)
+	{
+		if(kind == 0)
+		{
+			values[i] = (int32_t)(rnd_next() % 1000);
+		}
+		else
+		if(kind == 1)
+		{
+			m = rnd_next() % 32;
+			values[i] = (int32_t)(rnd_next() >> m);
+		}
+		else
+		{
+			values[i] = (int32_t)rnd_next();
+		}
+	}
+}
+
+int main()
+{
+	B1_T_CHAR sbuf[16];
+	char buf[16];
+	int kind, i, j;
+	clock_t t;
+	double t_b1, t_sprintf;
+	unsigned long sum;
+
+	sum = 0;
+
+	printf("%-8s %14s %14s\n", "values", "i32tostr ns", "sprintf ns");
+
+	for(kind = 0; kind < 3; kind++)
+	{
+		fill(kind);
+
+		t = clock();
+		for(j = 0; j < BENCH_ITER_NUM; j++)
+		{
+			for(i = 0; i < BENCH_VALUE_NUM; i++)
+			{
+				b1_t_i32tostr(values[i], sbuf, 16);
+				sum += *sbuf;
+			}
+		}
+		t_b1 = (double)(clock() - t) / CLOCKS_PER_SEC;
+
+		t = clock();
+		for(j = 0; j < BENCH_ITER_NUM; j++)
+		{
+			for(i = 0; i < BENCH_VALUE_NUM; i++)
+			{
+				sum += (unsigned long)sprintf(buf, "%ld", (long)values[i]);
+			}
+		}
+		t_sprintf = (double)(clock() - t) / CLOCKS_PER_SEC;
+
+		printf("%-8s %14.1f %14.1f\n", kind == 0 ? "small" : kind == 1 ? "mixed" : "random",
+			t_b1 * 1e9 / ((double)BENCH_VALUE_NUM * BENCH_ITER_NUM), t_sprintf * 1e9 / ((double)BENCH_VALUE_NUM * BENCH_ITER_NUM));
+	}
+
+	// the sum makes the conversions results used
+	return sum == 0;
+}
@@ -0,0 +1,136 @@
+/*
+ BASIC1 interpreter
+ Copyright (c) 2024 Nikolay Pletnev
+ MIT license
+
+ bench_instr.c: INSTR function microbenchmark. For every haystack and needle
+ size pair (haystacks up to B1_MAX_STRING_LEN characters long) a program
+ calling INSTR in a loop is run, the same loop with LEN function call instead
+ of INSTR is run too and its time is subtracted (interpreter overhead).
+ The needle is placed at the end of the haystack. Two haystack kinds are
+ used: "text" (random letters) and "same" (the needle is "a...ab" and the
+ haystack is "a...a" so every position passes the first character check)
+*/
+
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "b1int.h"
+#include "b1err.h"
+
+
+#define BENCH_PROG_FILE "bench_instr.tmp"
+#define BENCH_ITER_NUM 20000
+
+
+extern B1_T_ERROR b1_ex_prg_set_prog_file(const char *prog_file);
+
+
+static const int hay_lens[] = { 16, 32, 64, B1_MAX_STRING_LEN };
+static const int needle_lens[] = { 1, 2, 4, 8, 16 };
+
+static unsigned rnd_state = 1;
+
+
+static char rnd_letter()
+{
+	rnd_state = rnd_state * 1103515245u + 12345u;
+	return (char)('a' + (rnd_state >> 16) % 26);
+}
+
+// runs the program calling fn function in a loop, returns execution time in seconds (negative value on error)
+static double run(const char *hay, const char *needle, const char *fn)
+{
+	FILE *fp;
+	clock_t t;
+	B1_T_ERROR err;
+
+	fp = fopen(BENCH_PROG_FILE, "wt");
+	if(fp == NULL)
+	{
+		return -1.0;
+	}
+	fprintf(fp, "10 H$ = \"%s\"\n20 N$ = \"%s\"\n30 FOR I = 1 TO %d\n40 P = %s\n50 NEXT I\n60 END\n", hay, needle, BENCH_ITER_NUM, fn);
+	fclose(fp);
+
+	err = b1_ex_prg_set_prog_file(BENCH_PROG_FILE);
+	if(err == B1_RES_OK)
+	{
+		err = b1_int_reset();
+	}
+	if(err == B1_RES_OK)
+	{
+		err = b1_int_prerun();
+	}
+
+	t = clock();
+	if(err == B1_RES_OK)
+	{
+		err = b1_int_run();
+	}
+	t = clock() - t;
+
+	b1_int_reset();
+
+	if(err != B1_RES_OK && err != B1_RES_END)
+	{
+		printf("error %d\n", (int)err);
+		return -1.0;
+	}
+
+	return (double)t / CLOCKS_PER_SEC;
+}
+
+int main()
+{
+	char hay[B1_MAX_STRING_LEN + 1], needle[B1_MAX_STRING_LEN + 1];
+	int h, n, kind, hlen, nlen, i;
+	double t_instr, t_len;
+
+	printf("%-5s %8s %8s %12s %12s\n", "kind", "haystack", "needle", "ns/call", "net ns/call");
+
+	for(kind = 0; kind < 2; kind++)
+	{
+		for(h = 0; h < (int)(sizeof(hay_lens) / sizeof(hay_lens[0])); h++)
+		{
+			for(n = 0; n < (int)(sizeof(needle_lens) / sizeof(needle_lens[0])); n++)
+			{
+				hlen = hay_lens[h];
+				nlen = needle_lens[n];
+				if(nlen > hlen)
+				{
+					continue;
+				}
+
+				for(i = 0; i < nlen; i++)
+				{
+					needle[i] = kind == 0 ? rnd_letter() : i == nlen - 1 ? 'b' : 'a';
+				}
+				needle[nlen] = 0;
+
+				for(i = 0; i < hlen - nlen; i++)
+				{
+					hay[i] = kind == 0 ? rnd_letter() : 'a';
+				}
+				strcpy(hay + i, needle);
+
+				t_instr = run(hay, needle, "INSTR(, H$, N$)");
+				t_len = run(hay, needle, "LEN(N$)");
+				if(t_instr < 0.0 || t_len < 0.0)
+				{
+					remove(BENCH_PROG_FILE);
+					return 1;
+				}
+
+				printf("%-5s %8d %8d %12.1f %12.1f\n", kind == 0 ? "text" : "same", hlen, nlen,
+					t_instr * 1e9 / BENCH_ITER_NUM, (t_instr - t_len) * 1e9 / BENCH_ITER_NUM);
+			}
+		}
+	}
+
+	remove(BENCH_PROG_FILE);
+
+	return 0;
+}
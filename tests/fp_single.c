@@ -0,0 +1,310 @@
+/*
+ BASIC1 interpreter
+ Copyright (c) 2024 Nikolay Pletnev
+ MIT license
+
+ fp_single.c: checks SINGLE to string conversion made with shortest digits
+ generator (B1_FEATURE_FP_SHORTEST_DIGITS feature) for positive finite
+ SINGLE values taken with the specified step (the first command line
+ argument, step 1 checks all 2^31 values and takes hours, the second and
+ the third arguments limit the range of value bit patterns so that the
+ check can be split between several processes):
+ - a value written with a wide output field converts back to the same value
+   with strtof (and has no more significant digits than the shortest %e
+   form, checked for every 64th value),
+ - a value written with PRINT statement field widths either converts back
+   to the same value or has its digits equal to the exact value rounded
+   half up, the output is not longer than the field,
+ - negative values are written with minus sign followed by the positive
+   value representation.
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "b1types.h"
+#include "b1err.h"
+
+
+// wide enough for all SINGLE values to be written in fixed-point form with all shortest digits
+#define FP_WIDE_LEN 60
+#define FP_BUF_LEN (FP_WIDE_LEN + 4)
+#define FP_DEF_STEP 9973
+
+
+// PRINT statement field widths (print zone width minus two characters)
+static const uint8_t print_lens[] = { 8, 10 };
+
+static unsigned long err_num;
+
+
+static float bits2float(uint32_t bits)
+{
+	float value;
+
+	memcpy(&value, &bits, sizeof(value));
+
+	return value;
+}
+
+// converts the value to C string, returns 0 on error
+static int tostr(float value, uint8_t max_len, char *str)
+{
+	B1_T_CHAR sbuf[FP_BUF_LEN];
+	B1_T_INDEX i;
+
+	if(b1_t_singletostr(value, sbuf, FP_BUF_LEN, max_len) != B1_RES_OK)
+	{
+		return 0;
+	}
+
+	for(i = 0; i < *sbuf; i++)
+	{
+		str[i] = (char)sbuf[i + 1];
+	}
+	str[i] = 0;
+
+	return 1;
+}
+
+// extracts significand digits without leading and trailing zeroes and the decimal exponent of the first digit
+// from fixed-point or exponential form, returns the number of digits
+static int get_digits(const char *str, char *digits, int *exp)
+{
+	int n, pos, point, e;
+
+	n = 0;
+	pos = 0;
+	point = -1;
+	e = 0;
+
+	for(; *str != 0 && *str != 'E' && *str != 'e'; str++)
+	{
+		if(*str == '.')
+		{
+			point = pos;
+			continue;
+		}
+
+		if(*str < '0' || *str > '9')
+		{
+			continue;
+		}
+
+		if(n == 0 && *str == '0')
+		{
+			e--;
+		}
+		else
+		{
+			digits[n++] = *str;
+		}
+
+		pos++;
+	}
+
+	if(point < 0)
+	{
+		point = pos;
+	}
+
+	if(*str != 0)
+	{
+		e += atoi(str + 1);
+	}
+
+	while(n > 1 && digits[n - 1] == '0')
+	{
+		n--;
+	}
+	digits[n] = 0;
+
+	*exp = e + point - 1;
+
+	return n;
+}
+
+// rounds exact value decimal digits half up to cnt digits
+static void round_half_up(float value, int cnt, char *digits, int *exp)
+{
+	char str[200];
+	int n, i;
+
+	// %e rounds half to even so the result is the same unless the value is exactly in the middle
+	sprintf(str, "%.*e", cnt - 1, (double)value);
+	if(strtod(str, NULL) != (double)value)
+	{
+		// 5 after the last digit of the exact value (it has at most 112 significand digits) means the middle
+		sprintf(str, "%.*e", cnt, (double)value);
+		if(str[cnt + 1] != '5')
+		{
+			sprintf(str, "%.*e", cnt - 1, (double)value);
+			get_digits(str, digits, exp);
+			return;
+		}
+	}
+
+	// %e form of float value converted to double has all its exact digits
+	sprintf(str, "%.150e", (double)value);
+	n = get_digits(str, digits, exp);
+
+	if(n > cnt)
+	{
+		i = cnt;
+		if(digits[i] >= '5')
+		{
+			for(i--; i >= 0 && digits[i] == '9'; i--)
+			{
+				digits[i] = '0';
+			}
+
+			if(i < 0)
+			{
+				memmove(digits + 1, digits, cnt);
+				digits[0] = '1';
+				(*exp)++;
+			}
+			else
+			{
+				digits[i]++;
+			}
+		}
+
+		digits[cnt] = 0;
+		while(cnt > 1 && digits[cnt - 1] == '0')
+		{
+			digits[--cnt] = 0;
+		}
+	}
+}
+
+// returns the number of significand digits of the shortest %e form converting back to the value
+static int shortest_len(float value)
+{
+	char str[32];
+	int p;
+
+	for(p = 0; p < 9; p++)
+	{
+		sprintf(str, "%.*e", p, (double)value);
+		if(strtof(str, NULL) == value)
+		{
+			break;
+		}
+	}
+
+	return p + 1;
+}
+
+static void fail(uint32_t bits, uint8_t max_len, const char *str, const char *msg)
+{
+	err_num++;
+
+	if(err_num <= 20)
+	{
+		printf("0x%08lX (%.9g), field %d: \"%s\": %s\n", (unsigned long)bits, (double)bits2float(bits), (int)max_len,
+			str, msg);
+	}
+}
+
+static void check(uint32_t bits, int all)
+{
+	float value;
+	char str[FP_BUF_LEN], neg[FP_BUF_LEN], digits[200], ref[200];
+	int i, n, e, ref_e;
+
+	value = bits2float(bits);
+
+	if(!tostr(value, FP_WIDE_LEN, str))
+	{
+		fail(bits, FP_WIDE_LEN, "", "conversion error");
+		return;
+	}
+
+	if(strtof(str, NULL) != value)
+	{
+		fail(bits, FP_WIDE_LEN, str, "wrong value");
+	}
+
+	// integer part digits are written exactly, not padded with zeroes
+	if(all && get_digits(str, digits, &e) > shortest_len(value) && strchr(str, '.') != NULL)
+	{
+		fail(bits, FP_WIDE_LEN, str, "not the shortest representation");
+	}
+
+	for(i = 0; i < (int)(sizeof(print_lens) / sizeof(print_lens[0])); i++)
+	{
+		if(!tostr(value, print_lens[i], str))
+		{
+			fail(bits, print_lens[i], "", "conversion error");
+			continue;
+		}
+
+		if((int)strlen(str) > print_lens[i])
+		{
+			fail(bits, print_lens[i], str, "too long");
+		}
+
+		if(strtof(str, NULL) != value)
+		{
+			n = get_digits(str, digits, &e);
+			round_half_up(value, n, ref, &ref_e);
+			if(e != ref_e || strcmp(digits, ref) != 0)
+			{
+				fail(bits, print_lens[i], str, "wrong rounding");
+			}
+		}
+
+		if(all)
+		{
+			if(!tostr(-value, print_lens[i], neg) || neg[0] != '-' || strcmp(neg + 1, str) != 0)
+			{
+				fail(bits, print_lens[i], neg, "wrong negative value representation");
+			}
+		}
+	}
+}
+
+int main(int argc, char **argv)
+{
+	uint32_t bits, step, first, last;
+	unsigned long num;
+
+	step = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 0) : FP_DEF_STEP;
+	first = argc > 2 ? (uint32_t)strtoul(argv[2], NULL, 0) : 1;
+	// the largest finite value
+	last = argc > 3 ? (uint32_t)strtoul(argv[3], NULL, 0) : 0x7F7FFFFFUL;
+	if(step == 0 || first == 0 || first > last || last > 0x7F7FFFFFUL)
+	{
+		printf("usage: %s [<step> [<first value bits> <last value bits>]]\n", argv[0]);
+		return 1;
+	}
+
+	num = 0;
+
+	for(bits = first; bits <= last && bits >= first; bits += step)
+	{
+		check(bits, num % 64 == 0);
+		num++;
+	}
+
+	// the largest value and powers of two around denormalized values range
+	check(0x7F7FFFFFUL, 1);
+	check(0x00800000UL, 1);
+	check(0x00400000UL, 1);
+	check(0x00000001UL, 1);
+	num += 4;
+
+	if(err_num != 0)
+	{
+		printf("fp_single: %lu values, %lu errors\n", num, err_num);
+		return 1;
+	}
+
+	printf("fp_single: %lu values: OK\n", num);
+
+	return 0;
+}
@@ -0,0 +1,128 @@
+/*
+ BASIC1 interpreter
+ Copyright (c) 2024 Nikolay Pletnev
+ MIT license
+
+ i32tostr.c: compares b1_t_i32tostr function output with the one of
+ sprintf function for int32_t values taken with the specified step (the
+ first command line argument, step 1 checks all 2^32 values) and for values
+ around powers of ten and the range ends. Every conversion is made into a
+ buffer of exactly required size (the function must fail with a buffer one
+ character shorter) and must not write beyond the string end.
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "b1types.h"
+#include "b1err.h"
+
+
+#define I32_DEF_STEP 997
+#define I32_GUARD ((B1_T_CHAR)0x5A)
+
+
+static unsigned long err_num;
+
+
+static void check(int32_t value)
+{
+	B1_T_CHAR sbuf[16];
+	char ref[16];
+	B1_T_INDEX len, i;
+
+	len = (B1_T_INDEX)sprintf(ref, "%ld", (long)value);
+
+	for(i = 0; i < 16; i++)
+	{
+		sbuf[i] = I32_GUARD;
+	}
+
+	if(b1_t_i32tostr(value, sbuf, len + 1) != B1_RES_OK)
+	{
+		err_num++;
+		printf("%s: conversion error\n", ref);
+		return;
+	}
+
+	if(*sbuf != len || sbuf[len + 1] != I32_GUARD)
+	{
+		err_num++;
+		printf("%s: wrong length\n", ref);
+		return;
+	}
+
+	for(i = 0; i < len; i++)
+	{
+		if(sbuf[i + 1] != (B1_T_CHAR)(unsigned char)ref[i])
+		{
+			err_num++;
+			printf("%s: wrong character at position %d\n", ref, (int)i);
+			return;
+		}
+	}
+
+	if(b1_t_i32tostr(value, sbuf, len) != B1_RES_EBUFSMALL)
+	{
+		err_num++;
+		printf("%s: too small buffer is not detected\n", ref);
+	}
+}
+
+int main(int argc, char **argv)
+{
+	uint32_t step, u;
+	int64_t p, d;
+	unsigned long num;
+
+	step = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 0) : I32_DEF_STEP;
+	if(step == 0)
+	{
+		printf("usage: %s [<step>]\n", argv[0]);
+		return 1;
+	}
+
+	num = 0;
+
+	u = 0;
+	do
+	{
+		check((int32_t)u);
+		num++;
+		u += step;
+	}
+	while(u >= step);
+
+	// values around powers of ten and the range ends
+	for(p = 1; p <= INT32_MAX; p *= 10)
+	{
+		for(d = -100; d <= 100; d++)
+		{
+			if(p + d >= 0 && p + d <= INT32_MAX)
+			{
+				check((int32_t)(p + d));
+				check((int32_t)-(p + d));
+				num += 2;
+			}
+		}
+	}
+
+	for(d = 0; d < 1000; d++)
+	{
+		check((int32_t)(INT32_MAX - d));
+		check((int32_t)(INT32_MIN + d));
+		num += 2;
+	}
+
+	if(err_num != 0)
+	{
+		printf("i32tostr: %lu values, %lu errors\n", num, err_num);
+		return 1;
+	}
+
+	printf("i32tostr: %lu values: OK\n", num);
+
+	return 0;
+}
@@ -0,0 +1,245 @@
+/*
+ BASIC1 interpreter
+ Copyright (c) 2024 Nikolay Pletnev
+ MIT license
+
+ mempool_stress.c: stress test for the fixed pool memory manager
+ (ext/exmempool.c). Random allocations, frees, accesses and releases are
+ made according to the access/release protocol, some blocks are kept
+ accessed (pinned) across allocations forcing compaction. Pointers to
+ pinned blocks must stay valid and contents of all blocks must survive
+ compaction.
+*/
+
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "b1ex.h"
+#include "b1err.h"
+
+
+#define MEM_STRESS_BLOCK_NUM 64
+#define MEM_STRESS_MAX_SIZE 128
+#define MEM_STRESS_PINNED_NUM 4
+#define MEM_STRESS_ITER_NUM 200000
+
+
+typedef struct
+{
+	B1_T_MEM_BLOCK_DESC desc;
+	B1_T_MEMOFFSET size;
+	uint8_t seed;
+	// pointer returned by b1_ex_mem_access for pinned block (NULL for not accessed one)
+	uint8_t *pinned;
+	// the last known block address (to count moved blocks)
+	uint8_t *addr;
+} MEM_STRESS_BLOCK;
+
+
+static MEM_STRESS_BLOCK blocks[MEM_STRESS_BLOCK_NUM];
+static uint32_t rnd_state = 1;
+static unsigned long moved_num, nomem_num;
+
+
+static uint32_t rnd_next(uint32_t max)
+{
+	// xorshift32
+	rnd_state ^= rnd_state << 13;
+	rnd_state ^= rnd_state >> 17;
+	rnd_state ^= rnd_state << 5;
+	return rnd_state % max;
+}
+
+static void fill(uint8_t *data, B1_T_MEMOFFSET size, uint8_t seed)
+{
+	B1_T_MEMOFFSET i;
+
+	for(i = 0; i < size; i++)
+	{
+		data[i] = (uint8_t)(seed + i * 7);
+	}
+}
+
+static int check(const uint8_t *data, B1_T_MEMOFFSET size, uint8_t seed)
+{
+	B1_T_MEMOFFSET i;
+
+	for(i = 0; i < size; i++)
+	{
+		if(data[i] != (uint8_t)(seed + i * 7))
+		{
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+// reads every allocated block with access/release pair, checks block contents and pinned pointers
+static int check_all(unsigned long iter)
+{
+	int i;
+	uint8_t *data;
+	MEM_STRESS_BLOCK *b;
+
+	for(i = 0; i < MEM_STRESS_BLOCK_NUM; i++)
+	{
+		b = blocks + i;
+
+		if((*b).desc == B1_T_MEM_BLOCK_DESC_INVALID)
+		{
+			continue;
+		}
+
+		if(b1_ex_mem_access((*b).desc, 0, 0, B1_EX_MEM_READ, (void **)&data) != B1_RES_OK)
+		{
+			printf("iteration %lu: access error\n", iter);
+			return 0;
+		}
+
+		if((*b).pinned != NULL && (*b).pinned != data)
+		{
+			printf("iteration %lu: pinned block %d was moved\n", iter, i);
+			return 0;
+		}
+
+		if(!check(data, (*b).size, (*b).seed))
+		{
+			printf("iteration %lu: block %d data corrupted\n", iter, i);
+			return 0;
+		}
+
+		if(data != (*b).addr)
+		{
+			moved_num++;
+			(*b).addr = data;
+		}
+
+		b1_ex_mem_release((*b).desc);
+	}
+
+	return 1;
+}
+
+int main()
+{
+	unsigned long iter;
+	int i, pinned_num;
+	uint8_t *data;
+	B1_T_ERROR err;
+	MEM_STRESS_BLOCK *b;
+
+	b1_ex_mem_init();
+
+	for(i = 0; i < MEM_STRESS_BLOCK_NUM; i++)
+	{
+		blocks[i].desc = B1_T_MEM_BLOCK_DESC_INVALID;
+	}
+
+	pinned_num = 0;
+
+	for(iter = 0; iter < MEM_STRESS_ITER_NUM; iter++)
+	{
+		b = blocks + rnd_next(MEM_STRESS_BLOCK_NUM);
+
+		switch(rnd_next(4))
+		{
+			case 0:
+			case 1:
+				// allocate a block (or reallocate it with different size like string variables do)
+				if((*b).pinned != NULL)
+				{
+					break;
+				}
+
+				if((*b).desc != B1_T_MEM_BLOCK_DESC_INVALID)
+				{
+					b1_ex_mem_free((*b).desc);
+					(*b).desc = B1_T_MEM_BLOCK_DESC_INVALID;
+				}
+
+				(*b).size = 1 + rnd_next(MEM_STRESS_MAX_SIZE);
+				(*b).seed = (uint8_t)rnd_next(256);
+
+				err = b1_ex_mem_alloc((*b).size, &(*b).desc, (void **)&data);
+				if(err == B1_RES_ENOMEM)
+				{
+					nomem_num++;
+					(*b).desc = B1_T_MEM_BLOCK_DESC_INVALID;
+					break;
+				}
+
+				if(err != B1_RES_OK)
+				{
+					printf("iteration %lu: allocation error %d\n", iter, (int)err);
+					return 1;
+				}
+
+				fill(data, (*b).size, (*b).seed);
+				(*b).addr = data;
+				b1_ex_mem_release((*b).desc);
+				break;
+
+			case 2:
+				// free a block
+				if((*b).desc == B1_T_MEM_BLOCK_DESC_INVALID || (*b).pinned != NULL)
+				{
+					break;
+				}
+
+				b1_ex_mem_free((*b).desc);
+				(*b).desc = B1_T_MEM_BLOCK_DESC_INVALID;
+				break;
+
+			case 3:
+				// pin a block (keep the pointer across the next allocations) or release it
+				if((*b).desc == B1_T_MEM_BLOCK_DESC_INVALID)
+				{
+					break;
+				}
+
+				if((*b).pinned != NULL)
+				{
+					if(!check((*b).pinned, (*b).size, (*b).seed))
+					{
+						printf("iteration %lu: pinned block data corrupted\n", iter);
+						return 1;
+					}
+
+					b1_ex_mem_release((*b).desc);
+					(*b).pinned = NULL;
+					pinned_num--;
+				}
+				else
+				if(pinned_num < MEM_STRESS_PINNED_NUM)
+				{
+					if(b1_ex_mem_access((*b).desc, 0, 0, B1_EX_MEM_READ | B1_EX_MEM_WRITE, (void **)&(*b).pinned) != B1_RES_OK)
+					{
+						printf("iteration %lu: access error\n", iter);
+						return 1;
+					}
+
+					pinned_num++;
+				}
+				break;
+		}
+
+		if(!check_all(iter))
+		{
+			return 1;
+		}
+	}
+
+	// compaction must have happened, otherwise the test proves nothing
+	if(moved_num == 0)
+	{
+		printf("no blocks were moved, increase iterations number or decrease pool size\n");
+		return 1;
+	}
+
+	printf("mempool_stress: %lu iterations, %lu blocks moved, %lu allocations failed: OK\n", (unsigned long)MEM_STRESS_ITER_NUM, moved_num, nomem_num);
+
+	return 0;
+}
@@ -0,0 +1,49 @@
+10 REM INSTR check: compares INSTR results with the ones of straightforward search made with MID$ function
+20 REM haystacks are up to 127 characters long (B1_MAX_STRING_LEN), small alphabet makes partial matches frequent
+30 X = 1
+40 E = 0
+50 FOR T = 1 TO 3000
+60 GOSUB 1000
+70 L = X MOD 128
+80 GOSUB 2000
+90 H$ = S$
+100 GOSUB 1000
+110 K = X MOD 3
+112 IF LEN(H$) = 0 THEN K = 1
+114 IF K = 0 THEN GOSUB 3000
+120 ELSE GOSUB 4000
+130 GOSUB 1000
+140 ST = 1 + X MOD 8
+145 IF ST > LEN(H$) THEN ST = 1
+150 P = INSTR(ST, H$, N$)
+160 Q = 0
+170 FOR I = LEN(H$) - LEN(N$) + 1 TO ST STEP -1
+180 IF MID$(H$, I, LEN(N$)) = N$ THEN Q = I
+200 NEXT I
+210 IF P <> Q THEN PRINT "INSTR("; ST; ", "; H$; ", "; N$; ") ="; P; ", expected"; Q
+220 IF P <> Q THEN E = E + 1
+230 NEXT T
+240 PRINT "errors:"; E
+250 END
+1000 REM pseudo-random number generator
+1010 X = (X * 75 + 74) MOD 65537
+1020 RETURN
+2000 REM makes string of L random characters
+2010 S$ = ""
+2020 FOR J = 1 TO L
+2030 GOSUB 1000
+2040 S$ = S$ + MID$("aAbBc", 1 + X MOD 5, 1)
+2050 NEXT J
+2060 RETURN
+3000 REM takes the string to search from the haystack (so that it is found)
+3010 GOSUB 1000
+3020 I = 1 + X MOD LEN(H$)
+3030 GOSUB 1000
+3040 N$ = MID$(H$, I, 1 + X MOD (LEN(H$) - I + 1))
+3050 RETURN
+4000 REM makes random string to search
+4010 GOSUB 1000
+4020 L = 1 + X MOD 6
+4030 GOSUB 2000
+4040 N$ = S$
+4050 RETURN
@@ -0,0 +1,6 @@
+10 REM PRINT statement without arguments must print empty line in builds with file statements
+20 PRINT
+30 PRINT 1;
+40 PRINT
+50 PRINT "A"
+60 END
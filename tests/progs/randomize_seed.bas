@@ -0,0 +1,17 @@
+10 REM RANDOMIZE <num_expr> must start the same random values sequence for the same value
+20 DIM A(10)
+30 RANDOMIZE 42
+40 FOR I = 1 TO 10
+50 A(I) = RND
+60 NEXT I
+70 RANDOMIZE 7
+80 B = RND
+90 RANDOMIZE 42
+100 N = 0
+110 FOR I = 1 TO 10
+120 C = RND
+130 IF C = A(I) THEN N = N + 1
+140 NEXT I
+150 PRINT "equal values:"; N
+160 IF B = A(1) THEN PRINT "RANDOMIZE 7 repeats RANDOMIZE 42 sequence"
+170 END
@@ -0,0 +1,2 @@
+10 PRINT "AbbBaAbbAaAAbAbAb"
+20 END